@@ -0,0 +1,458 @@
+/*
+  ==============================================================================
+
+    DSPBenchmarks.cpp
+    Times the DSP primitives, the algorithms and the whole processor across
+    sample rates, block sizes and channel counts, and prints the results as
+    JSON (ns per sample frame and % of the real-time budget). State loading
+    is timed too, under "state" (see StateBenchmarks.h).
+
+    ADSREchoBenchmarks [--quick] [--filter=<name>] [--seconds=<s>]
+                       [--repeats=<n>] [--irs=<folder>] [--output=<file>]
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "StateBenchmarks.h"
+#include "DSPKernels.h"
+#include "Reverb Algorithms/CustomDelays.h"
+#include "Reverb Algorithms/Reverb/LFO.h"
+#include "Reverb Algorithms/Reverb/PsychoDamping.h"
+#include "Reverb Algorithms/Reverb/FDNFilterBank.h"
+#include "../Tests/RenderSubjects.h"   // Subject and the algorithm / processor subjects
+
+#include <iostream>
+
+namespace
+{
+//==============================================================================
+struct Benchmark
+{
+    juce::String name;
+    std::function<std::unique_ptr<Subject>()> create;
+};
+
+//==============================================================================
+// Primitives, driven the way the algorithms drive them (a sample at a time)
+
+struct DelayLineSubject : Subject
+{
+    explicit DelayLineSubject(DelayStorage s = DelayStorage::Float32) : storage(s) {}
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        const int delay = (int) (0.25 * spec.sampleRate);
+
+        line = DelayLineWithSampleAccess<float>(delay + 1);
+        line.setStorage(storage);
+        line.prepare(spec);
+        line.setDelay(delay);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                line.pushSample(ch, data[i]);
+                data[i] = line.popSample(ch);
+            }
+        }
+    }
+
+    DelayStorage storage;
+    DelayLineWithSampleAccess<float> line;
+};
+
+struct AllpassSubject : Subject
+{
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        const int delay = (int) std::round(0.012 * spec.sampleRate);
+
+        allpass.setMaximumDelayInSamples(delay + 32);
+        allpass.setDelay((float) delay);
+        allpass.setGain(0.7f);
+        allpass.prepare(spec);
+        allpass.reset();
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                allpass.pushSample(ch, data[i]);
+                data[i] = allpass.popSample(ch);
+            }
+        }
+    }
+
+    Allpass<float> allpass;
+};
+
+struct LFOSubject : Subject
+{
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        OscillatorParameters params;
+        params.waveform = generatorWaveform::sin;
+        params.frequency_Hz = 0.5;
+
+        lfo.setParameters(params);
+        lfo.prepare(spec);
+    }
+
+    // One LFO per voice, as the reverbs use it; its output goes to every channel
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const auto out = lfo.renderAudioOutput();
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, i, (float) out.normalOutput);
+        }
+    }
+
+    LFO lfo;
+};
+
+struct PsychoOnePoleSubject : Subject
+{
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        filters.resize(spec.numChannels);
+
+        for (auto& f : filters)
+            f.prepare((float) spec.sampleRate, 0.5f);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+            auto& f = filters[(size_t) ch];
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = f.process(data[i]);
+        }
+    }
+
+    std::vector<PsychoOnePole> filters;
+};
+
+// HybridPlate's loop filters for its four FDN lines, fed from the buffer's
+// first channel: the scalar per-line chain it used to run, and the bank
+struct PlateLoopFiltersSubject : Subject
+{
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        auto shelf = juce::dsp::IIR::Coefficients<float>::makeHighShelf(spec.sampleRate, 3000.0f, 0.707f, 0.5f);
+
+        for (int i = 0; i < numLines; ++i)
+        {
+            lowpass[i].prepare({ spec.sampleRate, spec.maximumBlockSize, 1 });
+            lowpass[i].setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
+            lowpass[i].setCutoffFrequency(8000.0f);
+            psycho[i].prepare((float) spec.sampleRate, 8000.0f);
+            shelves[i].coefficients = shelf;
+        }
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        auto* data = buffer.getWritePointer(0);
+
+        for (int n = 0; n < buffer.getNumSamples(); ++n)
+        {
+            float sum = 0.0f;
+
+            for (int i = 0; i < numLines; ++i)
+                sum += shelves[i].processSample(psycho[i].process(lowpass[i].processSample(0, data[n])));
+
+            data[n] = sum * 0.25f;
+        }
+    }
+
+    static constexpr int numLines = 4;
+    juce::dsp::FirstOrderTPTFilter<float> lowpass[numLines];
+    PsychoOnePole psycho[numLines];
+    juce::dsp::IIR::Filter<float> shelves[numLines];
+};
+
+struct FDNFilterBankSubject : Subject
+{
+    using Bank = FDNFilterBank<4>;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        bank.prepare(spec.sampleRate);
+        bank.setLowpassCutoff(8000.0f);
+        bank.setPsychoDamping(8000.0f);
+        bank.setBiquad(*juce::dsp::IIR::Coefficients<float>::makeHighShelf(spec.sampleRate, 3000.0f, 0.707f, 0.5f));
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        auto* data = buffer.getWritePointer(0);
+
+        for (int n = 0; n < buffer.getNumSamples(); ++n)
+        {
+            for (int i = 0; i < 4; ++i)
+                lines[i] = data[n];
+
+            bank.process(lines);
+            data[n] = (lines[0] + lines[1] + lines[2] + lines[3]) * 0.25f;
+        }
+    }
+
+    Bank bank;
+    alignas(Bank::Register::SIMDRegisterSize) float lines[Bank::paddedLines] = {};
+};
+
+// One slot and its chain metered per block, spectrum on: what an open
+// editor adds to each chain (compare with the algorithms below)
+struct LevelMetersSubject : Subject
+{
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        meters.prepare(spec.sampleRate);
+        meters.addViewer();
+        meters.addSpectrumViewer();
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        const int numChannels = buffer.getNumChannels();
+        const int numSamples = buffer.getNumSamples();
+
+        meters.beginCallback(numSamples);
+        meters.measureSlot(0, 0, buffer, numChannels, numSamples);
+        meters.measureChain(0, buffer, numChannels, numSamples);
+        meters.endCallback();
+    }
+
+    ADSREchoAudioProcessor::Meters meters;
+};
+
+//==============================================================================
+struct Options
+{
+    juce::Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+    juce::Array<int> blockSizes { 16, 64, 256, 1024, 2048 };
+    juce::Array<int> channelCounts { 1, 2 };
+
+    juce::String filter;
+    double seconds = 0.5;   // audio per timed run
+    int repeats = 5;
+};
+
+double ticksToSeconds(juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks);
+}
+
+// Times one benchmark at one configuration: one warm-up run, then `repeats`
+// timed runs over fresh noise. Only process() is inside the timed region.
+juce::var run(const Benchmark& benchmark, double sampleRate, int blockSize, int numChannels,
+              const Options& options)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    auto subject = benchmark.create();
+    subject->prepare({ sampleRate, (juce::uint32) blockSize, (juce::uint32) numChannels });
+    subject->startLoads();
+
+    juce::AudioBuffer<float> block(numChannels, blockSize);
+
+    // Let background loads finish; the subject sees silence meanwhile
+    while (subject->isBusy())
+    {
+        block.clear();
+        subject->process(block);
+        juce::Thread::sleep(1);
+    }
+
+    const int numBlocks = juce::jmax(1, (int) (options.seconds * sampleRate) / blockSize);
+    const int numFrames = numBlocks * blockSize;
+
+    juce::AudioBuffer<float> signal(numChannels, numFrames);
+    juce::Random random(0x5eed);
+    std::vector<double> nsPerFrame;
+
+    for (int r = -1; r < options.repeats; ++r)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* data = signal.getWritePointer(ch);
+
+            for (int i = 0; i < numFrames; ++i)
+                data[i] = random.nextFloat() * 0.5f - 0.25f;
+        }
+
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            block.setDataToReferTo(signal.getArrayOfWritePointers(), numChannels, b * blockSize, blockSize);
+            subject->process(block);
+        }
+
+        const auto elapsed = ticksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+        if (r >= 0)
+            nsPerFrame.push_back(elapsed * 1.0e9 / numFrames);
+    }
+
+    std::sort(nsPerFrame.begin(), nsPerFrame.end());
+
+    const double median = nsPerFrame[nsPerFrame.size() / 2];
+    const double budgetNs = 1.0e9 / sampleRate;
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("name", benchmark.name);
+    result->setProperty("sampleRate", sampleRate);
+    result->setProperty("blockSize", blockSize);
+    result->setProperty("channels", numChannels);
+    result->setProperty("nsPerSample", median);
+    result->setProperty("nsPerSampleMin", nsPerFrame.front());
+    result->setProperty("budgetPercent", 100.0 * median / budgetNs);
+    return juce::var(result);
+}
+
+juce::Array<Benchmark> createBenchmarks(const juce::File& irFolder)
+{
+    juce::Array<Benchmark> benchmarks;
+
+    auto add = [&benchmarks](const juce::String& name, std::function<std::unique_ptr<Subject>()> create)
+    {
+        benchmarks.add({ name, std::move(create) });
+    };
+
+    add("DelayLineWithSampleAccess", [] { return std::make_unique<DelayLineSubject>(); });
+    add("DelayLineWithSampleAccess/FP16", [] { return std::make_unique<DelayLineSubject>(DelayStorage::Float16); });
+    add("DelayLineWithSampleAccess/BF16", [] { return std::make_unique<DelayLineSubject>(DelayStorage::BFloat16); });
+    add("Allpass",                   [] { return std::make_unique<AllpassSubject>(); });
+    add("LFO",                       [] { return std::make_unique<LFOSubject>(); });
+    add("PsychoOnePole",             [] { return std::make_unique<PsychoOnePoleSubject>(); });
+    add("PlateLoopFilters/Scalar",   [] { return std::make_unique<PlateLoopFiltersSubject>(); });
+    add("PlateLoopFilters/Bank",     [] { return std::make_unique<FDNFilterBankSubject>(); });
+    add("LevelMeters",               [] { return std::make_unique<LevelMetersSubject>(); });
+    add("DatorroHall",               [] { return std::make_unique<ReverbSubject<DatorroHall>>(); });
+    add("DatorroHall/FP16",          [] { return std::make_unique<ReverbSubject<DatorroHall>>(DelayStorage::Float16); });
+    add("HybridPlate",               [] { return std::make_unique<ReverbSubject<HybridPlate>>(); });
+    add("HybridPlate/FP16",          [] { return std::make_unique<ReverbSubject<HybridPlate>>(DelayStorage::Float16); });
+    add("BasicDelay",                [] { return std::make_unique<BasicDelaySubject>(BasicDelay::DelayMode::Normal); });
+    add("BasicDelay/FP16",           [] { return std::make_unique<BasicDelaySubject>(BasicDelay::DelayMode::Normal, DelayStorage::Float16); });
+    add("BasicDelay/Tape",           [] { return std::make_unique<BasicDelaySubject>(BasicDelay::DelayMode::Tape); });
+
+    auto irFiles = irFolder.findChildFiles(juce::File::findFiles, false, "*.wav");
+    irFiles.sort();
+
+    for (const auto& file : irFiles)
+        add("Convolution/" + file.getFileNameWithoutExtension(),
+            [file] { return std::make_unique<ConvolutionSubject>(file); });
+
+    // The rack's custom IR is always the bundled one, whatever --irs says
+    const auto rackIR = juce::File(ADSRECHO_IR_DIR).getChildFile("Block Inside.wav");
+    add("ADSREchoAudioProcessor", [rackIR] { return std::make_unique<RackSubject>(rackIR); });
+
+    return benchmarks;
+}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the processor's APVTS needs a message manager
+    juce::ArgumentList args(argc, argv);
+
+    Options options;
+
+    if (args.containsOption("--quick"))
+    {
+        options.sampleRates = { 48000.0 };
+        options.blockSizes = { 256 };
+        options.channelCounts = { 2 };
+    }
+
+    options.filter = args.getValueForOption("--filter");
+
+    if (args.containsOption("--seconds"))
+        options.seconds = juce::jmax(0.01, args.getValueForOption("--seconds").getDoubleValue());
+
+    if (args.containsOption("--repeats"))
+        options.repeats = juce::jmax(1, args.getValueForOption("--repeats").getIntValue());
+
+    auto irFolder = juce::File(ADSRECHO_IR_DIR);
+
+    if (args.containsOption("--irs"))
+        irFolder = args.getExistingFolderForOption("--irs");
+
+    juce::Array<juce::var> results;
+
+    for (const auto& benchmark : createBenchmarks(irFolder))
+    {
+        if (options.filter.isNotEmpty() && !benchmark.name.containsIgnoreCase(options.filter))
+            continue;
+
+        for (auto sampleRate : options.sampleRates)
+        {
+            for (auto blockSize : options.blockSizes)
+            {
+                for (auto numChannels : options.channelCounts)
+                {
+                    std::cerr << benchmark.name << " @ " << sampleRate << " Hz, "
+                              << blockSize << " samples, " << numChannels << " ch" << std::endl;
+
+                    results.add(run(benchmark, sampleRate, blockSize, numChannels, options));
+                }
+            }
+        }
+    }
+
+    juce::var stateResults;
+
+    if (options.filter.isEmpty() || juce::String("setStateInformation").containsIgnoreCase(options.filter))
+    {
+        std::cerr << "setStateInformation" << std::endl;
+        stateResults = StateBenchmarks::run(options.repeats);
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("kernels", DSPKernels::describe());
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("cores", juce::SystemStats::getNumPhysicalCpus());
+    report->setProperty("secondsPerRun", options.seconds);
+    report->setProperty("repeats", options.repeats);
+    report->setProperty("results", results);
+    report->setProperty("state", stateResults);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (args.containsOption("--output"))
+    {
+        const auto file = args.getFileForOption("--output");
+
+        if (!file.replaceWithText(json))
+        {
+            std::cerr << "Could not write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
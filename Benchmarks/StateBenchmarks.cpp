@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    StateBenchmarks.cpp
+
+  ==============================================================================
+*/
+
+#include "StateBenchmarks.h"
+#include "../Tests/LegacyState.h"
+
+namespace
+{
+// Fills numSlots slots across both chains and moves a few parameters of
+// each off their defaults, as a user would
+void populate(ADSREchoAudioProcessor& processor, int numSlots)
+{
+    const ModuleType types[] = { ModuleType::Delay, ModuleType::Reverb, ModuleType::MultiTap };
+
+    for (int n = 0; n < numSlots; ++n)
+        processor.addModule(n % processor.getNumChains(), types[n % 3]);
+
+    juce::Random random(0x5eed);
+
+    for (int j = 0; j < processor.getNumChains(); j++)
+    {
+        for (int i = 0; i < processor.getNumSlots(); ++i)
+        {
+            if (processor.slotIsEmpty(j, i))
+                continue;
+
+            for (const auto* suffix : { ".mix", ".feedback", ".delayTime", ".decayTime", ".damping" })
+                if (auto* p = processor.apvts.getParameter(processor.getRack().slots[j][i]->slotID + suffix))
+                    p->setValueNotifyingHost(random.nextFloat());
+        }
+    }
+}
+
+double timeLoad(const juce::MemoryBlock& data, int repeats)
+{
+    ADSREchoAudioProcessor processor;
+    std::vector<double> seconds;
+
+    for (int r = -1; r < repeats; ++r)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        processor.setStateInformation(data.getData(), (int) data.getSize());
+        const auto end = juce::Time::getHighResolutionTicks();
+
+        if (r >= 0)     // first run is warm-up
+            seconds.push_back(juce::Time::highResolutionTicksToSeconds(end - start));
+    }
+
+    std::sort(seconds.begin(), seconds.end());
+    return seconds[seconds.size() / 2];
+}
+}
+
+juce::var StateBenchmarks::run(int repeats)
+{
+    juce::Array<juce::var> results;
+
+    for (int numSlots : { 0, 1, 4, 8, 16 })
+    {
+        ADSREchoAudioProcessor processor;
+        populate(processor, numSlots);
+
+        juce::MemoryBlock binary;
+        processor.getStateInformation(binary);
+
+        const auto legacy = createLegacyState(processor);
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("populatedSlots", numSlots);
+        result->setProperty("binaryBytes", (int) binary.getSize());
+        result->setProperty("legacyBytes", (int) legacy.getSize());
+        result->setProperty("binaryLoadUs", 1.0e6 * timeLoad(binary, repeats));
+        result->setProperty("legacyLoadUs", 1.0e6 * timeLoad(legacy, repeats));
+        results.add(juce::var(result));
+    }
+
+    return results;
+}
@@ -0,0 +1,19 @@
+/*
+  ==============================================================================
+
+    StateBenchmarks.h
+    Times setStateInformation for the binary rack state and for the legacy
+    XML state at several numbers of populated slots.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PluginProcessor.h"
+
+namespace StateBenchmarks
+{
+    // One result per populated-slot count: blob sizes and median load times
+    juce::var run(int repeats);
+}
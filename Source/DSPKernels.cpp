@@ -0,0 +1,525 @@
+#include "DSPKernels.h"
+#include "HalfFloat.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define ADSRECHO_X86_DISPATCH 1
+  #include <immintrin.h>
+#else
+  #define ADSRECHO_X86_DISPATCH 0
+#endif
+
+// GCC and Clang need the ISA enabled per function; MSVC accepts the
+// intrinsics in any function
+#if ADSRECHO_X86_DISPATCH && (defined(__GNUC__) || defined(__clang__))
+  #define ADSRECHO_TARGET(isa) __attribute__((target(isa)))
+#else
+  #define ADSRECHO_TARGET(isa)
+#endif
+
+namespace DSPKernels
+{
+//==============================================================================
+// Baseline: plain loops, vectorised by the compiler for SSE2 / NEON
+//==============================================================================
+
+static void complexMultiplyAccumulateBaseline(float* acc, const float* a, const float* b, int numBins)
+{
+    float* accRe = acc;
+    float* accIm = acc + numBins;
+
+    const float* aRe = a;
+    const float* aIm = a + numBins;
+    const float* bRe = b;
+    const float* bIm = b + numBins;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        accRe[k] += aRe[k] * bRe[k] - aIm[k] * bIm[k];
+        accIm[k] += aRe[k] * bIm[k] + aIm[k] * bRe[k];
+    }
+}
+
+static void addWithMultiplyBaseline(float* dest, const float* src, float gain, int numSamples)
+{
+    juce::FloatVectorOperations::addWithMultiply(dest, src, gain, numSamples);
+}
+
+static void mixBaseline(float* dest, float destGain, const float* src, float srcGain, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] = dest[i] * destGain + src[i] * srcGain;
+}
+
+static void lerpBaseline(float* dest, const float* a, const float* b, float t, int numValues)
+{
+    for (int i = 0; i < numValues; ++i)
+        dest[i] = a[i] + (b[i] - a[i]) * t;
+}
+
+// Four independent lanes, so the compiler can keep them in one register
+// without reordering a single float sum
+static void measureBaseline(const float* src, int numSamples, float& peak, float& sumOfSquares)
+{
+    float peaks[4] = { peak, 0.0f, 0.0f, 0.0f };
+    float sums[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            peaks[k] = juce::jmax(peaks[k], std::abs(src[i + k]));
+            sums[k] += src[i + k] * src[i + k];
+        }
+    }
+
+    for (; i < numSamples; ++i)
+    {
+        peaks[0] = juce::jmax(peaks[0], std::abs(src[i]));
+        sums[0] += src[i] * src[i];
+    }
+
+    peak = juce::jmax(juce::jmax(peaks[0], peaks[1]), juce::jmax(peaks[2], peaks[3]));
+    sumOfSquares += (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+// NEON converts four halves per instruction here; on x86 this is the bit-level
+// version, which the AVX2 table replaces with F16C
+static void floatToHalfBaseline(const float* src, juce::uint16* dest, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] = HalfFloat::floatToHalf(src[i]);
+}
+
+static void halfToFloatBaseline(const juce::uint16* src, float* dest, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] = HalfFloat::halfToFloat(src[i]);
+}
+
+static const Table baselineTable {
+    Isa::Baseline,
+    complexMultiplyAccumulateBaseline,
+    addWithMultiplyBaseline,
+    mixBaseline,
+    lerpBaseline,
+    measureBaseline,
+    floatToHalfBaseline,
+    halfToFloatBaseline
+};
+
+#if ADSRECHO_X86_DISPATCH
+//==============================================================================
+// AVX2 + FMA: 8 floats per register
+//==============================================================================
+
+ADSRECHO_TARGET("avx2,fma")
+static void complexMultiplyAccumulateAVX2(float* acc, const float* a, const float* b, int numBins)
+{
+    float* accRe = acc;
+    float* accIm = acc + numBins;
+
+    const float* aRe = a;
+    const float* aIm = a + numBins;
+    const float* bRe = b;
+    const float* bIm = b + numBins;
+
+    int k = 0;
+
+    for (; k + 8 <= numBins; k += 8)
+    {
+        const __m256 ar = _mm256_loadu_ps(aRe + k);
+        const __m256 ai = _mm256_loadu_ps(aIm + k);
+        const __m256 br = _mm256_loadu_ps(bRe + k);
+        const __m256 bi = _mm256_loadu_ps(bIm + k);
+
+        __m256 re = _mm256_loadu_ps(accRe + k);
+        __m256 im = _mm256_loadu_ps(accIm + k);
+
+        re = _mm256_fnmadd_ps(ai, bi, _mm256_fmadd_ps(ar, br, re));
+        im = _mm256_fmadd_ps(ai, br, _mm256_fmadd_ps(ar, bi, im));
+
+        _mm256_storeu_ps(accRe + k, re);
+        _mm256_storeu_ps(accIm + k, im);
+    }
+
+    // numBins is fftSize / 2 + 1, so there is always a tail
+    for (; k < numBins; ++k)
+    {
+        accRe[k] += aRe[k] * bRe[k] - aIm[k] * bIm[k];
+        accIm[k] += aRe[k] * bIm[k] + aIm[k] * bRe[k];
+    }
+}
+
+ADSRECHO_TARGET("avx2,fma")
+static void addWithMultiplyAVX2(float* dest, const float* src, float gain, int numSamples)
+{
+    const __m256 g = _mm256_set1_ps(gain);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+        _mm256_storeu_ps(dest + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i), g, _mm256_loadu_ps(dest + i)));
+
+    for (; i < numSamples; ++i)
+        dest[i] += src[i] * gain;
+}
+
+ADSRECHO_TARGET("avx2,fma")
+static void mixAVX2(float* dest, float destGain, const float* src, float srcGain, int numSamples)
+{
+    const __m256 dg = _mm256_set1_ps(destGain);
+    const __m256 sg = _mm256_set1_ps(srcGain);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const __m256 d = _mm256_mul_ps(_mm256_loadu_ps(dest + i), dg);
+        _mm256_storeu_ps(dest + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i), sg, d));
+    }
+
+    for (; i < numSamples; ++i)
+        dest[i] = dest[i] * destGain + src[i] * srcGain;
+}
+
+ADSRECHO_TARGET("avx2,fma")
+static void lerpAVX2(float* dest, const float* a, const float* b, float t, int numValues)
+{
+    const __m256 tv = _mm256_set1_ps(t);
+    int i = 0;
+
+    for (; i + 8 <= numValues; i += 8)
+    {
+        const __m256 av = _mm256_loadu_ps(a + i);
+        _mm256_storeu_ps(dest + i, _mm256_fmadd_ps(_mm256_sub_ps(_mm256_loadu_ps(b + i), av), tv, av));
+    }
+
+    for (; i < numValues; ++i)
+        dest[i] = a[i] + (b[i] - a[i]) * t;
+}
+
+ADSRECHO_TARGET("avx2,fma")
+static void measureAVX2(const float* src, int numSamples, float& peak, float& sumOfSquares)
+{
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 peaks = _mm256_setzero_ps();
+    __m256 sums = _mm256_setzero_ps();
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(src + i);
+        peaks = _mm256_max_ps(peaks, _mm256_andnot_ps(signMask, x));
+        sums = _mm256_fmadd_ps(x, x, sums);
+    }
+
+    alignas(32) float p[8];
+    alignas(32) float s[8];
+    _mm256_store_ps(p, peaks);
+    _mm256_store_ps(s, sums);
+
+    float blockPeak = peak;
+    float blockSum = 0.0f;
+
+    for (int k = 0; k < 8; ++k)
+    {
+        blockPeak = juce::jmax(blockPeak, p[k]);
+        blockSum += s[k];
+    }
+
+    for (; i < numSamples; ++i)
+    {
+        blockPeak = juce::jmax(blockPeak, std::abs(src[i]));
+        blockSum += src[i] * src[i];
+    }
+
+    peak = blockPeak;
+    sumOfSquares += blockSum;
+}
+
+// F16C shipped with every AVX2 CPU, so it is not checked separately
+ADSRECHO_TARGET("avx2,fma,f16c")
+static void floatToHalfAVX2(const float* src, juce::uint16* dest, int numSamples)
+{
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+        _mm_storeu_si128((__m128i*) (dest + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+
+    for (; i < numSamples; ++i)
+        dest[i] = (juce::uint16) _cvtss_sh(src[i], _MM_FROUND_TO_NEAREST_INT);
+}
+
+ADSRECHO_TARGET("avx2,fma,f16c")
+static void halfToFloatAVX2(const juce::uint16* src, float* dest, int numSamples)
+{
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+        _mm256_storeu_ps(dest + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (src + i))));
+
+    for (; i < numSamples; ++i)
+        dest[i] = _cvtsh_ss(src[i]);
+}
+
+static const Table avx2Table {
+    Isa::AVX2,
+    complexMultiplyAccumulateAVX2,
+    addWithMultiplyAVX2,
+    mixAVX2,
+    lerpAVX2,
+    measureAVX2,
+    floatToHalfAVX2,
+    halfToFloatAVX2
+};
+
+//==============================================================================
+// AVX-512F: 16 floats per register, tails handled with a lane mask
+//==============================================================================
+
+ADSRECHO_TARGET("avx512f")
+static void complexMultiplyAccumulateAVX512(float* acc, const float* a, const float* b, int numBins)
+{
+    float* accRe = acc;
+    float* accIm = acc + numBins;
+
+    const float* aRe = a;
+    const float* aIm = a + numBins;
+    const float* bRe = b;
+    const float* bIm = b + numBins;
+
+    for (int k = 0; k < numBins; k += 16)
+    {
+        const __mmask16 m = (__mmask16) (numBins - k >= 16 ? 0xffff : (1u << (numBins - k)) - 1u);
+
+        const __m512 ar = _mm512_maskz_loadu_ps(m, aRe + k);
+        const __m512 ai = _mm512_maskz_loadu_ps(m, aIm + k);
+        const __m512 br = _mm512_maskz_loadu_ps(m, bRe + k);
+        const __m512 bi = _mm512_maskz_loadu_ps(m, bIm + k);
+
+        __m512 re = _mm512_maskz_loadu_ps(m, accRe + k);
+        __m512 im = _mm512_maskz_loadu_ps(m, accIm + k);
+
+        re = _mm512_fnmadd_ps(ai, bi, _mm512_fmadd_ps(ar, br, re));
+        im = _mm512_fmadd_ps(ai, br, _mm512_fmadd_ps(ar, bi, im));
+
+        _mm512_mask_storeu_ps(accRe + k, m, re);
+        _mm512_mask_storeu_ps(accIm + k, m, im);
+    }
+}
+
+ADSRECHO_TARGET("avx512f")
+static void addWithMultiplyAVX512(float* dest, const float* src, float gain, int numSamples)
+{
+    const __m512 g = _mm512_set1_ps(gain);
+
+    for (int i = 0; i < numSamples; i += 16)
+    {
+        const __mmask16 m = (__mmask16) (numSamples - i >= 16 ? 0xffff : (1u << (numSamples - i)) - 1u);
+        const __m512 d = _mm512_maskz_loadu_ps(m, dest + i);
+        _mm512_mask_storeu_ps(dest + i, m, _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, src + i), g, d));
+    }
+}
+
+ADSRECHO_TARGET("avx512f")
+static void mixAVX512(float* dest, float destGain, const float* src, float srcGain, int numSamples)
+{
+    const __m512 dg = _mm512_set1_ps(destGain);
+    const __m512 sg = _mm512_set1_ps(srcGain);
+
+    for (int i = 0; i < numSamples; i += 16)
+    {
+        const __mmask16 m = (__mmask16) (numSamples - i >= 16 ? 0xffff : (1u << (numSamples - i)) - 1u);
+        const __m512 d = _mm512_mul_ps(_mm512_maskz_loadu_ps(m, dest + i), dg);
+        _mm512_mask_storeu_ps(dest + i, m, _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, src + i), sg, d));
+    }
+}
+
+ADSRECHO_TARGET("avx512f")
+static void lerpAVX512(float* dest, const float* a, const float* b, float t, int numValues)
+{
+    const __m512 tv = _mm512_set1_ps(t);
+
+    for (int i = 0; i < numValues; i += 16)
+    {
+        const __mmask16 m = (__mmask16) (numValues - i >= 16 ? 0xffff : (1u << (numValues - i)) - 1u);
+        const __m512 av = _mm512_maskz_loadu_ps(m, a + i);
+        const __m512 bv = _mm512_maskz_loadu_ps(m, b + i);
+        _mm512_mask_storeu_ps(dest + i, m, _mm512_fmadd_ps(_mm512_sub_ps(bv, av), tv, av));
+    }
+}
+
+// Masked-off lanes load as zero, which changes neither the peak nor the sum
+ADSRECHO_TARGET("avx512f")
+static void measureAVX512(const float* src, int numSamples, float& peak, float& sumOfSquares)
+{
+    __m512 peaks = _mm512_setzero_ps();
+    __m512 sums = _mm512_setzero_ps();
+
+    for (int i = 0; i < numSamples; i += 16)
+    {
+        const __mmask16 m = (__mmask16) (numSamples - i >= 16 ? 0xffff : (1u << (numSamples - i)) - 1u);
+        const __m512 x = _mm512_maskz_loadu_ps(m, src + i);
+        peaks = _mm512_max_ps(peaks, _mm512_abs_ps(x));
+        sums = _mm512_fmadd_ps(x, x, sums);
+    }
+
+    peak = juce::jmax(peak, _mm512_reduce_max_ps(peaks));
+    sumOfSquares += _mm512_reduce_add_ps(sums);
+}
+
+// Masked 16-bit loads and stores would need AVX-512BW, so the tails go
+// through F16C one sample at a time
+ADSRECHO_TARGET("avx512f,f16c")
+static void floatToHalfAVX512(const float* src, juce::uint16* dest, int numSamples)
+{
+    int i = 0;
+
+    for (; i + 16 <= numSamples; i += 16)
+        _mm256_storeu_si256((__m256i*) (dest + i), _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+
+    for (; i < numSamples; ++i)
+        dest[i] = (juce::uint16) _cvtss_sh(src[i], _MM_FROUND_TO_NEAREST_INT);
+}
+
+ADSRECHO_TARGET("avx512f,f16c")
+static void halfToFloatAVX512(const juce::uint16* src, float* dest, int numSamples)
+{
+    int i = 0;
+
+    for (; i + 16 <= numSamples; i += 16)
+        _mm512_storeu_ps(dest + i, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*) (src + i))));
+
+    for (; i < numSamples; ++i)
+        dest[i] = _cvtsh_ss(src[i]);
+}
+
+static const Table avx512Table {
+    Isa::AVX512,
+    complexMultiplyAccumulateAVX512,
+    addWithMultiplyAVX512,
+    mixAVX512,
+    lerpAVX512,
+    measureAVX512,
+    floatToHalfAVX512,
+    halfToFloatAVX512
+};
+#endif
+
+//==============================================================================
+// Selection
+//==============================================================================
+
+static const Table& getTable(Isa isa)
+{
+   #if ADSRECHO_X86_DISPATCH
+    switch (isa)
+    {
+        case Isa::AVX512: return avx512Table;
+        case Isa::AVX2:   return avx2Table;
+        case Isa::Baseline:
+        default:          break;
+    }
+   #else
+    juce::ignoreUnused(isa);
+   #endif
+
+    return baselineTable;
+}
+
+bool isSupported(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::Baseline:
+            return true;
+
+       #if ADSRECHO_X86_DISPATCH
+        case Isa::AVX2:
+            return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+
+        case Isa::AVX512:
+            return juce::SystemStats::hasAVX512F();
+       #endif
+
+        default:
+            return false;
+    }
+}
+
+Isa getBestSupportedIsa()
+{
+    if (isSupported(Isa::AVX512))
+        return Isa::AVX512;
+
+    if (isSupported(Isa::AVX2))
+        return Isa::AVX2;
+
+    return Isa::Baseline;
+}
+
+// Best supported, unless ADSRECHO_ISA asks for something the CPU can run
+static const Table* selectStartupTable()
+{
+    auto isa = getBestSupportedIsa();
+    const auto requested = juce::SystemStats::getEnvironmentVariable("ADSRECHO_ISA", {}).trim().toLowerCase();
+
+    if (requested == "baseline" || requested == "sse2" || requested == "neon")
+        isa = Isa::Baseline;
+    else if (requested == "avx2" && isSupported(Isa::AVX2))
+        isa = Isa::AVX2;
+    else if (requested == "avx512" && isSupported(Isa::AVX512))
+        isa = Isa::AVX512;
+
+    return &getTable(isa);
+}
+
+static std::atomic<const Table*> currentTable { selectStartupTable() };
+
+const Table& get()
+{
+    return *currentTable.load(std::memory_order_acquire);
+}
+
+Isa getIsa()
+{
+    return get().isa;
+}
+
+bool setIsa(Isa isa)
+{
+    if (!isSupported(isa))
+        return false;
+
+    currentTable.store(&getTable(isa), std::memory_order_release);
+    return true;
+}
+
+juce::String getIsaName(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::AVX2:   return "AVX2+FMA";
+        case Isa::AVX512: return "AVX-512";
+        case Isa::Baseline:
+        default:
+           #if ADSRECHO_X86_DISPATCH
+            return "SSE2";
+           #elif JUCE_ARM
+            return "NEON";
+           #else
+            return "Scalar";
+           #endif
+    }
+}
+
+juce::String describe()
+{
+    const auto current = getIsa();
+    const auto best = getBestSupportedIsa();
+
+    if (current == best)
+        return getIsaName(current);
+
+    return getIsaName(current) + " (best: " + getIsaName(best) + ")";
+}
+}
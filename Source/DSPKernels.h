@@ -0,0 +1,66 @@
+// DSPKernels.h - Hot block kernels, picked for the host CPU at load time
+//
+// Each kernel has a portable build (SSE2 on x86-64, NEON on arm64, both of
+// which are the compiler baseline) and, on x86, AVX2+FMA and AVX-512 builds
+// compiled per function. The best table the CPU supports is selected during
+// static initialisation, when the library is loaded; ADSRECHO_ISA (baseline /
+// avx2 / avx512) or setIsa() overrides it so the variants can be compared in
+// the same binary.
+
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_core/juce_core.h>
+#endif
+
+namespace DSPKernels
+{
+    enum class Isa
+    {
+        Baseline = 0,
+        AVX2,
+        AVX512
+    };
+
+    struct Table
+    {
+        Isa isa;
+
+        // Split-complex MAC: acc += a * b over numBins bins
+        // (re in [0, numBins), im in [numBins, 2 * numBins))
+        void (*complexMultiplyAccumulate)(float* acc, const float* a, const float* b, int numBins);
+
+        // dest += src * gain
+        void (*addWithMultiply)(float* dest, const float* src, float gain, int numSamples);
+
+        // dest = dest * destGain + src * srcGain (chain dry/wet mix)
+        void (*mix)(float* dest, float destGain, const float* src, float srcGain, int numSamples);
+
+        // dest = a + (b - a) * t (snapshot morph)
+        void (*lerp)(float* dest, const float* a, const float* b, float t, int numValues);
+
+        // peak = max(peak, |src|), sumOfSquares += src^2 (level meters)
+        void (*measure)(const float* src, int numSamples, float& peak, float& sumOfSquares);
+
+        // IEEE half storage (HalfFloat.h), rounded to nearest even
+        void (*floatToHalf)(const float* src, juce::uint16* dest, int numSamples);
+        void (*halfToFloat)(const juce::uint16* src, float* dest, int numSamples);
+    };
+
+    // Table in use; safe to call from the audio thread
+    const Table& get();
+
+    Isa getIsa();
+    Isa getBestSupportedIsa();
+    bool isSupported(Isa isa);
+
+    // Returns false (and keeps the current table) if the CPU lacks the ISA
+    bool setIsa(Isa isa);
+
+    juce::String getIsaName(Isa isa);
+
+    // e.g. "AVX2+FMA (best: AVX-512)", for logs and benchmark reports
+    juce::String describe();
+}
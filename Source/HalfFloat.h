@@ -0,0 +1,127 @@
+// HalfFloat.h - 16-bit float encodings for sample storage
+//
+// IEEE binary16 ("half", 1-5-10 bits) and bfloat16 (1-8-7 bits, the top half
+// of a float), both rounded to nearest even. Half keeps 11 significant bits
+// (relative error at most 2^-11, -66 dB) down to 6.1e-5 (-84 dBFS); below
+// that it is subnormal, with a fixed step of 6e-8. bfloat16 keeps float's
+// exponent range but only 8 significant bits (at most 2^-8, -48 dB).
+//
+// These convert one sample at a time, for the per-sample paths; blocks of
+// half samples go through DSPKernels (F16C / NEON). Scalar half conversion
+// uses F16C or NEON when the build targets them, otherwise a branch-light
+// bit-level version.
+
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_core/juce_core.h>
+#endif
+
+#if defined(__F16C__)
+  #include <immintrin.h>
+#endif
+
+namespace HalfFloat
+{
+    inline juce::uint32 toBits(float x)
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return bits;
+    }
+
+    inline float fromBits(juce::uint32 bits)
+    {
+        float x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+
+    //==============================================================================
+    // binary16
+
+    inline juce::uint16 floatToHalf(float x)
+    {
+       #if defined(__F16C__)
+        return (juce::uint16) _cvtss_sh(x, _MM_FROUND_TO_NEAREST_INT);
+       #elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+        const __fp16 h = (__fp16) x;
+        juce::uint16 bits;
+        std::memcpy(&bits, &h, sizeof(bits));
+        return bits;
+       #else
+        juce::uint32 bits = toBits(x);
+        const juce::uint32 sign = (bits >> 16) & 0x8000u;
+        bits &= 0x7fffffffu;
+
+        // At or above 65520 rounds to infinity; NaN stays NaN
+        if (bits >= 0x477ff000u)
+            return (juce::uint16) (sign | (bits > 0x7f800000u ? 0x7e00u : 0x7c00u));
+
+        // Below the smallest normal half: adding 0.5f lines the subnormal
+        // mantissa up with float's and lets the FPU do the rounding
+        if (bits < 0x38800000u)
+            return (juce::uint16) (sign | (toBits(fromBits(bits) + 0.5f) - 0x3f000000u));
+
+        // Rebias the exponent and round the 13 dropped bits to nearest even
+        bits += 0xc8000fffu + ((bits >> 13) & 1u);
+        return (juce::uint16) (sign | (bits >> 13));
+       #endif
+    }
+
+    inline float halfToFloat(juce::uint16 h)
+    {
+       #if defined(__F16C__)
+        return _cvtsh_ss(h);
+       #elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+        __fp16 x;
+        std::memcpy(&x, &h, sizeof(x));
+        return (float) x;
+       #else
+        constexpr juce::uint32 exponentMask = 0x7c00u << 13;
+
+        juce::uint32 bits = ((juce::uint32) h & 0x7fffu) << 13;
+        const juce::uint32 exponent = bits & exponentMask;
+        bits += (127 - 15) << 23;
+
+        if (exponent == exponentMask)
+        {
+            bits += (128 - 16) << 23;                       // infinity / NaN
+        }
+        else if (exponent == 0)
+        {
+            bits = toBits(fromBits(bits + (1u << 23)) - fromBits(113u << 23));   // zero / subnormal
+        }
+
+        return fromBits(bits | (((juce::uint32) h & 0x8000u) << 16));
+       #endif
+    }
+
+    //==============================================================================
+    // bfloat16: plain integer arithmetic, so the block loops vectorise as they are
+
+    inline juce::uint16 floatToBFloat16(float x)
+    {
+        const juce::uint32 bits = toBits(x);
+        return (juce::uint16) ((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+    }
+
+    inline float bfloat16ToFloat(juce::uint16 b)
+    {
+        return fromBits((juce::uint32) b << 16);
+    }
+
+    inline void floatToBFloat16(const float* src, juce::uint16* dest, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = floatToBFloat16(src[i]);
+    }
+
+    inline void bfloat16ToFloat(const juce::uint16* src, float* dest, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = bfloat16ToFloat(src[i]);
+    }
+}
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    CpuProfiler.h
+    Per-slot, per-chain and per-callback processing time, measured on the
+    audio thread and summarised for the editor's CPU meters.
+
+  ==============================================================================
+*/
+
+#pragma once
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"  // for Projucer
+#else // for Cmake
+  #include <juce_core/juce_core.h>
+#endif
+
+// The audio thread fills one Frame per callback and pushes it through a
+// wait-free single-producer/single-consumer FIFO; the message thread drains
+// it in update() and keeps a rolling window per meter. Nothing is measured
+// unless a viewer is registered, so hidden meters cost one atomic load per
+// callback.
+template <int NumChains, int NumSlots>
+class CpuProfiler
+{
+public:
+    struct Stats
+    {
+        double meanMicros = 0.0;
+        double p99Micros = 0.0;
+        double maxMicros = 0.0;
+
+        // Share of the callback's real-time budget (numSamples / sampleRate)
+        float meanPercent = 0.0f;
+        float p99Percent = 0.0f;
+        float maxPercent = 0.0f;
+    };
+
+    //==============================================================================
+    // Message thread: meters register while they are on screen
+
+    void addViewer()    { viewers.fetch_add(1, std::memory_order_relaxed); }
+    void removeViewer() { viewers.fetch_sub(1, std::memory_order_relaxed); }
+
+    //==============================================================================
+    // Audio thread
+
+    bool isActive() const { return viewers.load(std::memory_order_relaxed) > 0; }
+
+    static juce::int64 now() { return juce::Time::getHighResolutionTicks(); }
+
+    void beginCallback(int numSamples, double sampleRate)
+    {
+        frame = {};
+        frame.budgetSeconds = sampleRate > 0.0 ? numSamples / sampleRate : 0.0;
+        callbackStart = now();
+    }
+
+    void addSlotTime(int chainIndex, int slotIndex, juce::int64 ticks)
+    {
+        frame.slotTicks[chainIndex][slotIndex] = ticks;
+    }
+
+    // Whole chain: its slots plus the chain's mix and gain
+    void addChainTime(int chainIndex, juce::int64 ticks)
+    {
+        frame.chainTicks[chainIndex] = ticks;
+    }
+
+    // Drops the frame if the editor has fallen behind
+    void endCallback()
+    {
+        frame.callbackTicks = now() - callbackStart;
+
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0)
+            frames[(size_t) scope.startIndex1] = frame;
+    }
+
+    //==============================================================================
+    // Message thread
+
+    // Drains the FIFO and refreshes the statistics
+    void update()
+    {
+        bool changed = false;
+
+        while (fifo.getNumReady() > 0)
+        {
+            Frame f;
+
+            {
+                const auto scope = fifo.read(1);
+                f = frames[(size_t) scope.startIndex1];
+            }
+
+            if (f.budgetSeconds <= 0.0)
+                continue;
+
+            for (int c = 0; c < NumChains; ++c)
+            {
+                for (int s = 0; s < NumSlots; ++s)
+                    slotHistory[c][s].add(f.slotTicks[c][s], f.budgetSeconds);
+
+                chainHistory[c].add(f.chainTicks[c], f.budgetSeconds);
+            }
+
+            callbackHistory.add(f.callbackTicks, f.budgetSeconds);
+            changed = true;
+        }
+
+        if (!changed)
+            return;
+
+        for (int c = 0; c < NumChains; ++c)
+        {
+            for (int s = 0; s < NumSlots; ++s)
+                slotStats[c][s] = slotHistory[c][s].summarise();
+
+            chainStats[c] = chainHistory[c].summarise();
+        }
+
+        callbackStats = callbackHistory.summarise();
+    }
+
+    // Forget a slot's history, e.g. after its module changed
+    void resetSlot(int chainIndex, int slotIndex)
+    {
+        slotHistory[chainIndex][slotIndex] = {};
+        slotStats[chainIndex][slotIndex] = {};
+    }
+
+    const Stats& getSlotStats(int chainIndex, int slotIndex) const { return slotStats[chainIndex][slotIndex]; }
+    const Stats& getChainStats(int chainIndex) const               { return chainStats[chainIndex]; }
+    const Stats& getCallbackStats() const                          { return callbackStats; }
+
+private:
+    static constexpr int fifoSize = 256;      // ~1.5 s of 256-sample blocks at 44.1 kHz
+    static constexpr int historySize = 512;   // callbacks per rolling window
+
+    struct Frame
+    {
+        juce::int64 slotTicks[NumChains][NumSlots] {};
+        juce::int64 chainTicks[NumChains] {};
+        juce::int64 callbackTicks = 0;
+        double budgetSeconds = 0.0;
+    };
+
+    // Rolling window of (time, share of budget) for one meter
+    struct History
+    {
+        void add(juce::int64 ticks, double budgetSeconds)
+        {
+            const double seconds = juce::Time::highResolutionTicksToSeconds(ticks);
+
+            micros[(size_t) writeIndex] = seconds * 1.0e6;
+            percent[(size_t) writeIndex] = (float) (100.0 * seconds / budgetSeconds);
+
+            writeIndex = (writeIndex + 1) % historySize;
+            count = juce::jmin(count + 1, historySize);
+        }
+
+        Stats summarise() const
+        {
+            Stats stats;
+
+            if (count == 0)
+                return stats;
+
+            summariseInto(micros, count, stats.meanMicros, stats.p99Micros, stats.maxMicros);
+            summariseInto(percent, count, stats.meanPercent, stats.p99Percent, stats.maxPercent);
+
+            return stats;
+        }
+
+        template <typename T>
+        static void summariseInto(const std::array<T, historySize>& values, int count, T& mean, T& p99, T& max)
+        {
+            std::array<T, historySize> sorted {};
+            auto first = sorted.begin();
+            auto last = std::copy_n(values.begin(), count, first);
+            auto p99Position = first + (count - 1) * 99 / 100;
+
+            mean = std::accumulate(first, last, T (0)) / (T) count;
+            max = *std::max_element(first, last);
+
+            std::nth_element(first, p99Position, last);
+            p99 = *p99Position;
+        }
+
+        std::array<double, historySize> micros {};
+        std::array<float, historySize> percent {};
+        int writeIndex = 0;
+        int count = 0;
+    };
+
+    std::atomic<int> viewers { 0 };
+
+    // Audio thread
+    Frame frame;
+    juce::int64 callbackStart = 0;
+
+    // Audio -> message thread
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Frame, fifoSize> frames;
+
+    // Message thread
+    History slotHistory[NumChains][NumSlots];
+    History chainHistory[NumChains];
+    History callbackHistory;
+
+    Stats slotStats[NumChains][NumSlots];
+    Stats chainStats[NumChains];
+    Stats callbackStats;
+};
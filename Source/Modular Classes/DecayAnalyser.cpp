@@ -0,0 +1,133 @@
+#include "DecayAnalyser.h"
+
+DecayAnalyser::DecayAnalyser()
+    : juce::Thread("Decay Analyser")
+{
+    startThread();
+}
+
+DecayAnalyser::~DecayAnalyser()
+{
+    stopThread(4000);
+}
+
+void DecayAnalyser::request(int slot, juce::uint64 key, std::unique_ptr<DecayAnalysis::Source> source, double sampleRate)
+{
+    if (source == nullptr || sampleRate <= 0.0)
+        return;
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        if (cache.count(key) > 0 || busyKey == key)
+            return;
+
+        auto existing = std::find_if(queue.begin(), queue.end(), [slot](const Request& r) { return r.slot == slot; });
+
+        if (existing != queue.end())
+        {
+            existing->key = key;
+            existing->source = std::move(source);
+            existing->sampleRate = sampleRate;
+        }
+        else
+        {
+            queue.push_back({ slot, key, std::move(source), sampleRate });
+        }
+    }
+
+    notify();
+}
+
+bool DecayAnalyser::isKnown(juce::uint64 key) const
+{
+    const juce::ScopedLock sl(lock);
+
+    if (cache.count(key) > 0 || busyKey == key)
+        return true;
+
+    return std::any_of(queue.begin(), queue.end(), [key](const Request& r) { return r.key == key; });
+}
+
+bool DecayAnalyser::waitUntilIdle(int timeoutMs) const
+{
+    const auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) timeoutMs;
+
+    for (;;)
+    {
+        {
+            const juce::ScopedLock sl(lock);
+
+            if (queue.empty() && busyKey == 0)
+                return true;
+        }
+
+        if (juce::Time::getMillisecondCounter() >= deadline)
+            return false;
+
+        juce::Thread::sleep(5);
+    }
+}
+
+std::shared_ptr<const DecayAnalyser::Result> DecayAnalyser::find(juce::uint64 key) const
+{
+    const juce::ScopedLock sl(lock);
+
+    auto it = cache.find(key);
+    return it != cache.end() ? it->second : nullptr;
+}
+
+void DecayAnalyser::run()
+{
+    while (!threadShouldExit())
+    {
+        Request next;
+
+        {
+            const juce::ScopedLock sl(lock);
+
+            if (!queue.empty())
+            {
+                next = std::move(queue.front());
+                queue.erase(queue.begin());
+                busyKey = next.key;
+            }
+        }
+
+        if (next.source == nullptr)
+        {
+            wait(-1);
+            continue;
+        }
+
+        const auto response = DecayAnalysis::render(*next.source, next.sampleRate, maxRenderSeconds,
+                                                    [this] { return threadShouldExit(); });
+
+        std::shared_ptr<const Result> result;
+
+        if (!response.empty())
+            result = std::make_shared<const Result>(DecayAnalysis::analyse(response, next.sampleRate));
+
+        // Frees the offline copy here rather than on the message thread
+        next.source.reset();
+
+        const juce::ScopedLock sl(lock);
+        busyKey = 0;
+
+        // Silent sources are cached too, so they are not rendered again on
+        // every update; an interrupted render is not
+        if (result == nullptr && threadShouldExit())
+            continue;
+
+        cache[next.key] = std::move(result);
+        cacheOrder.push_back(next.key);
+
+        while (cacheOrder.size() > maxCached)
+        {
+            cache.erase(cacheOrder.front());
+            cacheOrder.pop_front();
+        }
+
+        newResults = true;
+    }
+}
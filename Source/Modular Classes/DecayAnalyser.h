@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    DecayAnalyser.h
+    Background decay analysis for the processor's slots. Each request carries
+    an offline copy of a module's DSP and a key hashing the module type and
+    parameters; a worker thread renders its impulse response faster than real
+    time and caches the EDCs and RT60s under that key.
+
+  ==============================================================================
+*/
+
+#pragma once
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"  // for Projucer
+#else // for Cmake
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_core/juce_core.h>
+  #include <juce_dsp/juce_dsp.h>
+#endif
+
+#include "../Reverb Algorithms/DecayAnalysis.h"
+
+// Like IRLoadQueue, each slot holds at most one waiting request and a newer
+// one replaces it, so dragging a knob queues one analysis per slot rather
+// than one per step. Nothing here is touched by the audio thread.
+class DecayAnalyser : private juce::Thread
+{
+public:
+    using Result = DecayAnalysis::Result;
+
+    DecayAnalyser();
+    ~DecayAnalyser() override;
+
+    //==============================================================================
+    // Message thread
+
+    // Queues an analysis unless the key is already cached or being analysed
+    void request(int slot, juce::uint64 key, std::unique_ptr<DecayAnalysis::Source> source, double sampleRate);
+
+    bool isKnown(juce::uint64 key) const;
+
+    // True once after each batch of new results
+    bool takeNewResults() { return newResults.exchange(false); }
+
+    // Blocks until every queued request is done (tests and offline tools)
+    bool waitUntilIdle(int timeoutMs) const;
+
+    //==============================================================================
+    // Any thread but the audio thread; nullptr until the key has been
+    // analysed, after it has been dropped from the cache, or if it had no
+    // response at all
+    std::shared_ptr<const Result> find(juce::uint64 key) const;
+
+private:
+    void run() override;
+
+    struct Request
+    {
+        int slot = 0;
+        juce::uint64 key = 0;
+        std::unique_ptr<DecayAnalysis::Source> source;
+        double sampleRate = 0.0;
+    };
+
+    // Longest response rendered, ~1.5x the longest reverb decay
+    static constexpr double maxRenderSeconds = 30.0;
+
+    // Results kept; older ones are dropped first, and isKnown() is false
+    // for them again so the caller can queue them anew
+    static constexpr size_t maxCached = 64;
+
+    juce::CriticalSection lock;     // guards everything below
+    std::vector<Request> queue;
+    juce::uint64 busyKey = 0;       // 0 = idle
+
+    std::map<juce::uint64, std::shared_ptr<const Result>> cache;   // nullptr = silent
+    std::deque<juce::uint64> cacheOrder;
+
+    std::atomic<bool> newResults { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecayAnalyser)
+};
@@ -13,6 +13,7 @@ ConvolutionModule::ConvolutionModule(const juce::String& id,
                                      juce::AudioProcessorValueTreeState& apvts)
     : moduleID(id), state(apvts)
 {
+    updateParameterPointers();
 }
 
 void ConvolutionModule::prepare(const juce::dsp::ProcessSpec& spec)
@@ -23,25 +24,48 @@ void ConvolutionModule::prepare(const juce::dsp::ProcessSpec& spec)
 void ConvolutionModule::process(juce::AudioBuffer<float>& buffer,
                                 juce::MidiBuffer& midi)
 {
+    if (enabledParam == nullptr)
+        return;
+
     // Build parameter struct from APVTS
     ConvolutionParameters params;
 
-    params.mix       = state.getRawParameterValue(moduleID + ".mix")->load();
-    params.preDelay  = state.getRawParameterValue(moduleID + ".preDelay")->load();
+    params.mix       = mixParam->load();
+    params.preDelay  = preDelayParam->load();
 
     // Convolution-specific controls
-    params.irIndex   = state.getRawParameterValue(moduleID + ".convIrIndex")->load();
-    params.irGainDb  = state.getRawParameterValue(moduleID + ".convIrGain")->load();
-    params.lowCutHz  = state.getRawParameterValue(moduleID + ".convLowCut")->load();
-    params.highCutHz = state.getRawParameterValue(moduleID + ".convHighCut")->load();
+    params.irIndex   = (int) irIndexParam->load();
+    params.irGainDb  = irGainParam->load();
+    params.lowCutHz  = lowCutParam->load();
+    params.highCutHz = highCutParam->load();
+    params.tiltDb    = tiltParam->load();
+    params.trueStereo = trueStereoParam->load() > 0.5f;
 
     convolutionReverb.setParameters(params);
 
     // Enabled flag follows same pattern as DatorroModule
-    if (*state.getRawParameterValue(moduleID + ".enabled") == true)
+    if (enabledParam->load() > 0.5f)
         convolutionReverb.processBlock(buffer, midi);
 }
 
+void ConvolutionModule::updateParameterPointers()
+{
+    enabledParam    = state.getRawParameterValue(moduleID + ".enabled");
+    mixParam        = state.getRawParameterValue(moduleID + ".mix");
+    preDelayParam   = state.getRawParameterValue(moduleID + ".preDelay");
+    irIndexParam    = state.getRawParameterValue(moduleID + ".convIrIndex");
+    irGainParam     = state.getRawParameterValue(moduleID + ".convIrGain");
+    lowCutParam     = state.getRawParameterValue(moduleID + ".convLowCut");
+    highCutParam    = state.getRawParameterValue(moduleID + ".convHighCut");
+    tiltParam       = state.getRawParameterValue(moduleID + ".convTilt");
+    trueStereoParam = state.getRawParameterValue(moduleID + ".convTrueStereo");
+
+    for (auto* param : { mixParam, preDelayParam, irIndexParam, irGainParam,
+                         lowCutParam, highCutParam, tiltParam, trueStereoParam })
+        if (param == nullptr)
+            enabledParam = nullptr;
+}
+
 std::vector<juce::String> ConvolutionModule::getUsedParameters() const
 {
     // Same style as DatorroModule: param *names* only, no prefix
@@ -51,13 +75,16 @@ std::vector<juce::String> ConvolutionModule::getUsedParameters() const
         "convIrIndex",
         "convIrGain",
         "convLowCut",
-        "convHighCut"
+        "convHighCut",
+        "convTilt",
+        "convTrueStereo"
     };
 }
 
 void ConvolutionModule::setID(juce::String& newID)
 {
     moduleID = newID;
+    updateParameterPointers();
 }
 
 juce::String ConvolutionModule::getID() const
@@ -74,3 +101,28 @@ void ConvolutionModule::setIRBank(std::shared_ptr<IRBank> bank)
 {
     convolutionReverb.setIRBank(bank);
 }
+
+void ConvolutionModule::setInputShare(std::shared_ptr<ConvolutionInputShare> share)
+{
+    convolutionReverb.setInputShare(std::move(share));
+}
+
+void ConvolutionModule::loadIRFile(const juce::File& file)
+{
+    convolutionReverb.loadIR(file);
+}
+
+juce::File ConvolutionModule::getCustomIRFile() const
+{
+    return convolutionReverb.getCustomIRFile();
+}
+
+void ConvolutionModule::setLoadPriority(bool shouldHavePriority)
+{
+    convolutionReverb.setLoadPriority(shouldHavePriority);
+}
+
+bool ConvolutionModule::isLoadPending() const
+{
+    return convolutionReverb.isLoadPending();
+}
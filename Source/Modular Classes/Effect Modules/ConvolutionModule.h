@@ -1,6 +1,11 @@
 #pragma once
 
-#include <JuceHeader.h>
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_processors/juce_audio_processors.h>
+  #include <juce_dsp/juce_dsp.h>
+#endif
 #include "EffectModule.h"
 #include "../../Reverb Algorithms/Convolution/Convolution.h"
 #include "../../Reverb Algorithms/Convolution/IRBank.h"
@@ -22,10 +27,34 @@ public:
     juce::String getType() const override;
     
     void setIRBank(std::shared_ptr<IRBank> bank);
+    void setInputShare(std::shared_ptr<ConvolutionInputShare> share);
+
+    // Custom IR from the user library or a dropped file (message thread)
+    void loadIRFile(const juce::File& file);
+    juce::File getCustomIRFile() const;
+
+    // Load requests of the slot being edited go first
+    void setLoadPriority(bool shouldHavePriority);
+
+    // True while an IR is still being built or waiting to be installed
+    bool isLoadPending() const;
 
 private:
+    // Looked up once per slot ID; building the IDs every block allocates
+    void updateParameterPointers();
+
     juce::String moduleID;
     juce::AudioProcessorValueTreeState& state;
 
+    std::atomic<float>* enabledParam = nullptr;
+    std::atomic<float>* mixParam = nullptr;
+    std::atomic<float>* preDelayParam = nullptr;
+    std::atomic<float>* irIndexParam = nullptr;
+    std::atomic<float>* irGainParam = nullptr;
+    std::atomic<float>* lowCutParam = nullptr;
+    std::atomic<float>* highCutParam = nullptr;
+    std::atomic<float>* tiltParam = nullptr;
+    std::atomic<float>* trueStereoParam = nullptr;
+
     Convolution convolutionReverb;
 };
\ No newline at end of file
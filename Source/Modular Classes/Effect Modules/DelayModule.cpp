@@ -10,6 +10,7 @@
 #include "DelayModule.h"
 DelayModule::DelayModule(const juce::String& id, juce::AudioProcessorValueTreeState& apvts)
     : moduleID(id), state(apvts) {
+    updateParameterPointers();
 }
 
 void DelayModule::prepare(const juce::dsp::ProcessSpec & spec)
@@ -19,54 +20,148 @@ void DelayModule::prepare(const juce::dsp::ProcessSpec & spec)
 
 void DelayModule::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
 {
-    delay.setMix( *state.getRawParameterValue(moduleID + ".mix"));
-    delay.setFeedback( *state.getRawParameterValue(moduleID + ".feedback"));
+    if (enabledParam == nullptr)
+        return;
+
+    applyParameters(delay);
 
     // Update delay parameters
-    bool syncEnabled = state.getRawParameterValue(moduleID + ".delaySyncEnabled")->load() > 0.5f;
+    bool syncEnabled = syncEnabledParam->load() > 0.5f;
+
     if (syncEnabled)
     {
-        float bpm = state.getRawParameterValue(moduleID + ".delayBpm")->load();
+        float bpm = bpmParam->load();
 
         // Use host BPM when available, fall back to manual parameter
-        if (playHead)
-        {
-            if (auto posInfo = playHead->getPosition())
-            {
-                if (auto hostBpm = posInfo->getBpm())
-                    bpm = static_cast<float>(*hostBpm);
-            }
-        }
+        if (transport != nullptr && transport->hasHostTempo)
+            bpm = static_cast<float>(transport->bpm);
+
+        int noteDivision = static_cast<int>(noteDivParam->load());
 
-        int noteDivision = static_cast<int>(state.getRawParameterValue(moduleID + ".delayNoteDiv")->load());
+        if (bpm != lastSyncBpm || noteDivision != lastNoteDivision)
+        {
+            lastSyncBpm = bpm;
+            lastNoteDivision = noteDivision;
 
-        // Quarter note duration in ms, then scale by note division multiplier
-        static const float noteMultipliers[] = {
-            4.0f, 2.0f, 1.0f, 0.5f, 0.25f, 0.125f,           // straight: 1/1 to 1/32
-            3.0f, 1.5f, 0.75f, 0.375f,                         // dotted: 1/2d to 1/16d
-            4.0f / 3.0f, 2.0f / 3.0f, 1.0f / 3.0f, 1.0f / 6.0f // triplet: 1/2t to 1/16t
-        };
+            // Quarter note duration in ms, then scale by note division multiplier
+            float quarterNoteMs = 60000.0f / bpm;
+            syncedTimeMs = juce::jlimit(1.0f, 2000.0f,
+                quarterNoteMs * TransportState::getNoteDivisionMultiplier(noteDivision));
+        }
 
-        float quarterNoteMs = 60000.0f / bpm;
-        float multiplier = (noteDivision >= 0 && noteDivision < 14)
-            ? noteMultipliers[noteDivision] : 1.0f;
-        float syncedTime = juce::jlimit(1.0f, 2000.0f, quarterNoteMs * multiplier);
+        // Tempo and division changes glide; turning sync on jumps, like an
+        // edit of the manual time
+        if (wasSynced)
+            delay.glideToDelayTime(syncedTimeMs);
+        else
+            delay.setDelayTime(syncedTimeMs);
 
-        delay.setDelayTime(syncedTime);
+        currentTimeMs.store(syncedTimeMs, std::memory_order_relaxed);
     }
     else
     {
-        delay.setDelayTime(state.getRawParameterValue(moduleID + ".delayTime")->load());
+        delay.setDelayTime(timeParam->load());
+        currentTimeMs.store(timeParam->load(), std::memory_order_relaxed);
     }
 
-    int modeChoice = static_cast<int>(state.getRawParameterValue(moduleID + ".delayMode")->load());
-    delay.setMode(static_cast<BasicDelay::DelayMode>(modeChoice));
-    delay.setPan(state.getRawParameterValue(moduleID + ".delayPan")->load());
-    delay.setLowpassFreq(state.getRawParameterValue(moduleID + ".delayLowpass")->load());
-    delay.setHighpassFreq(state.getRawParameterValue(moduleID + ".delayHighpass")->load());
+    wasSynced = syncEnabled;
 
-    if (*state.getRawParameterValue(moduleID + ".enabled") == true) { delay.processBlock(buffer); }
+    if (enabledParam->load() > 0.5f) { delay.processBlock(buffer); }
+}
+
+void DelayModule::applyParameters(BasicDelay& target) const
+{
+    target.setMix(mixParam->load());
+    target.setFeedback(feedbackParam->load());
 
+    int modeChoice = static_cast<int>(modeParam->load());
+    target.setMode(static_cast<BasicDelay::DelayMode>(modeChoice));
+
+    target.setPan(panParam->load());
+    target.setLowpassFreq(lowpassParam->load());
+    target.setHighpassFreq(highpassParam->load());
+
+    int interpChoice = static_cast<int>(interpParam->load());
+    target.setWow(wowParam->load());
+    target.setFlutter(flutterParam->load());
+    target.setInterpolation(static_cast<DelayInterpolation>(interpChoice));
+}
+
+namespace
+{
+    class DelayDecaySource : public DecayAnalysis::Source
+    {
+    public:
+        void prepare(const juce::dsp::ProcessSpec& spec) override { delay.prepare(spec); }
+        void process(juce::AudioBuffer<float>& buffer) override   { delay.processBlock(buffer); }
+
+        // The response is silent between echoes
+        double getHoldSeconds() const override { return timeMs * 0.002 + 0.1; }
+
+        BasicDelay delay;
+        float timeMs = 0.0f;
+    };
+}
+
+// Echoes with feedback and the filters in the loop; the analysis sees the
+// delay time the module last ran at, host tempo included
+std::unique_ptr<DecayAnalysis::Source> DelayModule::createDecaySource() const
+{
+    if (enabledParam == nullptr)
+        return nullptr;
+
+    auto source = std::make_unique<DelayDecaySource>();
+
+    // Set before prepare, as in the benchmarks, so the first blocks do not glide
+    applyParameters(source->delay);
+    source->delay.setDelayStorage(delayStorage);
+    source->delay.setMix(1.0f);
+    source->timeMs = getDecayTimeMs();
+    source->delay.setDelayTime(source->timeMs);
+
+    return source;
+}
+
+// With sync on, a tempo change moves the time without touching a parameter
+juce::uint64 DelayModule::getDecayKeyState() const
+{
+    if (enabledParam == nullptr)
+        return 0;
+
+    const float timeMs = getDecayTimeMs();
+    juce::uint32 bits;
+    std::memcpy(&bits, &timeMs, sizeof(bits));
+    return bits;
+}
+
+float DelayModule::getDecayTimeMs() const
+{
+    const float timeMs = currentTimeMs.load(std::memory_order_relaxed);
+    return timeMs > 0.0f ? timeMs : timeParam->load();
+}
+
+void DelayModule::updateParameterPointers()
+{
+    enabledParam     = state.getRawParameterValue(moduleID + ".enabled");
+    mixParam         = state.getRawParameterValue(moduleID + ".mix");
+    feedbackParam    = state.getRawParameterValue(moduleID + ".feedback");
+    syncEnabledParam = state.getRawParameterValue(moduleID + ".delaySyncEnabled");
+    bpmParam         = state.getRawParameterValue(moduleID + ".delayBpm");
+    noteDivParam     = state.getRawParameterValue(moduleID + ".delayNoteDiv");
+    timeParam        = state.getRawParameterValue(moduleID + ".delayTime");
+    modeParam        = state.getRawParameterValue(moduleID + ".delayMode");
+    panParam         = state.getRawParameterValue(moduleID + ".delayPan");
+    lowpassParam     = state.getRawParameterValue(moduleID + ".delayLowpass");
+    highpassParam    = state.getRawParameterValue(moduleID + ".delayHighpass");
+    wowParam         = state.getRawParameterValue(moduleID + ".delayWow");
+    flutterParam     = state.getRawParameterValue(moduleID + ".delayFlutter");
+    interpParam      = state.getRawParameterValue(moduleID + ".delayInterp");
+
+    for (auto* param : { mixParam, feedbackParam, syncEnabledParam, bpmParam, noteDivParam,
+                         timeParam, modeParam, panParam, lowpassParam, highpassParam,
+                         wowParam, flutterParam, interpParam })
+        if (param == nullptr)
+            enabledParam = nullptr;
 }
 
 std::vector<juce::String> DelayModule::getUsedParameters() const
@@ -81,13 +176,20 @@ std::vector<juce::String> DelayModule::getUsedParameters() const
        "delayMode",
        "delayPan",
        "delayLowpass",
-       "delayHighpass"
+       "delayHighpass",
+       "delayWow",
+       "delayFlutter",
+       "delayInterp"
     };
 }
 
-void DelayModule::setID(juce::String& newID) { moduleID = newID; }
+void DelayModule::setID(juce::String& newID)
+{
+    moduleID = newID;
+    updateParameterPointers();
+}
 
-void DelayModule::setPlayHead(juce::AudioPlayHead* playHead) { this->playHead = playHead; }
+void DelayModule::setTransport(const TransportState& newTransport) { transport = &newTransport; }
 
 juce::String DelayModule::getID() const { return moduleID; }
 juce::String DelayModule::getType() const { return "Delay"; }
\ No newline at end of file
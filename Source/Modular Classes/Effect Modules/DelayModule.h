@@ -21,16 +21,61 @@ public:
     void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override;
 
     std::vector<juce::String> getUsedParameters() const override;
+
+    std::unique_ptr<DecayAnalysis::Source> createDecaySource() const override;
+    juce::uint64 getDecayKeyState() const override;
+
+    DelayArena::Report getMemoryReport() const override { return delay.getMemoryReport(); }
+
+    void setDelayStorage(DelayStorage storage) override
+    {
+        delayStorage = storage;
+        delay.setDelayStorage(storage);
+    }
     
     juce::String getID() const override;
     void setID(juce::String& newID) override;
     juce::String getType() const override;
 
-    void setPlayHead(juce::AudioPlayHead *playhead) override;
+    void setTransport(const TransportState& transport) override;
 
 private:
+    // Looked up once per slot ID; building the IDs every block allocates
+    void updateParameterPointers();
+
+    // Everything but the delay time, which depends on sync and the host tempo
+    void applyParameters(BasicDelay& target) const;
+
+    // Time the decay source runs at: the last one processed, else the parameter
+    float getDecayTimeMs() const;
+
     juce::String moduleID;
     juce::AudioProcessorValueTreeState& state;
-    juce::AudioPlayHead *playHead = nullptr;
+    const TransportState* transport = nullptr;
+
+    std::atomic<float>* enabledParam = nullptr;
+    std::atomic<float>* mixParam = nullptr;
+    std::atomic<float>* feedbackParam = nullptr;
+    std::atomic<float>* syncEnabledParam = nullptr;
+    std::atomic<float>* bpmParam = nullptr;
+    std::atomic<float>* noteDivParam = nullptr;
+    std::atomic<float>* timeParam = nullptr;
+    std::atomic<float>* modeParam = nullptr;
+    std::atomic<float>* panParam = nullptr;
+    std::atomic<float>* lowpassParam = nullptr;
+    std::atomic<float>* highpassParam = nullptr;
+    std::atomic<float>* wowParam = nullptr;
+    std::atomic<float>* flutterParam = nullptr;
+    std::atomic<float>* interpParam = nullptr;
     BasicDelay delay;
+    DelayStorage delayStorage = DelayStorage::Float32;
+
+    // Synced time is only recomputed when tempo or division change
+    float lastSyncBpm = 0.0f;
+    int lastNoteDivision = -1;
+    float syncedTimeMs = 250.0f;
+    bool wasSynced = false;
+
+    // Last time handed to the delay, for createDecaySource (0 = not yet processed)
+    std::atomic<float> currentTimeMs { 0.0f };
 };
\ No newline at end of file
@@ -25,6 +25,9 @@
   #include <juce_gui_extra/juce_gui_extra.h>
 #endif
 
+#include "../TransportState.h"
+#include "../../Reverb Algorithms/DecayAnalysis.h"
+#include "../../Reverb Algorithms/CustomDelays.h"   // DelayStorage, DelayArena
 
 class EffectModule
 {
@@ -36,8 +39,31 @@ public:
 
     virtual juce::String getType() const = 0;
     virtual juce::String getID() const = 0;
+
+    // Modules look up their slot's parameters once here, not per block. A
+    // module starts with the placeholder ID "null", which has no parameters,
+    // so it keeps the one pointer its process() tests null until every
+    // lookup succeeds, and does nothing until then.
     virtual void setID(juce::String& newID) = 0;
-    virtual void setPlayHead(juce::AudioPlayHead* playhead) {}
+
+    // Shared host transport, valid for the current process() call
+    virtual void setTransport(const TransportState& transport) {}
 
     virtual std::vector<juce::String> getUsedParameters() const = 0;
+
+    // Message thread: a fresh copy of the module's DSP with its current
+    // settings, fully wet, for the decay analyser; nullptr if not supported
+    virtual std::unique_ptr<DecayAnalysis::Source> createDecaySource() const { return nullptr; }
+
+    // Message thread: anything createDecaySource() depends on that the slot's
+    // parameters do not show (a tempo-synced delay time), folded into the
+    // analysis cache key
+    virtual juce::uint64 getDecayKeyState() const { return 0; }
+
+    // Message thread: memory held by the module's delay lines and states
+    virtual DelayArena::Report getMemoryReport() const { return {}; }
+
+    // Message thread, before prepare(): sample format of the module's long
+    // delay lines, for it and its decay sources
+    virtual void setDelayStorage(DelayStorage) {}
 };
\ No newline at end of file
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    MultiTapModule.cpp
+    Effect module for the multi-tap delay
+
+  ==============================================================================
+*/
+
+#include "MultiTapModule.h"
+
+MultiTapModule::MultiTapModule(const juce::String& id, juce::AudioProcessorValueTreeState& apvts)
+    : moduleID(id), state(apvts)
+{
+    updateParameterPointers();
+}
+
+void MultiTapModule::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    delay.prepare(spec);
+}
+
+void MultiTapModule::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+{
+    juce::ignoreUnused(midi);
+
+    if (mixParam == nullptr)
+        return;
+
+    delay.setMix(mixParam->load());
+    delay.setFeedback(feedbackParam->load());
+
+    const int numTaps = juce::jlimit(1, kNumTaps, (int) tapCountParam->load());
+    delay.setNumTaps(numTaps);
+
+    for (int t = 0; t < numTaps; ++t)
+    {
+        const auto& tap = tapParams[t];
+        delay.setTap(t, tap.time->load(), tap.gain->load(), tap.pan->load(), tap.lowpass->load());
+    }
+
+    if (enabledParam->load() > 0.5f)
+        delay.processBlock(buffer);
+}
+
+juce::String MultiTapModule::tapParameter(int tapIndex, const juce::String& field)
+{
+    return "tap" + juce::String(tapIndex + 1) + field;
+}
+
+void MultiTapModule::updateParameterPointers()
+{
+    enabledParam  = state.getRawParameterValue(moduleID + ".enabled");
+    mixParam      = state.getRawParameterValue(moduleID + ".mix");
+    feedbackParam = state.getRawParameterValue(moduleID + ".feedback");
+    tapCountParam = state.getRawParameterValue(moduleID + ".tapCount");
+
+    for (int t = 0; t < kNumTaps; ++t)
+    {
+        auto& tap = tapParams[t];
+        tap.time    = state.getRawParameterValue(moduleID + "." + tapParameter(t, "Time"));
+        tap.gain    = state.getRawParameterValue(moduleID + "." + tapParameter(t, "Gain"));
+        tap.pan     = state.getRawParameterValue(moduleID + "." + tapParameter(t, "Pan"));
+        tap.lowpass = state.getRawParameterValue(moduleID + "." + tapParameter(t, "Lowpass"));
+
+        if (tap.time == nullptr || tap.gain == nullptr || tap.pan == nullptr || tap.lowpass == nullptr)
+            mixParam = nullptr;
+    }
+
+    for (auto* param : { enabledParam, feedbackParam, tapCountParam })
+        if (param == nullptr)
+            mixParam = nullptr;
+}
+
+std::vector<juce::String> MultiTapModule::getUsedParameters() const
+{
+    std::vector<juce::String> params {
+        "mix",
+        "feedback",
+        "tapCount"
+    };
+
+    for (int t = 0; t < kNumTaps; ++t)
+    {
+        params.push_back(tapParameter(t, "Time"));
+        params.push_back(tapParameter(t, "Gain"));
+        params.push_back(tapParameter(t, "Pan"));
+        params.push_back(tapParameter(t, "Lowpass"));
+    }
+
+    return params;
+}
+
+void MultiTapModule::setID(juce::String& newID)
+{
+    moduleID = newID;
+    updateParameterPointers();
+}
+
+juce::String MultiTapModule::getID() const { return moduleID; }
+juce::String MultiTapModule::getType() const { return "Multi-Tap"; }
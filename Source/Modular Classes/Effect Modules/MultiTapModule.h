@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    MultiTapModule.h
+    Effect module for the multi-tap delay
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "EffectModule.h"
+#include "../../Reverb Algorithms/Delay/MultiTapDelay.h"
+
+class MultiTapModule : public EffectModule
+{
+public:
+    MultiTapModule(const juce::String& id, juce::AudioProcessorValueTreeState& apvts);
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override;
+
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override;
+
+    std::vector<juce::String> getUsedParameters() const override;
+
+    DelayArena::Report getMemoryReport() const override { return delay.getMemoryReport(); }
+
+    void setDelayStorage(DelayStorage storage) override { delay.setDelayStorage(storage); }
+
+    juce::String getID() const override;
+    void setID(juce::String& newID) override;
+    juce::String getType() const override;
+
+    // Parameter ID suffix of one tap's field, e.g. tapParameter(2, "Time") -> "tap3Time"
+    static juce::String tapParameter(int tapIndex, const juce::String& field);
+
+    // Taps a slot exposes as parameters. Every slot carries every module's
+    // parameters, so each tap here adds 4 to all 16 slots; the engine itself
+    // takes up to MultiTapDelay::kMaxTaps.
+    static constexpr int kNumTaps = 8;
+
+private:
+    // 4 values per tap would be 32 string lookups per block, so the
+    // parameter pointers are looked up once per slot ID
+    struct TapParameters
+    {
+        std::atomic<float>* time = nullptr;
+        std::atomic<float>* gain = nullptr;
+        std::atomic<float>* pan = nullptr;
+        std::atomic<float>* lowpass = nullptr;
+    };
+
+    void updateParameterPointers();
+
+    juce::String moduleID;
+    juce::AudioProcessorValueTreeState& state;
+
+    std::atomic<float>* enabledParam = nullptr;
+    std::atomic<float>* mixParam = nullptr;
+    std::atomic<float>* feedbackParam = nullptr;
+    std::atomic<float>* tapCountParam = nullptr;
+    TapParameters tapParams[kNumTaps];
+
+    MultiTapDelay delay;
+};
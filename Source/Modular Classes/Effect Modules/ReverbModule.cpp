@@ -10,6 +10,7 @@
 #include "ReverbModule.h"
 ReverbModule::ReverbModule(const juce::String& id, juce::AudioProcessorValueTreeState& apvts)
     : moduleID(id), state(apvts) {
+    updateParameterPointers();
 }
 
 void ReverbModule::prepare(const juce::dsp::ProcessSpec& spec)
@@ -20,22 +21,17 @@ void ReverbModule::prepare(const juce::dsp::ProcessSpec& spec)
 
 void ReverbModule::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
 {
-    ReverbProcessorParameters params;
-    params.mix = state.getRawParameterValue(moduleID + ".mix")->load();
-    params.roomSize = state.getRawParameterValue(moduleID + ".roomSize")->load();
-    params.decayTime = state.getRawParameterValue(moduleID + ".decayTime")->load();
-    params.damping = state.getRawParameterValue(moduleID + ".damping")->load();
-    params.modRate = state.getRawParameterValue(moduleID + ".modRate")->load();
-    params.modDepth = state.getRawParameterValue(moduleID + ".modDepth")->load();
-    params.preDelay = state.getRawParameterValue(moduleID + ".preDelay")->load();
-    
+    if (enabledParam == nullptr)
+        return;
+
+    const auto params = getParameters();
 
     datorroReverb.setParameters(params);
     hybridPlateReverb.setParameters(params);
 
-    if (*state.getRawParameterValue(moduleID + ".enabled") == true) 
+    if (enabledParam->load() > 0.5f)
     { 
-        if (static_cast<int>(state.getRawParameterValue(moduleID + ".reverbType")->load()) == 0)
+        if (static_cast<int>(typeParam->load()) == 0)
         {
             datorroReverb.processBlock(buffer, midi);
         }
@@ -47,6 +43,97 @@ void ReverbModule::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& m
 
 }
 
+ReverbProcessorParameters ReverbModule::getParameters() const
+{
+    ReverbProcessorParameters params;
+    params.mix = mixParam->load();
+    params.roomSize = roomSizeParam->load();
+    params.decayTime = decayTimeParam->load();
+    params.damping = dampingParam->load();
+    params.modRate = modRateParam->load();
+    params.modDepth = modDepthParam->load();
+    params.preDelay = preDelayParam->load();
+    return params;
+}
+
+namespace
+{
+    // Whichever algorithm the module runs, with the module's settings
+    class ReverbDecaySource : public DecayAnalysis::Source
+    {
+    public:
+        ReverbDecaySource(bool usePlate, const ReverbProcessorParameters& p, DelayStorage storage)
+            : params(p)
+        {
+            if (usePlate)
+                reverb = std::make_unique<HybridPlate>();
+            else
+                reverb = std::make_unique<DatorroHall>();
+
+            reverb->setDelayStorage(storage);
+            params.mix = 1.0f;
+        }
+
+        void prepare(const juce::dsp::ProcessSpec& spec) override
+        {
+            reverb->prepare(spec);
+            reverb->setParameters(params);
+        }
+
+        void process(juce::AudioBuffer<float>& buffer) override
+        {
+            reverb->setParameters(params);
+            reverb->processBlock(buffer, midi);
+        }
+
+    private:
+        std::unique_ptr<ReverbProcessorBase> reverb;
+        ReverbProcessorParameters params;
+        juce::MidiBuffer midi;
+    };
+}
+
+std::unique_ptr<DecayAnalysis::Source> ReverbModule::createDecaySource() const
+{
+    if (enabledParam == nullptr)
+        return nullptr;
+
+    return std::make_unique<ReverbDecaySource>(static_cast<int>(typeParam->load()) != 0, getParameters(), delayStorage);
+}
+
+// Both algorithms stay prepared, so switching type never allocates
+DelayArena::Report ReverbModule::getMemoryReport() const
+{
+    auto report = datorroReverb.getMemoryReport();
+    report.add(hybridPlateReverb.getMemoryReport());
+    return report;
+}
+
+void ReverbModule::setDelayStorage(DelayStorage storage)
+{
+    delayStorage = storage;
+    datorroReverb.setDelayStorage(storage);
+    hybridPlateReverb.setDelayStorage(storage);
+}
+
+void ReverbModule::updateParameterPointers()
+{
+    enabledParam   = state.getRawParameterValue(moduleID + ".enabled");
+    mixParam       = state.getRawParameterValue(moduleID + ".mix");
+    typeParam      = state.getRawParameterValue(moduleID + ".reverbType");
+    roomSizeParam  = state.getRawParameterValue(moduleID + ".roomSize");
+    decayTimeParam = state.getRawParameterValue(moduleID + ".decayTime");
+    dampingParam   = state.getRawParameterValue(moduleID + ".damping");
+    modRateParam   = state.getRawParameterValue(moduleID + ".modRate");
+    modDepthParam  = state.getRawParameterValue(moduleID + ".modDepth");
+    preDelayParam  = state.getRawParameterValue(moduleID + ".preDelay");
+
+    for (auto* param : { mixParam, typeParam, roomSizeParam, decayTimeParam,
+                         dampingParam, modRateParam, modDepthParam, preDelayParam })
+        if (param == nullptr)
+            enabledParam = nullptr;
+}
+
 std::vector<juce::String> ReverbModule::getUsedParameters() const
 {
     return {
@@ -61,7 +148,11 @@ std::vector<juce::String> ReverbModule::getUsedParameters() const
     };
 }
 
-void ReverbModule::setID(juce::String& newID) { moduleID = newID; }
+void ReverbModule::setID(juce::String& newID)
+{
+    moduleID = newID;
+    updateParameterPointers();
+}
 
 juce::String ReverbModule::getID() const { return moduleID; }
 juce::String ReverbModule::getType() const { return "Reverb"; }
\ No newline at end of file
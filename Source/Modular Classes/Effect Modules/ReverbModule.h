@@ -23,13 +23,36 @@ public:
 
     std::vector<juce::String> getUsedParameters() const override;
 
+    std::unique_ptr<DecayAnalysis::Source> createDecaySource() const override;
+
+    DelayArena::Report getMemoryReport() const override;
+
+    void setDelayStorage(DelayStorage storage) override;
+
     juce::String getID() const override;
     void setID(juce::String& newID) override;
     juce::String getType() const override;
 
 private:
+    // Looked up once per slot ID; building the IDs every block allocates
+    void updateParameterPointers();
+
+    ReverbProcessorParameters getParameters() const;
+
     juce::String moduleID;
     juce::AudioProcessorValueTreeState& state;
+
+    std::atomic<float>* enabledParam = nullptr;
+    std::atomic<float>* mixParam = nullptr;
+    std::atomic<float>* typeParam = nullptr;
+    std::atomic<float>* roomSizeParam = nullptr;
+    std::atomic<float>* decayTimeParam = nullptr;
+    std::atomic<float>* dampingParam = nullptr;
+    std::atomic<float>* modRateParam = nullptr;
+    std::atomic<float>* modDepthParam = nullptr;
+    std::atomic<float>* preDelayParam = nullptr;
+
     DatorroHall datorroReverb;
     HybridPlate hybridPlateReverb;
+    DelayStorage delayStorage = DelayStorage::Float32;
 };
\ No newline at end of file
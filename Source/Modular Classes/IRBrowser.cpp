@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+    IRBrowser.cpp
+  ==============================================================================
+*/
+
+#include "IRBrowser.h"
+
+IRBrowser::IRBrowser()
+{
+    addAndMakeVisible(list);
+    list.setRowHeight(20);
+
+    addAndMakeVisible(addFolderButton);
+    addFolderButton.onClick = [this]
+        {
+            folderChooser = std::make_unique<juce::FileChooser>(
+                "Add IR Folder",
+                juce::File::getSpecialLocation(juce::File::userHomeDirectory));
+
+            folderChooser->launchAsync(
+                juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories,
+                [this](const juce::FileChooser& chooser)
+                {
+                    auto folder = chooser.getResult();
+
+                    if (folder.isDirectory())
+                        library->addFolder(folder);
+                });
+        };
+
+    addAndMakeVisible(rescanButton);
+    rescanButton.onClick = [this] { library->rescan(); };
+
+    addAndMakeVisible(statusLabel);
+    statusLabel.setJustificationType(juce::Justification::centredLeft);
+
+    library->addChangeListener(this);
+    updateStatus();
+
+    setSize(320, 360);
+}
+
+IRBrowser::~IRBrowser()
+{
+    library->removeChangeListener(this);
+}
+
+void IRBrowser::resized()
+{
+    auto r = getLocalBounds().reduced(6);
+
+    auto buttons = r.removeFromTop(25);
+    addFolderButton.setBounds(buttons.removeFromLeft(100));
+    buttons.removeFromLeft(5);
+    rescanButton.setBounds(buttons.removeFromLeft(70));
+
+    statusLabel.setBounds(r.removeFromBottom(20));
+
+    r.removeFromTop(5);
+    list.setBounds(r);
+}
+
+//==============================================================================
+int IRBrowser::getNumRows()
+{
+    return library->getNumEntries();
+}
+
+void IRBrowser::paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+    if (rowIsSelected)
+        g.fillAll(findColour(juce::TextEditor::highlightColourId));
+
+    g.setColour(findColour(juce::ListBox::textColourId));
+    g.drawText(library->getEntry(row).name, 4, 0, width - 8, height,
+               juce::Justification::centredLeft, true);
+}
+
+void IRBrowser::listBoxItemDoubleClicked(int row, const juce::MouseEvent&)
+{
+    chooseRow(row);
+}
+
+void IRBrowser::returnKeyPressed(int lastRowSelected)
+{
+    chooseRow(lastRowSelected);
+}
+
+void IRBrowser::chooseRow(int row)
+{
+    auto entry = library->getEntry(row);
+
+    if (entry.file.existsAsFile() && onIRChosen)
+        onIRChosen(entry.file);
+}
+
+//==============================================================================
+void IRBrowser::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    // Only the row count changes; the ListBox repaints the visible rows
+    list.updateContent();
+    list.repaint();
+    updateStatus();
+}
+
+void IRBrowser::updateStatus()
+{
+    const auto count = juce::String(library->getNumEntries()) + " IRs";
+
+    if (library->isScanning())
+        statusLabel.setText("Scanning... " + count, juce::dontSendNotification);
+    else if (library->getFolders().isEmpty())
+        statusLabel.setText("Add a folder of IRs, or drop a file on the slot", juce::dontSendNotification);
+    else
+        statusLabel.setText(count, juce::dontSendNotification);
+}
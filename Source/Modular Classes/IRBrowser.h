@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+    IRBrowser.h - List of the user's IR library
+
+    Rows are fetched from IRLibrary only when the ListBox paints them, so the
+    cost stays proportional to the visible rows however large the library is.
+  ==============================================================================
+*/
+
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_audio_formats/juce_audio_formats.h>
+  #include <juce_core/juce_core.h>
+  #include <juce_events/juce_events.h>
+  #include <juce_graphics/juce_graphics.h>
+  #include <juce_gui_basics/juce_gui_basics.h>
+#endif
+
+#include "../Reverb Algorithms/Convolution/IRLibrary.h"
+
+class IRBrowser : public juce::Component,
+                  private juce::ListBoxModel,
+                  private juce::ChangeListener
+{
+public:
+    IRBrowser();
+    ~IRBrowser() override;
+
+    // Called with the file the user picked (double click or return key)
+    std::function<void(const juce::File&)> onIRChosen;
+
+    void resized() override;
+
+private:
+    // ListBoxModel
+    int getNumRows() override;
+    void paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override;
+    void returnKeyPressed(int lastRowSelected) override;
+
+    // ChangeListener (library scan progress)
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+
+    void chooseRow(int row);
+    void updateStatus();
+
+    juce::SharedResourcePointer<IRLibrary> library;
+
+    juce::ListBox list{ "IR Library", this };
+    juce::TextButton addFolderButton{ "Add Folder..." };
+    juce::TextButton rescanButton{ "Rescan" };
+    juce::Label statusLabel;
+
+    std::unique_ptr<juce::FileChooser> folderChooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IRBrowser)
+};
@@ -0,0 +1,312 @@
+/*
+  ==============================================================================
+
+    LevelMeters.h
+    Peak/RMS of every slot's and chain's output, and a coarse spectrum of
+    each chain, measured on the audio thread for the editor's meters.
+
+  ==============================================================================
+*/
+
+#pragma once
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"  // for Projucer
+#else // for Cmake
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_core/juce_core.h>
+  #include <juce_dsp/juce_dsp.h>
+#endif
+
+#include "../DSPKernels.h"
+
+// Same shape as CpuProfiler: the audio thread fills one Frame per callback and
+// pushes it through a wait-free single-producer/single-consumer FIFO, and the
+// message thread drains it in update(). Nothing is measured unless a viewer
+// is registered, so a closed editor costs one atomic load per callback.
+//
+// Levels are one vectorised pass per channel (DSPKernels::measure). The
+// spectrum is decimated twice over: one FFT per fftSize samples rather than
+// per block, reduced to numBands log-spaced bands, and only while a spectrum
+// viewer is registered as well.
+template <int NumChains, int NumSlots>
+class LevelMeters
+{
+public:
+    static constexpr int numBands = 32;
+    static constexpr float floorDb = -90.0f;
+
+    // Linear gain per channel; mono inputs show the same value on both
+    struct Levels
+    {
+        float peak[2] {};
+        float rms[2] {};
+    };
+
+    struct Spectrum
+    {
+        float bandDb[numBands];
+
+        Spectrum() { std::fill(std::begin(bandDb), std::end(bandDb), floorDb); }
+    };
+
+    LevelMeters()
+        : fft(fftOrder), window((size_t) fftSize, juce::dsp::WindowingFunction<float>::hann, false)
+    {
+    }
+
+    //==============================================================================
+    // Message thread: meters register while they are on screen
+
+    void addViewer()            { viewers.fetch_add(1, std::memory_order_relaxed); }
+    void removeViewer()         { viewers.fetch_sub(1, std::memory_order_relaxed); }
+
+    void addSpectrumViewer()    { spectrumViewers.fetch_add(1, std::memory_order_relaxed); }
+    void removeSpectrumViewer() { spectrumViewers.fetch_sub(1, std::memory_order_relaxed); }
+
+    // Band edges follow the sample rate; called from prepareToPlay
+    void prepare(double sampleRate)
+    {
+        const double nyquist = sampleRate * 0.5;
+        const double lowest = 20.0;
+
+        for (int b = 0; b <= numBands; ++b)
+        {
+            const double hz = lowest * std::pow(nyquist / lowest, (double) b / numBands);
+            bandEdges[b] = juce::jlimit(1, fftSize / 2, (int) std::round(hz * fftSize / sampleRate));
+        }
+
+        for (int c = 0; c < NumChains; ++c)
+            spectrumFill[c] = 0;
+    }
+
+    //==============================================================================
+    // Audio thread
+
+    bool isActive() const { return viewers.load(std::memory_order_relaxed) > 0; }
+
+    void beginCallback(int numSamples)
+    {
+        frame = {};
+        frame.numSamples = numSamples;
+        analysing = spectrumViewers.load(std::memory_order_relaxed) > 0;
+    }
+
+    void measureSlot(int chainIndex, int slotIndex, const juce::AudioBuffer<float>& buffer,
+                     int numChannels, int numSamples)
+    {
+        measure(frame.slots[chainIndex][slotIndex], buffer, numChannels, numSamples);
+    }
+
+    // Chain output after its mix and gain; also feeds the chain's spectrum
+    void measureChain(int chainIndex, const juce::AudioBuffer<float>& buffer,
+                      int numChannels, int numSamples)
+    {
+        measure(frame.chains[chainIndex], buffer, numChannels, numSamples);
+
+        if (analysing)
+            analyse(chainIndex, buffer, numChannels, numSamples);
+        else
+            spectrumFill[chainIndex] = 0;
+    }
+
+    // Drops the frame if the editor has fallen behind
+    void endCallback()
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0)
+            frames[(size_t) scope.startIndex1] = frame;
+    }
+
+    //==============================================================================
+    // Message thread
+
+    // Drains the FIFO and moves the meters: peaks and bands jump up and fall
+    // back slowly, RMS is the energy average over the drained callbacks
+    void update()
+    {
+        Sum slotSums[NumChains][NumSlots];
+        Sum chainSums[NumChains];
+        juce::int64 numSamples = 0;
+
+        while (fifo.getNumReady() > 0)
+        {
+            const auto scope = fifo.read(1);
+            const auto& f = frames[(size_t) scope.startIndex1];
+
+            for (int c = 0; c < NumChains; ++c)
+            {
+                for (int s = 0; s < NumSlots; ++s)
+                    slotSums[c][s].add(f.slots[c][s]);
+
+                chainSums[c].add(f.chains[c]);
+
+                if (f.hasSpectrum[c])
+                    for (int b = 0; b < numBands; ++b)
+                        spectrumPeaks[c].bandDb[b] = juce::jmax(spectrumPeaks[c].bandDb[b], f.spectra[c][b]);
+            }
+
+            numSamples += f.numSamples;
+        }
+
+        for (int c = 0; c < NumChains; ++c)
+        {
+            for (int s = 0; s < NumSlots; ++s)
+                slotSums[c][s].settle(slotLevels[c][s], numSamples);
+
+            chainSums[c].settle(chainLevels[c], numSamples);
+
+            for (int b = 0; b < numBands; ++b)
+            {
+                auto& shown = spectra[c].bandDb[b];
+                shown = juce::jmax(spectrumPeaks[c].bandDb[b], shown - bandFalloffDb, floorDb);
+                spectrumPeaks[c].bandDb[b] = floorDb;
+            }
+        }
+    }
+
+    // Forget a slot's levels, e.g. after its module changed
+    void resetSlot(int chainIndex, int slotIndex)
+    {
+        slotLevels[chainIndex][slotIndex] = {};
+    }
+
+    const Levels& getSlotLevels(int chainIndex, int slotIndex) const { return slotLevels[chainIndex][slotIndex]; }
+    const Levels& getChainLevels(int chainIndex) const               { return chainLevels[chainIndex]; }
+    const Spectrum& getChainSpectrum(int chainIndex) const           { return spectra[chainIndex]; }
+
+private:
+    static constexpr int fftOrder = 10;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int fifoSize = 128;           // ~0.7 s of 256-sample blocks at 44.1 kHz
+    static constexpr float peakFalloff = 0.9f;     // per update, ~-27 dB/s at 30 Hz
+    static constexpr float bandFalloffDb = 1.0f;   // per update
+
+    // One callback's worth of a meter: the kernel's raw output
+    struct Block
+    {
+        float peak[2] {};
+        float sumOfSquares[2] {};
+    };
+
+    struct Frame
+    {
+        Block slots[NumChains][NumSlots];
+        Block chains[NumChains];
+        int numSamples = 0;
+
+        float spectra[NumChains][numBands] {};
+        bool hasSpectrum[NumChains] {};
+    };
+
+    // Several frames of one meter, folded together in update()
+    struct Sum
+    {
+        void add(const Block& b)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                peak[ch] = juce::jmax(peak[ch], b.peak[ch]);
+                sumOfSquares[ch] += b.sumOfSquares[ch];
+            }
+        }
+
+        void settle(Levels& levels, juce::int64 numSamples) const
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                levels.peak[ch] = juce::jmax(peak[ch], levels.peak[ch] * peakFalloff);
+                levels.rms[ch] = numSamples > 0 ? (float) std::sqrt(sumOfSquares[ch] / (double) numSamples)
+                                                : levels.rms[ch] * peakFalloff;
+            }
+        }
+
+        float peak[2] {};
+        double sumOfSquares[2] {};
+    };
+
+    static void measure(Block& dest, const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples)
+    {
+        const auto& kernels = DSPKernels::get();
+
+        for (int ch = 0; ch < juce::jmin(numChannels, 2); ++ch)
+            kernels.measure(buffer.getReadPointer(ch), numSamples, dest.peak[ch], dest.sumOfSquares[ch]);
+
+        if (numChannels == 1)
+        {
+            dest.peak[1] = dest.peak[0];
+            dest.sumOfSquares[1] = dest.sumOfSquares[0];
+        }
+    }
+
+    // Collects the channel average; every fftSize samples, one windowed FFT
+    // reduced to band maxima (dB re a full-scale sine)
+    void analyse(int chainIndex, const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples)
+    {
+        auto& input = spectrumInput[chainIndex];
+        int& fill = spectrumFill[chainIndex];
+        const float channelGain = 1.0f / (float) juce::jmax(1, numChannels);
+
+        for (int i = 0; i < numSamples;)
+        {
+            const int n = juce::jmin(numSamples - i, fftSize - fill);
+
+            juce::FloatVectorOperations::copyWithMultiply(input.data() + fill, buffer.getReadPointer(0) + i,
+                                                          channelGain, n);
+
+            for (int ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(input.data() + fill, buffer.getReadPointer(ch) + i,
+                                                             channelGain, n);
+
+            fill += n;
+            i += n;
+
+            if (fill < fftSize)
+                break;
+
+            fill = 0;
+
+            std::copy(input.begin(), input.end(), fftData.begin());
+            window.multiplyWithWindowingTable(fftData.data(), (size_t) fftSize);
+            fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+            // A Hann-windowed full-scale sine peaks at fftSize / 4
+            const float scale = 4.0f / (float) fftSize;
+
+            for (int b = 0; b < numBands; ++b)
+            {
+                const int first = bandEdges[b];
+                const int last = juce::jmax(first + 1, bandEdges[b + 1]);
+                const float magnitude = *std::max_element(fftData.begin() + first, fftData.begin() + last);
+
+                frame.spectra[chainIndex][b] = juce::Decibels::gainToDecibels(magnitude * scale, floorDb);
+            }
+
+            frame.hasSpectrum[chainIndex] = true;
+        }
+    }
+
+    std::atomic<int> viewers { 0 };
+    std::atomic<int> spectrumViewers { 0 };
+
+    // Audio thread
+    Frame frame;
+    bool analysing = false;
+
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    int bandEdges[numBands + 1] {};
+    std::array<float, fftSize> spectrumInput[NumChains] {};
+    int spectrumFill[NumChains] {};
+    std::array<float, 2 * fftSize> fftData {};
+
+    // Audio -> message thread
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Frame, fifoSize> frames;
+
+    // Message thread
+    Levels slotLevels[NumChains][NumSlots];
+    Levels chainLevels[NumChains];
+    Spectrum spectra[NumChains];
+    Spectrum spectrumPeaks[NumChains];
+};
@@ -43,11 +43,11 @@ public:
             m->prepare(spec);
     }
 
-    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi, juce::AudioPlayHead* playHead)
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi, const TransportState& transport)
     {
         if (auto* m = activeModule.load(std::memory_order_acquire))
         {
-            m->setPlayHead(playHead);
+            m->setTransport(transport);
             m->process(buffer, midi);
         }
 
@@ -65,6 +65,7 @@ public:
         // Keep old module alive until after swap
         pendingDeletion = std::move(ownedModule);
         ownedModule = std::move(newModule);
+        moduleSerial = ++lastModuleSerial;
 
         // Atomic pointer swap (audio thread safe)
         activeModule.store(ownedModule.get(), std::memory_order_release);
@@ -83,6 +84,13 @@ public:
 
     EffectModule* get() { return ownedModule.get(); }
 
+    // Audio thread: whether process() currently runs a module
+    bool hasModule() const { return activeModule.load(std::memory_order_acquire) != nullptr; }
+
+    // Unique per installed module, unlike its address, which the allocator
+    // may hand out again; lets the editor tell a kept module from a new one
+    int getModuleSerial() const { return moduleSerial; }
+
     juce::String slotID;
     bool bypassed = false;
 
@@ -93,4 +101,7 @@ private:
     std::unique_ptr<EffectModule> pendingDeletion;
 
     std::atomic<EffectModule*> activeModule{ nullptr };
+
+    int moduleSerial = 0;
+    static inline int lastModuleSerial = 0;     // message thread only
 };
\ No newline at end of file
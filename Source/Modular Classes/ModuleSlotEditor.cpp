@@ -13,8 +13,11 @@ ModuleSlotEditor::ModuleSlotEditor(
     juce::AudioProcessorValueTreeState& apvts)
     : chainIndex(cIndex), slotIndex(sIndex),
     slotID(info.slotID),
+    moduleSerial(info.moduleSerial),
     processor(p)
 {
+    isConvolution = (info.moduleType == "Convolution");
+
     //Module Title
     title.setText(info.moduleType, juce::dontSendNotification);
     addAndMakeVisible(title);
@@ -24,6 +27,7 @@ ModuleSlotEditor::ModuleSlotEditor(
     typeSelector.addItem("Delay", 1);
     typeSelector.addItem("Reverb", 2);
     typeSelector.addItem("Convolution", 3);
+    typeSelector.addItem("Multi-Tap", 4);
 
     if (info.moduleType == "Delay")
     {
@@ -37,17 +41,37 @@ ModuleSlotEditor::ModuleSlotEditor(
     {
         typeSelector.setSelectedId(3, juce::dontSendNotification);
     }
+    else if (info.moduleType == "Multi-Tap")
+    {
+        typeSelector.setSelectedId(4, juce::dontSendNotification);
+    }
 
     typeSelector.onChange = [this] 
     { 
         processor.changeModuleType(chainIndex, slotIndex, static_cast<ModuleType>(typeSelector.getSelectedId()));
+        processor.getCpuProfiler().resetSlot(chainIndex, slotIndex);
+        processor.getLevelMeters().resetSlot(chainIndex, slotIndex);
     };
 
+    //Module CPU meter (shown by the editor's CPU toggle)
+    addChildComponent(cpuMeter);
+
+    //Module output level
+    addAndMakeVisible(levelMeter);
+
+    //Module decay (shown once analysed)
+    addChildComponent(decayView);
+
     //Module Enabled
     addAndMakeVisible(enableToggle);
     enableToggleAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         apvts, slotID + ".enabled", enableToggle);
 
+    //Module Controls scroll sideways when they don't fit (multi-tap has dozens)
+    addAndMakeVisible(controlsViewport);
+    controlsViewport.setViewedComponent(&controlsContainer, false);
+    controlsViewport.setScrollBarsShown(false, true);
+
     //Module Control Sliders (and ComboBoxes for special params)
     auto usedParams = info.usedParameters;
     for (const auto& suffix : usedParams)
@@ -91,14 +115,14 @@ void ModuleSlotEditor::addSliderForParameter(juce::String id)
     slider->setTextBoxStyle(
         juce::Slider::TextBoxBelow, false, 50, 18);
 
-    addAndMakeVisible(*slider);
+    controlsContainer.addAndMakeVisible(*slider);
 
     //Add Slider Label
     auto sliderLabel = std::make_unique<juce::Label>();
     sliderLabel->setText(processor.apvts.getParameter(id)->getName(128), juce::dontSendNotification);
     sliderLabel->setJustificationType(juce::Justification::centred);
 
-    addAndMakeVisible(*sliderLabel);
+    controlsContainer.addAndMakeVisible(*sliderLabel);
 
     //Attach Slider to APVTS
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sliderAttachment =
@@ -118,13 +142,13 @@ void ModuleSlotEditor::addToggleForParameter(const juce::String id)
 {
     auto toggle = std::make_unique<juce::ToggleButton>();
 
-    addAndMakeVisible(*toggle);
+    controlsContainer.addAndMakeVisible(*toggle);
 
     auto label = std::make_unique<juce::Label>();
     label->setText(processor.apvts.getParameter(id)->getName(128),
         juce::dontSendNotification);
     label->setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(*label);
+    controlsContainer.addAndMakeVisible(*label);
 
     auto attachment =
         std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
@@ -148,12 +172,12 @@ void ModuleSlotEditor::addChoiceForParameter(const juce::String id)
     for (int i = 0; i < choiceParam->choices.size(); ++i)
         combo->addItem(choiceParam->choices[i], i + 1);
 
-    addAndMakeVisible(*combo);
+    controlsContainer.addAndMakeVisible(*combo);
 
     auto label = std::make_unique<juce::Label>();
     label->setText(choiceParam->getName(128), juce::dontSendNotification);
     label->setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(*label);
+    controlsContainer.addAndMakeVisible(*label);
 
     auto attachment =
         std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
@@ -200,13 +224,28 @@ void ModuleSlotEditor::addIRSelectorForParameter(juce::String id)
         }
     };
     
-    addAndMakeVisible(*irSelector);
+    controlsContainer.addAndMakeVisible(*irSelector);
     
+    // Browse button for the user IR library (shows the custom IR when one is loaded)
+    auto browseButton = std::make_unique<juce::TextButton>("Browse...");
+    auto customIR = processor.getCustomIRFile(chainIndex, slotIndex);
+
+    if (customIR != juce::File())
+        browseButton->setButtonText(customIR.getFileNameWithoutExtension());
+
+    browseButton->onClick = [this, buttonPtr = browseButton.get()]
+    {
+        showIRBrowser(*buttonPtr);
+    };
+
+    controlsContainer.addAndMakeVisible(*browseButton);
+    irBrowseButtons.push_back(std::move(browseButton));
+
     // Add Label
     auto label = std::make_unique<juce::Label>();
     label->setText("IR", juce::dontSendNotification);
     label->setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(*label);
+    controlsContainer.addAndMakeVisible(*label);
     
     // Store in vectors
     irSelectors.push_back(std::move(irSelector));
@@ -220,12 +259,35 @@ void ModuleSlotEditor::resized()
     auto titleArea = r.removeFromTop(20);
     enableToggle.setBounds(titleArea.removeFromLeft(25));
     title.setBounds(titleArea.removeFromLeft(80));
+
+    if (cpuMeter.isVisible())
+    {
+        cpuMeter.setBounds(titleArea.removeFromRight(220));
+        titleArea.removeFromRight(5);
+    }
+
     typeSelector.setBounds(titleArea);
 
     r.removeFromTop(5);
     r.removeFromRight(5);
 
     removeButton.setBounds(r.removeFromRight(30));
+    r.removeFromRight(5);
+    levelMeter.setBounds(r.removeFromRight(14));
+    r.removeFromRight(5);
+
+    if (decayView.isVisible())
+    {
+        decayView.setBounds(r.removeFromRight(90));
+        r.removeFromRight(5);
+    }
+
+    controlsViewport.setBounds(r);
+
+    const int numColumns = (int) (irSelectors.size() + sliders.size() + comboBoxes.size() + toggles.size());
+    controlsContainer.setSize(numColumns * 70, controlsViewport.getMaximumVisibleHeight());
+
+    r = controlsContainer.getLocalBounds();
 
     // Layout IR selectors
     for (int i = 0; i < irSelectors.size(); i++)
@@ -233,6 +295,8 @@ void ModuleSlotEditor::resized()
         auto a = r.removeFromLeft(70);  // Wider for ComboBox
         irSelectorLabels[i]->setBounds(a.removeFromBottom(30));
         irSelectors[i]->setBounds(a.removeFromTop(25));
+        a.removeFromTop(5);
+        irBrowseButtons[i]->setBounds(a.removeFromTop(25));
     }
 
     // Layout Other Components
@@ -258,4 +322,223 @@ void ModuleSlotEditor::resized()
     }
 
 
-}
\ No newline at end of file
+}
+
+void ModuleSlotEditor::setCpuMeterVisible(bool shouldBeVisible)
+{
+    if (cpuMeter.isVisible() == shouldBeVisible)
+        return;
+
+    cpuMeter.setVisible(shouldBeVisible);
+    resized();
+}
+
+void ModuleSlotEditor::updateCpuMeter(const ADSREchoAudioProcessor::Profiler& profiler)
+{
+    cpuMeter.setStats(profiler.getSlotStats(chainIndex, slotIndex));
+}
+
+void ModuleSlotEditor::updateLevelMeter(const ADSREchoAudioProcessor::Meters& meters)
+{
+    levelMeter.setLevels(meters.getSlotLevels(chainIndex, slotIndex));
+}
+
+void ModuleSlotEditor::updateDecayView()
+{
+    auto result = processor.getDecayAnalysis(chainIndex, slotIndex);
+    const bool shouldBeVisible = result != nullptr;
+
+    decayView.setResult(std::move(result));
+
+    if (decayView.isVisible() != shouldBeVisible)
+    {
+        decayView.setVisible(shouldBeVisible);
+        resized();
+    }
+}
+
+void CpuMeter::setStats(const ADSREchoAudioProcessor::Profiler::Stats& newStats)
+{
+    stats = newStats;
+    repaint();
+}
+
+void CpuMeter::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+
+    g.setColour(juce::Colours::black.withAlpha(0.4f));
+    g.fillRoundedRectangle(bounds, 3.0f);
+
+    // Bar spans 0-100% of the callback budget; p99 is the tick mark
+    auto bar = bounds.reduced(2.0f);
+    const float meanWidth = bar.getWidth() * juce::jlimit(0.0f, 1.0f, stats.meanPercent / 100.0f);
+    const float p99X = bar.getX() + bar.getWidth() * juce::jlimit(0.0f, 1.0f, stats.p99Percent / 100.0f);
+
+    g.setColour(stats.p99Percent > 50.0f ? juce::Colours::orangered : juce::Colours::seagreen);
+    g.fillRect(bar.withWidth(meanWidth));
+
+    g.setColour(juce::Colours::white.withAlpha(0.8f));
+    g.drawVerticalLine(juce::roundToInt(p99X), bar.getY(), bar.getBottom());
+
+    g.setColour(juce::Colours::white);
+    g.setFont(11.0f);
+    g.drawText(juce::String(stats.meanPercent, 1) + "%  p99 " + juce::String(stats.p99Percent, 1)
+                   + "%  max " + juce::String(stats.maxPercent, 1) + "%",
+               getLocalBounds().reduced(4, 0), juce::Justification::centredLeft);
+}
+
+void LevelMeter::setLevels(const ADSREchoAudioProcessor::Meters::Levels& newLevels)
+{
+    levels = newLevels;
+    repaint();
+}
+
+void LevelMeter::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+
+    g.setColour(juce::Colours::black.withAlpha(0.4f));
+    g.fillRoundedRectangle(bounds, 2.0f);
+
+    auto toProportion = [](float gain)
+    {
+        return juce::jlimit(0.0f, 1.0f, (juce::Decibels::gainToDecibels(gain, -60.0f) + 60.0f) / 60.0f);
+    };
+
+    // RMS is the bar, peak the line above it; red once the peak clips
+    auto area = bounds.reduced(1.0f);
+    const float channelWidth = area.getWidth() / 2.0f;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto bar = area.removeFromLeft(channelWidth).reduced(0.5f, 0.0f);
+        const float rmsHeight = bar.getHeight() * toProportion(levels.rms[ch]);
+        const float peakY = bar.getBottom() - bar.getHeight() * toProportion(levels.peak[ch]);
+
+        g.setColour(juce::Colours::seagreen);
+        g.fillRect(bar.withTop(bar.getBottom() - rmsHeight));
+
+        g.setColour(levels.peak[ch] >= 1.0f ? juce::Colours::red : juce::Colours::white.withAlpha(0.8f));
+        g.drawHorizontalLine(juce::roundToInt(peakY), bar.getX(), bar.getRight());
+    }
+}
+
+void SpectrumView::setSpectrum(const ADSREchoAudioProcessor::Meters::Spectrum& newSpectrum)
+{
+    spectrum = newSpectrum;
+    repaint();
+}
+
+void SpectrumView::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+
+    g.setColour(juce::Colours::black.withAlpha(0.4f));
+    g.fillRoundedRectangle(bounds, 3.0f);
+
+    using Meters = ADSREchoAudioProcessor::Meters;
+
+    auto area = bounds.reduced(2.0f);
+    const float bandWidth = area.getWidth() / (float) Meters::numBands;
+
+    g.setColour(juce::Colours::seagreen);
+
+    for (int b = 0; b < Meters::numBands; ++b)
+    {
+        const float proportion = juce::jlimit(0.0f, 1.0f, 1.0f - spectrum.bandDb[b] / Meters::floorDb);
+        auto bar = juce::Rectangle<float>(area.getX() + b * bandWidth, area.getY(), bandWidth, area.getHeight());
+
+        g.fillRect(bar.reduced(0.5f, 0.0f).withTop(bar.getBottom() - bar.getHeight() * proportion));
+    }
+}
+
+void DecayView::setResult(std::shared_ptr<const DecayAnalysis::Result> newResult)
+{
+    result = std::move(newResult);
+    repaint();
+}
+
+void DecayView::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+
+    g.setColour(juce::Colours::black.withAlpha(0.4f));
+    g.fillRoundedRectangle(bounds, 3.0f);
+
+    if (result == nullptr)
+        return;
+
+    float longest = 0.0f;
+
+    for (const auto& band : result->bands)
+        longest = juce::jmax(longest, band.rt60);
+
+    auto area = bounds.reduced(2.0f);
+    const float bandWidth = area.getWidth() / (float) DecayAnalysis::numBands;
+
+    g.setColour(juce::Colours::steelblue);
+
+    for (int b = 0; b < DecayAnalysis::numBands && longest > 0.0f; ++b)
+    {
+        const float proportion = result->bands[b].rt60 / longest;
+        auto bar = juce::Rectangle<float>(area.getX() + b * bandWidth, area.getY(), bandWidth, area.getHeight());
+
+        g.fillRect(bar.reduced(0.5f, 0.0f).withTop(bar.getBottom() - bar.getHeight() * proportion));
+    }
+
+    g.setColour(juce::Colours::white);
+    g.setFont(11.0f);
+    g.drawText("RT60 " + juce::String(result->broadband.rt60, 2) + " s",
+               getLocalBounds().reduced(4, 0), juce::Justification::centredTop);
+}
+
+void ModuleSlotEditor::mouseDown(const juce::MouseEvent& e)
+{
+    juce::ignoreUnused(e);
+    processor.setSelectedSlot(chainIndex, slotIndex);
+}
+
+// IR library browser, in a call-out box next to the browse button
+void ModuleSlotEditor::showIRBrowser(juce::Component& target)
+{
+    processor.setSelectedSlot(chainIndex, slotIndex);
+
+    auto browser = std::make_unique<IRBrowser>();
+
+    // The editors are rebuilt while the call-out may still be open
+    browser->onIRChosen = [safeThis = juce::Component::SafePointer<ModuleSlotEditor>(this)](const juce::File& file)
+    {
+        if (safeThis != nullptr)
+            safeThis->loadCustomIR(file);
+    };
+
+    auto* parent = getTopLevelComponent();
+
+    juce::CallOutBox::launchAsynchronously(std::move(browser),
+                                           parent->getLocalArea(&target, target.getLocalBounds()),
+                                           parent);
+}
+
+void ModuleSlotEditor::loadCustomIR(const juce::File& file)
+{
+    processor.loadCustomIR(chainIndex, slotIndex, file);
+
+    for (auto& button : irBrowseButtons)
+        button->setButtonText(file.getFileNameWithoutExtension());
+}
+
+bool ModuleSlotEditor::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    return isConvolution
+        && files.size() == 1
+        && IRLibrary::isSupportedFile(juce::File(files[0]));
+}
+
+void ModuleSlotEditor::filesDropped(const juce::StringArray& files, int x, int y)
+{
+    juce::ignoreUnused(x, y);
+
+    if (isInterestedInFileDrag(files))
+        loadCustomIR(juce::File(files[0]));
+}
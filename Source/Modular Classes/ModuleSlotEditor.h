@@ -24,8 +24,54 @@
 #endif
 
 #include "../PluginProcessor.h"
+#include "IRBrowser.h"
 
-class ModuleSlotEditor : public juce::Component
+// Bar showing a slot's mean and p99 share of the audio callback budget
+class CpuMeter : public juce::Component
+{
+public:
+    void setStats(const ADSREchoAudioProcessor::Profiler::Stats& newStats);
+    void paint(juce::Graphics& g) override;
+
+private:
+    ADSREchoAudioProcessor::Profiler::Stats stats;
+};
+
+// Vertical peak/RMS bars, one per channel, on a -60..0 dBFS scale
+class LevelMeter : public juce::Component
+{
+public:
+    void setLevels(const ADSREchoAudioProcessor::Meters::Levels& newLevels);
+    void paint(juce::Graphics& g) override;
+
+private:
+    ADSREchoAudioProcessor::Meters::Levels levels;
+};
+
+// Band levels of a chain's output, 20 Hz to Nyquist, -90..0 dB
+class SpectrumView : public juce::Component
+{
+public:
+    void setSpectrum(const ADSREchoAudioProcessor::Meters::Spectrum& newSpectrum);
+    void paint(juce::Graphics& g) override;
+
+private:
+    ADSREchoAudioProcessor::Meters::Spectrum spectrum;
+};
+
+// Octave-band RT60 of a slot's decay analysis, 125 Hz to 8 kHz, scaled to
+// the longest band, with the broadband RT60 written across it
+class DecayView : public juce::Component
+{
+public:
+    void setResult(std::shared_ptr<const DecayAnalysis::Result> newResult);
+    void paint(juce::Graphics& g) override;
+
+private:
+    std::shared_ptr<const DecayAnalysis::Result> result;
+};
+
+class ModuleSlotEditor : public juce::Component, public juce::FileDragAndDropTarget
 {
 public:
     ModuleSlotEditor(int cIndex, int sIndex,
@@ -34,11 +80,32 @@ public:
         juce::AudioProcessorValueTreeState& apvts);
 
     void resized() override;
+    void mouseDown(const juce::MouseEvent& e) override;
+
+    // Dropping an IR file on a convolution slot loads it
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
+    // Fed by the plugin editor's timer while the CPU meters are shown
+    void setCpuMeterVisible(bool shouldBeVisible);
+    void updateCpuMeter(const ADSREchoAudioProcessor::Profiler& profiler);
+
+    // Fed by the plugin editor's timer
+    void updateLevelMeter(const ADSREchoAudioProcessor::Meters& meters);
+
+    // Fetches the slot's latest decay analysis; hidden until there is one
+    void updateDecayView();
+
+    // The module this editor was built for; a slot with the same serial can
+    // reuse the editor after moving to another index
+    int getModuleSerial() const { return moduleSerial; }
+    void setSlotIndex(int newSlotIndex) { slotIndex = newSlotIndex; }
 
 private:
     int chainIndex;
     int slotIndex;
     juce::String slotID;
+    int moduleSerial;
 
     ADSREchoAudioProcessor& processor;
 
@@ -46,6 +113,9 @@ private:
     juce::Label title;
     juce::ComboBox typeSelector;
     juce::ToggleButton enableToggle{ "Enabled" };
+    CpuMeter cpuMeter;
+    LevelMeter levelMeter;
+    DecayView decayView;
 
     juce::Viewport controlsViewport;
     juce::Component controlsContainer;
@@ -65,6 +135,8 @@ private:
     // IR Selectors (ComboBoxes)
     std::vector<std::unique_ptr<juce::ComboBox>> irSelectors;
     std::vector<std::unique_ptr<juce::Label>> irSelectorLabels;
+    std::vector<std::unique_ptr<juce::TextButton>> irBrowseButtons;
+    bool isConvolution = false;
     
     juce::TextButton removeButton{ "-" };
 
@@ -79,4 +151,6 @@ private:
     void addToggleForParameter(juce::String id);
     void addChoiceForParameter(juce::String id);
     void addIRSelectorForParameter(juce::String id);
+    void showIRBrowser(juce::Component& target);
+    void loadCustomIR(const juce::File& file);
 };
\ No newline at end of file
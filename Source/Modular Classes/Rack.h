@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    Rack.h
+    Every slot of every chain. State restore builds and prepares a whole new
+    Rack on the message thread, and the processor publishes it to the audio
+    thread with a single pointer store.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ModuleSlot.h"
+
+class Rack
+{
+public:
+    Rack(int numChains, int numSlots)
+        : numModules(numChains, 0)
+    {
+        slots.resize(numChains);
+
+        for (int j = 0; j < numChains; j++)
+        {
+            for (int i = 0; i < numSlots; i++)
+            {
+                juce::String prefix = "chain_" + juce::String(j) + ".slot_" + juce::String(i);
+
+                slots[j].push_back(std::make_unique<ModuleSlot>(prefix));
+            }
+        }
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        for (auto& chain : slots)
+            for (auto& slot : chain)
+                slot->prepare(spec);
+    }
+
+    void destroyPending()
+    {
+        for (auto& chain : slots)
+            for (auto& slot : chain)
+                slot->destroyPending();
+    }
+
+    std::vector<std::vector<std::unique_ptr<ModuleSlot>>> slots;
+
+    // Populated slots per chain
+    std::vector<int> numModules;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Rack)
+};
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    TransportState.h
+    Host transport, read once per callback and shared by all modules.
+
+  ==============================================================================
+*/
+
+#pragma once
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"  // for Projucer
+#else // for Cmake
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_audio_processors/juce_audio_processors.h>
+#endif
+
+struct TransportState
+{
+    double bpm = 120.0;
+    bool hasHostTempo = false;   // false when the host gives no tempo
+    bool isPlaying = false;
+    double ppqPosition = 0.0;
+
+    // Note division choices of the delay sync parameters, in quarter notes
+    static float getNoteDivisionMultiplier(int noteDivision)
+    {
+        static const float noteMultipliers[] = {
+            4.0f, 2.0f, 1.0f, 0.5f, 0.25f, 0.125f,           // straight: 1/1 to 1/32
+            3.0f, 1.5f, 0.75f, 0.375f,                         // dotted: 1/2d to 1/16d
+            4.0f / 3.0f, 2.0f / 3.0f, 1.0f / 3.0f, 1.0f / 6.0f // triplet: 1/2t to 1/16t
+        };
+
+        return juce::isPositiveAndBelow(noteDivision, (int) std::size(noteMultipliers))
+            ? noteMultipliers[noteDivision] : 1.0f;
+    }
+};
+
+class TransportService
+{
+public:
+    // Audio thread, once per processBlock before any module runs
+    void update(juce::AudioPlayHead* playHead)
+    {
+        state.hasHostTempo = false;
+        state.isPlaying = false;
+
+        if (playHead == nullptr)
+            return;
+
+        if (auto position = playHead->getPosition())
+        {
+            // Keep the last known tempo when the host stops reporting one
+            if (auto hostBpm = position->getBpm())
+            {
+                if (*hostBpm > 0.0)
+                {
+                    state.bpm = *hostBpm;
+                    state.hasHostTempo = true;
+                }
+            }
+
+            if (auto ppq = position->getPpqPosition())
+                state.ppqPosition = *ppq;
+
+            state.isPlaying = position->getIsPlaying();
+        }
+    }
+
+    const TransportState& getState() const { return state; }
+
+private:
+    TransportState state;
+};
@@ -13,8 +13,12 @@
 ADSREchoAudioProcessorEditor::ADSREchoAudioProcessorEditor (ADSREchoAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
 {
-    startTimerHz(30);
     currentlyDisplayedChain = 0;
+    audioProcessor.addChangeListener(this);
+
+    // Levels are only measured while an editor is registered
+    audioProcessor.getLevelMeters().addViewer();
+    startTimerHz(30);
 
     // Per-chain controls
     for (int chain = 0; chain < numChains; ++chain)
@@ -29,7 +33,7 @@ ADSREchoAudioProcessorEditor::ADSREchoAudioProcessorEditor (ADSREchoAudioProcess
     chainSelector.onChange = [this]
         {
             currentlyDisplayedChain = chainSelector.getSelectedId() - 1;
-            rebuildModuleEditors();
+            updateModuleEditors();
         };
 
     // Parallel toggle
@@ -38,6 +42,51 @@ ADSREchoAudioProcessorEditor::ADSREchoAudioProcessorEditor (ADSREchoAudioProcess
         std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
             audioProcessor.apvts, "parallelEnabled", parallelEnableToggle);
 
+    // CPU meters
+    addAndMakeVisible(cpuMeterToggle);
+    addChildComponent(cpuLabel);
+    cpuLabel.setFont(11.0f);
+    cpuMeterToggle.onClick = [this]
+        {
+            setCpuMetersShown(cpuMeterToggle.getToggleState());
+        };
+
+    // A/B snapshots and morph
+    for (int i = 0; i < 2; ++i)
+    {
+        addAndMakeVisible(snapshotButtons[i]);
+        snapshotButtons[i].onClick = [this, i]
+            {
+                audioProcessor.captureSnapshot(i);
+                updateSnapshotButtons();
+            };
+    }
+
+    addAndMakeVisible(clearSnapshotsButton);
+    clearSnapshotsButton.onClick = [this]
+        {
+            audioProcessor.clearSnapshots();
+            updateSnapshotButtons();
+        };
+
+    addAndMakeVisible(morphSlider);
+    morphSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    morphSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    morphAttachment =
+        std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            audioProcessor.apvts, "morph", morphSlider);
+
+    updateSnapshotButtons();
+
+    // Chain level and spectrum
+    addAndMakeVisible(chainLevelMeter);
+    addChildComponent(spectrumView);
+    addAndMakeVisible(spectrumToggle);
+    spectrumToggle.onClick = [this]
+        {
+            setSpectrumShown(spectrumToggle.getToggleState());
+        };
+
     // Add module button
     addAndMakeVisible(addButton);
     addButton.onClick = [this]
@@ -52,13 +101,21 @@ ADSREchoAudioProcessorEditor::ADSREchoAudioProcessorEditor (ADSREchoAudioProcess
     moduleViewport.setScrollBarsShown(true, false);
 
     setSize(800, 600);
-    rebuildModuleEditors();
+    updateModuleEditors();
 }
 
 ADSREchoAudioProcessorEditor::~ADSREchoAudioProcessorEditor()
 {
-    // Stop the timer when the editor is destroyed
+    audioProcessor.removeChangeListener(this);
     stopTimer();
+
+    if (cpuMeterToggle.getToggleState())
+        audioProcessor.getCpuProfiler().removeViewer();
+
+    if (spectrumToggle.getToggleState())
+        audioProcessor.getLevelMeters().removeSpectrumViewer();
+
+    audioProcessor.getLevelMeters().removeViewer();
 }
 
 //==============================================================================
@@ -91,7 +148,27 @@ void ADSREchoAudioProcessorEditor::resized()
     chainSelector.setBounds(top.removeFromLeft(100));
     parallelEnableToggle.setBounds(top.removeFromLeft(30));
 
-    addButton.setBounds(area.removeFromTop(30));
+    auto cpuArea = top.removeFromLeft(160).reduced(5, 0);
+    cpuMeterToggle.setBounds(cpuArea.removeFromTop(25));
+    cpuLabel.setBounds(cpuArea.removeFromTop(60));
+
+    auto buttonRow = area.removeFromTop(30);
+    auto morphArea = buttonRow.removeFromRight(300);
+
+    snapshotButtons[0].setBounds(morphArea.removeFromLeft(40));
+    morphSlider.setBounds(morphArea.removeFromLeft(160).reduced(5, 0));
+    snapshotButtons[1].setBounds(morphArea.removeFromLeft(40));
+    clearSnapshotsButton.setBounds(morphArea.reduced(5, 0));
+
+    addButton.setBounds(buttonRow);
+
+    area.removeFromTop(6);
+    auto meterRow = area.removeFromTop(60);
+    spectrumToggle.setBounds(meterRow.removeFromLeft(90).removeFromTop(25));
+    chainLevelMeter.setBounds(meterRow.removeFromRight(14));
+    meterRow.removeFromRight(6);
+    spectrumView.setBounds(meterRow);
+    area.removeFromTop(6);
 
     // Modules on the chain are added down sequentially
     moduleViewport.setBounds(area);
@@ -108,16 +185,94 @@ void ADSREchoAudioProcessorEditor::resized()
     moduleContainer.setSize(moduleViewport.getWidth(), y);
 }
 
-// On a constant timer, checks if the ui needs to be rebuild, then calls for a rebuild asynchronously
+// Slots were added, removed, moved or changed type
+void ADSREchoAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    updateModuleEditors();
+    updateSnapshotButtons();
+}
+
+// Display rate for the level meters, and the CPU meters while shown
 void ADSREchoAudioProcessorEditor::timerCallback()
 {
-    if (audioProcessor.uiNeedsRebuild.exchange(false, std::memory_order_acquire))
-        triggerAsyncUpdate();
+    updateLevelMeters();
+
+    if (cpuMeterToggle.getToggleState())
+        updateCpuMeters();
 }
 
-void ADSREchoAudioProcessorEditor::handleAsyncUpdate()
+// Captured snapshots are shown lit; the morph only acts once both are
+void ADSREchoAudioProcessorEditor::updateSnapshotButtons()
 {
-    rebuildModuleEditors();
+    for (int i = 0; i < 2; ++i)
+        snapshotButtons[i].setToggleState(audioProcessor.hasSnapshot(i), juce::dontSendNotification);
+
+    const bool morphing = audioProcessor.hasSnapshot(0) && audioProcessor.hasSnapshot(1);
+    morphSlider.setEnabled(morphing);
+    clearSnapshotsButton.setEnabled(audioProcessor.hasSnapshot(0) || audioProcessor.hasSnapshot(1));
+}
+
+void ADSREchoAudioProcessorEditor::setCpuMetersShown(bool shouldShow)
+{
+    auto& profiler = audioProcessor.getCpuProfiler();
+
+    if (shouldShow)
+        profiler.addViewer();
+    else
+        profiler.removeViewer();
+
+    cpuLabel.setVisible(shouldShow);
+
+    for (auto* editor : moduleEditors)
+        editor->setCpuMeterVisible(shouldShow);
+}
+
+void ADSREchoAudioProcessorEditor::setSpectrumShown(bool shouldShow)
+{
+    auto& meters = audioProcessor.getLevelMeters();
+
+    if (shouldShow)
+        meters.addSpectrumViewer();
+    else
+        meters.removeSpectrumViewer();
+
+    spectrumView.setVisible(shouldShow);
+}
+
+// Drains the level FIFO and refreshes the chain and slot meters
+void ADSREchoAudioProcessorEditor::updateLevelMeters()
+{
+    auto& meters = audioProcessor.getLevelMeters();
+    meters.update();
+
+    chainLevelMeter.setLevels(meters.getChainLevels(currentlyDisplayedChain));
+
+    if (spectrumView.isVisible())
+        spectrumView.setSpectrum(meters.getChainSpectrum(currentlyDisplayedChain));
+
+    for (auto* editor : moduleEditors)
+        editor->updateLevelMeter(meters);
+}
+
+// Drains the profiler and refreshes the callback, chain and slot meters
+void ADSREchoAudioProcessorEditor::updateCpuMeters()
+{
+    auto& profiler = audioProcessor.getCpuProfiler();
+    profiler.update();
+
+    auto describe = [](const ADSREchoAudioProcessor::Profiler::Stats& stats)
+        {
+            return juce::String(stats.meanPercent, 1) + "% (p99 " + juce::String(stats.p99Percent, 1)
+                 + "%, max " + juce::String(stats.maxPercent, 1) + "%)";
+        };
+
+    cpuLabel.setText("Total " + describe(profiler.getCallbackStats()) + "\nChain "
+                         + juce::String(currentlyDisplayedChain + 1) + " "
+                         + describe(profiler.getChainStats(currentlyDisplayedChain)),
+                     juce::dontSendNotification);
+
+    for (auto* editor : moduleEditors)
+        editor->updateCpuMeter(profiler);
 }
 
 // Setup for each chain mixer/gain slider
@@ -159,11 +314,13 @@ void ADSREchoAudioProcessorEditor::setupChainControls(int chainIndex)
 }
 
 
-// Rebuilds the module editor list, based on the current module slot list
-void ADSREchoAudioProcessorEditor::rebuildModuleEditors()
+// Matches the module editor list to the current module slot list. Editors are
+// keyed by module serial, so a slot that only moved keeps its editor (and its
+// attachments); only new or retyped modules get a fresh one.
+void ADSREchoAudioProcessorEditor::updateModuleEditors()
 {
-    moduleEditors.clear();
-    moduleContainer.removeAllChildren();
+    juce::OwnedArray<ModuleSlotEditor> previous;
+    previous.swapWith(moduleEditors);
 
     for (int i = 0; i < audioProcessor.getNumSlots(); ++i)
     {
@@ -171,19 +328,39 @@ void ADSREchoAudioProcessorEditor::rebuildModuleEditors()
             continue;
 
         auto info = audioProcessor.getSlotInfo(currentlyDisplayedChain, i);
+        ModuleSlotEditor* editor = nullptr;
 
-        auto* editor = new ModuleSlotEditor(
-            currentlyDisplayedChain,
-            i,
-            info,
-            audioProcessor,
-            audioProcessor.apvts
-        );
+        for (int j = 0; j < previous.size(); ++j)
+        {
+            if (previous[j]->getModuleSerial() == info.moduleSerial)
+            {
+                editor = previous.removeAndReturn(j);
+                editor->setSlotIndex(i);
+                break;
+            }
+        }
+
+        if (editor == nullptr)
+        {
+            editor = new ModuleSlotEditor(
+                currentlyDisplayedChain,
+                i,
+                info,
+                audioProcessor,
+                audioProcessor.apvts
+            );
+
+            editor->setCpuMeterVisible(cpuMeterToggle.getToggleState());
+            moduleContainer.addAndMakeVisible(editor);
+        }
 
         moduleEditors.add(editor);
-        moduleContainer.addAndMakeVisible(editor);
+        editor->updateDecayView();
     }
 
+    // Whatever is left belongs to removed or replaced modules
+    previous.clear();
+
     resized();
 }
 
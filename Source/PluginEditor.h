@@ -33,13 +33,13 @@
 */
 
 
-class ADSREchoAudioProcessorEditor  : public juce::AudioProcessorEditor, private juce::Timer, public juce::AsyncUpdater
+class ADSREchoAudioProcessorEditor  : public juce::AudioProcessorEditor, private juce::Timer,
+                                      private juce::ChangeListener
 {
 public:
     ADSREchoAudioProcessorEditor (ADSREchoAudioProcessor&);
     ~ADSREchoAudioProcessorEditor() override;
 
-    //void changeListenerCallback(juce::ChangeBroadcaster*) override;
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
@@ -81,15 +81,48 @@ private:
         juce::AudioProcessorValueTreeState::ButtonAttachment>
         parallelEnableToggleAttachment;
 
+    //==============================================================================
+    // CPU meters: the processor only takes timings while these are shown
+    juce::ToggleButton cpuMeterToggle{ "CPU" };
+    juce::Label cpuLabel;
+
+    void setCpuMetersShown(bool shouldShow);
+    void updateCpuMeters();
+
+    //==============================================================================
+    // A/B snapshots: clicking captures the current rack, the slider morphs
+    juce::TextButton snapshotButtons[2] { juce::TextButton("A"), juce::TextButton("B") };
+    juce::TextButton clearSnapshotsButton{ "Clear" };
+    juce::Slider morphSlider;
+    std::unique_ptr<
+        juce::AudioProcessorValueTreeState::SliderAttachment>
+        morphAttachment;
+
+    void updateSnapshotButtons();
+
+    //==============================================================================
+    // Level meters: measured while the editor exists, the spectrum only while
+    // its toggle is on
+    LevelMeter chainLevelMeter;
+    SpectrumView spectrumView;
+    juce::ToggleButton spectrumToggle{ "Spectrum" };
+
+    void setSpectrumShown(bool shouldShow);
+    void updateLevelMeters();
+
     //==============================================================================
     // Refactored helpers
-    void rebuildModuleEditors();
+
+    // Brings the slot editors in line with the displayed chain: editors whose
+    // module is still there are kept (and moved), the rest are created or
+    // deleted
+    void updateModuleEditors();
     void setupChainControls(int chainIndex);
 
     //==============================================================================
-    // Async + timer
+    // Processor change messages + meter timer
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
     void timerCallback() override;
-    void handleAsyncUpdate() override;
 
     bool attemptedChange = false;
 
@@ -9,6 +9,7 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "Reverb Algorithms/Reverb/DatorroHall.h"
+#include "DSPKernels.h"
 
 //==============================================================================
 ADSREchoAudioProcessor::ADSREchoAudioProcessor()
@@ -24,21 +25,47 @@ ADSREchoAudioProcessor::ADSREchoAudioProcessor()
 #endif
 {
     irBank = std::make_shared<IRBank>();
+    convolutionInputShare = std::make_shared<ConvolutionInputShare>();
+
+    const auto requestedStorage = juce::SystemStats::getEnvironmentVariable("ADSRECHO_DELAY_STORAGE", {});
+
+    if (requestedStorage.isNotEmpty() && !parseDelayStorage(requestedStorage, delayStorage))
+        DBG("Unknown ADSRECHO_DELAY_STORAGE " + requestedStorage);
+
+    rack = std::make_unique<Rack>(NUM_CHAINS, MAX_SLOTS);
+    activeRack.store(rack.get(), std::memory_order_release);
 
-    slots.resize(NUM_CHAINS);
     for (int j = 0; j < NUM_CHAINS; j++)
     {
-        for (int i = 0; i < MAX_SLOTS; i++)
+        chainMixParams[j]  = apvts.getRawParameterValue("chain_" + juce::String(j) + ".masterMix");
+        chainGainParams[j] = apvts.getRawParameterValue("chain_" + juce::String(j) + ".gain");
+    }
+
+    parallelEnabledParam = apvts.getRawParameterValue("parallelEnabled");
+    morphParam = apvts.getRawParameterValue("morph");
+
+    for (auto* param : getParameters())
+    {
+        if (auto* p = dynamic_cast<juce::RangedAudioParameter*>(param))
         {
-            juce::String prefix = "chain_" + juce::String(j) + ".slot_" + juce::String(i);
+            int chainIndex, slotIndex;
+            juce::String suffix;
 
-            slots[j].push_back(std::make_unique<ModuleSlot>(prefix));
+            if (RackState::splitSlotParameterID(p->getParameterID(), chainIndex, slotIndex, suffix))
+                slotParameters[chainIndex][slotIndex].push_back({ suffix, p, apvts.getRawParameterValue(p->getParameterID()) });
+            else
+                globalParameters.push_back(p);
         }
     }
+
+    // Morph module swaps, freeing replaced racks, slot move notifications,
+    // decay analysis
+    startTimerHz(30);
 }
 
 ADSREchoAudioProcessor::~ADSREchoAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -74,9 +101,10 @@ bool ADSREchoAudioProcessor::isMidiEffect() const
    #endif
 }
 
+// From the decay analysis; 0 until the first results are in
 double ADSREchoAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds.load(std::memory_order_relaxed);
 }
 
 int ADSREchoAudioProcessor::getNumPrograms()
@@ -119,13 +147,11 @@ void ADSREchoAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
     masterDryBuffer.clear();
     chainTempBuffer.clear();
 
-    // Prepare each audio effect with info
-    for (auto& chain : slots)
-    {
-        for (auto& slot : chain)
-            slot->prepare(spec);
-    }
+    convolutionInputShare->prepare(samplesPerBlock);
+    levelMeters.prepare(sampleRate);
 
+    // Prepare each audio effect with info
+    rack->prepare(spec);
 }
 
 void ADSREchoAudioProcessor::releaseResources()
@@ -133,12 +159,9 @@ void ADSREchoAudioProcessor::releaseResources()
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
 
-    // Free up the pending deleted modules:
-    for (auto& chain : slots)
-    {
-        for (auto& slot : chain)
-            slot->destroyPending();
-    }
+    // Free up the pending deleted modules and replaced racks:
+    rack->destroyPending();
+    releaseRetired();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -169,10 +192,20 @@ bool ADSREchoAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 
 void ADSREchoAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    // Odd from here to the end of the callback; see releaseRetired
+    callbackCount.fetch_add(1);
+
+    // One rack for the whole callback, even if a restore publishes another
+    auto& current = *activeRack.load();
+
+    // A/B snapshot morph, before any module reads its parameters
+    if (auto* m = activeMorph.load())
+        applyMorph(*m);
+
     // Move modules around if requested
     if (moveRequested.load(std::memory_order_acquire))
     {
-        executeSlotMove();
+        executeSlotMove(current);
     }
     
     // Resize, clear, and copy buffers
@@ -203,11 +236,30 @@ void ADSREchoAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
 
     buffer.clear();
 
+    // New callback: forward FFTs published by convolution slots are only valid within it
+    convolutionInputShare->beginBlock();
+
+    // Host position is read once here and shared by every slot
+    transport.update(getPlayHead());
+
+    // Timings are only taken while a CPU meter is on screen
+    const bool profiling = cpuProfiler.isActive();
+
+    if (profiling)
+        cpuProfiler.beginCallback(numSamples, getSampleRate());
+
+    // Likewise levels, only while the editor is open
+    const bool metering = levelMeters.isActive();
+
+    if (metering)
+        levelMeters.beginCallback(numSamples);
+
     // Process the audio through each module slot effect
-    bool parallelEnabled = apvts.getRawParameterValue("parallelEnabled")->load();
+    bool parallelEnabled = parallelEnabledParam->load() > 0.5f;
 
     for (int chainIndex = 0; chainIndex < NUM_CHAINS - !parallelEnabled; chainIndex++)
     {
+        const auto chainStart = profiling ? Profiler::now() : 0;
 
         chainTempBuffer.clear();
 
@@ -215,33 +267,57 @@ void ADSREchoAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
             chainTempBuffer.copyFrom(ch, 0, masterDryBuffer, ch, 0, numSamples);
 
 
-        for (auto& slot : slots[chainIndex])
+        for (int slotIndex = 0; slotIndex < MAX_SLOTS; ++slotIndex)
         {
-            slot->process(chainTempBuffer, midiMessages, getPlayHead());
+            auto& slot = current.slots[chainIndex][slotIndex];
+
+            if (profiling)
+            {
+                const auto slotStart = Profiler::now();
+                slot->process(chainTempBuffer, midiMessages, transport.getState());
+                cpuProfiler.addSlotTime(chainIndex, slotIndex, Profiler::now() - slotStart);
+            }
+            else
+            {
+                slot->process(chainTempBuffer, midiMessages, transport.getState());
+            }
+
+            if (metering && slot->hasModule())
+                levelMeters.measureSlot(chainIndex, slotIndex, chainTempBuffer, totalNumInputChannels, numSamples);
         }
 
         // ===== Chain mix =====
-        float wet = apvts.getRawParameterValue("chain_" + juce::String(chainIndex) + ".masterMix")->load();
+        float wet = chainMixParams[chainIndex]->load();
         float dry = 1.0f - wet;
 
-        for (int ch = 0; ch < totalNumInputChannels; ++ch)
-        {
-            auto* wetData = chainTempBuffer.getWritePointer(ch);
-            auto* dryData = masterDryBuffer.getReadPointer(ch);
+        const auto& kernels = DSPKernels::get();
 
-            for (int i = 0; i < numSamples; ++i)
-                wetData[i] = dryData[i] * dry + wetData[i] * wet;
-        }
+        for (int ch = 0; ch < totalNumInputChannels; ++ch)
+            kernels.mix(chainTempBuffer.getWritePointer(ch), wet, masterDryBuffer.getReadPointer(ch), dry, numSamples);
 
         // ===== Chain gain =====
-        float gainValue = apvts.getRawParameterValue("chain_" + juce::String(chainIndex) + ".gain")->load();
+        float gainValue = chainGainParams[chainIndex]->load();
         chainTempBuffer.applyGain(juce::Decibels::decibelsToGain(gainValue));
 
         for (int ch = 0; ch < totalNumInputChannels; ++ch)
         {
             buffer.addFrom(ch, 0, chainTempBuffer, ch, 0, numSamples, 1.0f);
         }
+
+        if (profiling)
+            cpuProfiler.addChainTime(chainIndex, Profiler::now() - chainStart);
+
+        if (metering)
+            levelMeters.measureChain(chainIndex, chainTempBuffer, totalNumInputChannels, numSamples);
     }
+
+    if (profiling)
+        cpuProfiler.endCallback();
+
+    if (metering)
+        levelMeters.endCallback();
+
+    callbackCount.fetch_add(1);
 }
 
 //==============================================================================
@@ -259,91 +335,580 @@ juce::AudioProcessorEditor* ADSREchoAudioProcessor::createEditor()
 //==============================================================================
 void ADSREchoAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
+    captureRackState().writeBinary(destData);
+}
 
-    state.removeChild(state.getChildWithName("Modules"), nullptr);
+RackState ADSREchoAudioProcessor::captureRackState()
+{
+    RackState state;
 
-    juce::ValueTree moduleState("Modules");
+    for (auto* p : globalParameters)
+        if (p->getValue() != p->getDefaultValue())
+            state.globals.emplace_back(p->getParameterID(), p->convertFrom0to1(p->getValue()));
 
-    // Read information about the chains and slots into the saved state
+    // Only populated slots, and only what differs from the defaults
     for (int j = 0; j < NUM_CHAINS; j++)
     {
-        juce::ValueTree chain("Chain");
-        chain.setProperty("index", j, nullptr);
-        
         for (int i = 0; i < MAX_SLOTS; ++i)
         {
-            if (auto* mod = slots[j][i]->get())
+            RackState::Slot slot;
+
+            if (describeSlot(*rack->slots[j][i], slot))
             {
-                juce::ValueTree slot("Slot");
-                slot.setProperty("index", i, nullptr);
-                slot.setProperty("type", mod->getType(), nullptr);
-                chain.addChild(slot, -1, nullptr);
+                slot.chainIndex = j;
+                slot.slotIndex = i;
+                state.slots.push_back(std::move(slot));
             }
         }
-
-        moduleState.addChild(chain, -1, nullptr);
     }
 
-    state.addChild(moduleState, -1, nullptr);
+    // Snapshot slots are kept by slot ID; saved by position like the rack
+    for (int index = 0; index < 2; ++index)
+    {
+        if (!snapshotCaptured[index])
+            continue;
+
+        auto snapshot = snapshots[index];
+
+        for (auto& slot : snapshot.slots)
+            slot.slotIndex = findSlotPosition(slot.chainIndex, slot.slotIndex);
 
-    auto xml = state.createXml();
-    copyXmlToBinary(*xml, destData);
+        state.snapshots.push_back(std::move(snapshot));
+    }
+
+    return state;
 }
 
 void ADSREchoAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    auto xml = getXmlFromBinary(data, sizeInBytes);
-    if (!xml) {
-        DBG("no xml!");
+    RackState state;
+
+    if (RackState::isBinary(data, sizeInBytes))
+    {
+        if (!RackState::readBinary(data, sizeInBytes, state))
+        {
+            DBG("Unreadable rack state!");
+            return;
+        }
+    }
+    else
+    {
+        // Sessions saved before the binary format
+        auto xml = getXmlFromBinary(data, sizeInBytes);
+        if (!xml) {
+            DBG("no xml!");
+            return;
+        }
+
+        state = RackState::fromValueTree(juce::ValueTree::fromXml(*xml));
+    }
+
+    restoreRackState(state);
+}
+
+// Type, custom IR and non-default parameters of the module in a slot; false
+// if the slot is empty
+bool ADSREchoAudioProcessor::describeSlot(ModuleSlot& slot, RackState::Slot& dest)
+{
+    auto* mod = slot.get();
+
+    if (mod == nullptr)
+        return false;
+
+    dest.type = mod->getType();
+
+    if (auto* conv = dynamic_cast<ConvolutionModule*>(mod))
+    {
+        auto irFile = conv->getCustomIRFile();
+
+        if (irFile != juce::File())
+            dest.irFile = irFile.getFullPathName();
+    }
+
+    for (const auto& sp : getSlotParameters(slot.slotID))
+        if (sp.parameter->getValue() != sp.parameter->getDefaultValue())
+            dest.parameters.emplace_back(sp.suffix, sp.parameter->convertFrom0to1(sp.parameter->getValue()));
+
+    return true;
+}
+
+std::unique_ptr<EffectModule> ADSREchoAudioProcessor::createModule(const juce::String& type)
+{
+    std::unique_ptr<EffectModule> module;
+
+    if (type == "Delay")
+        module = std::make_unique<DelayModule>("null", apvts);
+    else if (type == "Reverb")
+        module = std::make_unique<ReverbModule>("null", apvts);
+    else if (type == "Multi-Tap")
+        module = std::make_unique<MultiTapModule>("null", apvts);
+    else if (type == "Convolution")
+    {
+        auto conv = std::make_unique<ConvolutionModule>("null", apvts);
+        conv->setIRBank(irBank);
+        conv->setInputShare(convolutionInputShare);
+        module = std::move(conv);
+    }
+    else
+    {
+        DBG("Error: Unknown module type " + type);
+        return nullptr;
+    }
+
+    module->setDelayStorage(delayStorage);
+    return module;
+}
+
+std::unique_ptr<EffectModule> ADSREchoAudioProcessor::createModule(ModuleType type)
+{
+    switch (type)
+    {
+        case ModuleType::Delay:       return createModule("Delay");
+        case ModuleType::Reverb:      return createModule("Reverb");
+        case ModuleType::MultiTap:    return createModule("Multi-Tap");
+        case ModuleType::Convolution: return createModule("Convolution");
+        default:                      break;
+    }
+
+    return nullptr;
+}
+
+void ADSREchoAudioProcessor::setDelayStorage(DelayStorage storage)
+{
+    if (storage == delayStorage)
         return;
+
+    delayStorage = storage;
+
+    // Fresh modules, allocated and prepared off the audio thread, with the
+    // current settings and snapshots
+    restoreRackState(captureRackState());
+}
+
+void ADSREchoAudioProcessor::restoreRackState(const RackState& state)
+{
+    // The new rack is built and prepared here while the audio thread keeps
+    // playing the current one, then swapped in whole
+    auto newRack = std::make_unique<Rack>(NUM_CHAINS, MAX_SLOTS);
+
+    if (spec.sampleRate > 0)
+        newRack->prepare(spec);
+
+    // Stored value, or the default when the state leaves it out. Values are
+    // saved in parameter order, so the search resumes after the last match.
+    size_t next = 0;
+
+    auto restore = [&next](juce::RangedAudioParameter* p, const juce::String& id,
+                           const std::vector<std::pair<juce::String, float>>& values)
+    {
+        float value = p->getDefaultValue();
+
+        for (size_t n = 0; n < values.size(); ++n)
+        {
+            const size_t k = (next + n) % values.size();
+
+            if (values[k].first == id)
+            {
+                value = p->convertTo0to1(values[k].second);
+                next = k + 1;
+                break;
+            }
+        }
+
+        if (p->getValue() != value)
+            p->setValueNotifyingHost(value);
+    };
+
+    for (auto* p : globalParameters)
+        restore(p, p->getParameterID(), state.globals);
+
+    // Restore Topology and the populated slots' parameters. Empty slots are
+    // left alone: addModule resets a slot to its defaults when it is filled.
+    for (const auto& slotState : state.slots)
+    {
+        const int chainIndex = slotState.chainIndex;
+        const int slotIndex = slotState.slotIndex;
+
+        if (!juce::isPositiveAndBelow(chainIndex, NUM_CHAINS) || !juce::isPositiveAndBelow(slotIndex, MAX_SLOTS))
+        {
+            DBG("Error: Rack state has a slot out of range!");
+            continue;
+        }
+
+        auto module = createModule(slotState.type);
+
+        if (module == nullptr)
+            continue;
+
+        if (auto* conv = dynamic_cast<ConvolutionModule*>(module.get()))
+            if (slotState.irFile.isNotEmpty())
+                conv->loadIRFile(juce::File(slotState.irFile));
+
+        auto& slot = newRack->slots[chainIndex][slotIndex];
+        slot->setModule(std::move(module));
+        newRack->numModules[chainIndex]++;
+
+        next = 0;
+
+        for (const auto& sp : getSlotParameters(slot->slotID))
+            restore(sp.parameter, sp.suffix, slotState.parameters);
     }
-    auto state = juce::ValueTree::fromXml(*xml);
 
-    // Clear Modules
-    for (auto& chain : slots)
-        for(auto& slot : chain)
-            slot->clearModule();
+    // A move requested against the old rack no longer applies
+    moveRequested.store(false, std::memory_order_release);
 
-    numModules = std::vector<int>(NUM_CHAINS, 0);
+    publishRack(std::move(newRack));
 
-    // Restore Topology
-    auto modules = state.getChildWithName("Modules");
+    // In the fresh rack every slot sits at the position its ID names
+    snapshotCaptured[0] = snapshotCaptured[1] = false;
 
-    for (auto chainState : modules)
+    for (const auto& snapshot : state.snapshots)
     {
-        int chainIndex = (int)chainState["index"];
+        if (juce::isPositiveAndBelow(snapshot.index, 2))
+        {
+            snapshots[snapshot.index] = snapshot;
+            snapshotCaptured[snapshot.index] = true;
+        }
+    }
+
+    rebuildMorph();
+
+    sendChangeMessage();
+}
+
+//==============================================================================
+void ADSREchoAudioProcessor::captureSnapshot(int index)
+{
+    jassert(juce::isPositiveAndBelow(index, 2));
+
+    RackState::Snapshot snapshot;
+    snapshot.index = index;
 
-        for (auto slotState : chainState)
+    // Chain parameters; the global switches and the morph itself stay put
+    for (auto* p : globalParameters)
+        if (p->getParameterID().startsWith("chain_") && p->getValue() != p->getDefaultValue())
+            snapshot.globals.emplace_back(p->getParameterID(), p->convertFrom0to1(p->getValue()));
+
+    for (int j = 0; j < NUM_CHAINS; j++)
+    {
+        for (auto& moduleSlot : rack->slots[j])
         {
-            int slotIndex = (int)slotState["index"];
-            auto type = slotState["type"];
+            RackState::Slot slot;
 
-            if (type == "Delay")
+            if (describeSlot(*moduleSlot, slot))
             {
-                auto module = std::make_unique<DelayModule>("null", apvts);
-                slots[chainIndex][slotIndex]->setModule(std::move(module));
+                slot.chainIndex = j;
+                slot.slotIndex = moduleSlot->slotID.getTrailingIntValue();
+                snapshot.slots.push_back(std::move(slot));
             }
-            else if (type == "Reverb")
+        }
+    }
+
+    snapshots[index] = std::move(snapshot);
+    snapshotCaptured[index] = true;
+
+    rebuildMorph();
+}
+
+void ADSREchoAudioProcessor::clearSnapshots()
+{
+    snapshotCaptured[0] = snapshotCaptured[1] = false;
+    rebuildMorph();
+}
+
+bool ADSREchoAudioProcessor::hasSnapshot(int index) const
+{
+    return juce::isPositiveAndBelow(index, 2) && snapshotCaptured[index];
+}
+
+ModuleSlot* ADSREchoAudioProcessor::findSlot(int chainIndex, int slotID)
+{
+    for (auto& slot : rack->slots[chainIndex])
+        if (slot->slotID.getTrailingIntValue() == slotID)
+            return slot.get();
+
+    return nullptr;
+}
+
+int ADSREchoAudioProcessor::findSlotPosition(int chainIndex, int slotID)
+{
+    for (int i = 0; i < MAX_SLOTS; ++i)
+        if (rack->slots[chainIndex][i]->slotID.getTrailingIntValue() == slotID)
+            return i;
+
+    return slotID;
+}
+
+void ADSREchoAudioProcessor::rebuildMorph()
+{
+    if (!snapshotCaptured[0] || !snapshotCaptured[1])
+    {
+        publishMorph(nullptr);
+        return;
+    }
+
+    auto newMorph = std::make_unique<Morph>();
+
+    struct Target
+    {
+        juce::RangedAudioParameter* parameter;
+        float a, b;
+    };
+
+    std::vector<Target> interpolated, switched;
+    std::vector<Morph::Fade> fades;
+
+    // Plain value in a snapshot, or the parameter's default
+    auto valueIn = [](const std::vector<std::pair<juce::String, float>>& values,
+                      const juce::String& id, juce::RangedAudioParameter* p)
+    {
+        for (const auto& v : values)
+            if (v.first == id)
+                return v.second;
+
+        return p->convertFrom0to1(p->getDefaultValue());
+    };
+
+    for (auto* p : globalParameters)
+    {
+        const auto id = p->getParameterID();
+
+        if (id.startsWith("chain_"))
+            interpolated.push_back({ p, valueIn(snapshots[0].globals, id, p), valueIn(snapshots[1].globals, id, p) });
+    }
+
+    static const std::vector<std::pair<juce::String, float>> noValues;
+
+    for (int j = 0; j < NUM_CHAINS; j++)
+    {
+        for (int id = 0; id < MAX_SLOTS; ++id)
+        {
+            const RackState::Slot* sides[2] {};
+
+            for (int side = 0; side < 2; ++side)
             {
-                auto module = std::make_unique<ReverbModule>("null", apvts);
-                slots[chainIndex][slotIndex]->setModule(std::move(module));
+                for (const auto& slot : snapshots[side].slots)
+                    if (slot.chainIndex == j && slot.slotIndex == id)
+                        sides[side] = &slot;
+
+                newMorph->types[side][j][id] = sides[side] != nullptr ? sides[side]->type : juce::String();
+                newMorph->irFiles[side][j][id] = sides[side] != nullptr ? sides[side]->irFile : juce::String();
             }
-            else if (type == "Convolution")
+
+            // Installed type: the timer swaps modules towards the wanted side
+            auto* slot = findSlot(j, id);
+            const auto installedType = (slot != nullptr && slot->get() != nullptr) ? slot->get()->getType() : juce::String();
+
+            newMorph->installedSide[j][id].store(installedType == newMorph->types[0][j][id] ? 0
+                                                 : installedType == newMorph->types[1][j][id] ? 1 : -1);
+
+            if (sides[0] == nullptr && sides[1] == nullptr)
+                continue;
+
+            const bool sameType = newMorph->types[0][j][id] == newMorph->types[1][j][id];
+
+            for (const auto& sp : slotParameters[j][id])
             {
-                auto module = std::make_unique<ConvolutionModule>("null", apvts);
-                module->setIRBank(irBank);
-                slots[chainIndex][slotIndex]->setModule(std::move(module));
+                const Target target { sp.parameter,
+                                      valueIn(sides[0] != nullptr ? sides[0]->parameters : noValues, sp.suffix, sp.parameter),
+                                      valueIn(sides[1] != nullptr ? sides[1]->parameters : noValues, sp.suffix, sp.parameter) };
+
+                // Choices, switches and the IR index (each step is an IR load) only switch
+                const bool continuous = dynamic_cast<juce::AudioParameterFloat*>(sp.parameter) != nullptr
+                                        && sp.suffix != "convIrIndex";
+
+                if (!sameType && sp.suffix == "mix")
+                    fades.push_back({ (int) switched.size(), j, id });
+
+                if (sameType && continuous)
+                    interpolated.push_back(target);
+                else
+                    switched.push_back(target);
             }
+        }
+    }
+
+    newMorph->numInterpolated = (int) interpolated.size();
+
+    for (auto& fade : fades)
+        fade.mixTarget += newMorph->numInterpolated;
+
+    newMorph->fades = std::move(fades);
 
-            numModules[chainIndex]++;
+    for (const auto* list : { &interpolated, &switched })
+    {
+        for (const auto& target : *list)
+        {
+            newMorph->targets.push_back(apvts.getRawParameterValue(target.parameter->getParameterID()));
+            newMorph->parameters.push_back(target.parameter);
+            newMorph->a.push_back(target.a);
+            newMorph->b.push_back(target.b);
+        }
+    }
+
+    newMorph->out.resize(newMorph->targets.size());
+
+    publishMorph(std::move(newMorph));
+}
+
+// Audio thread: writes the morphed values into the APVTS values the modules
+// read, only when the morph position or an installed module has changed
+void ADSREchoAudioProcessor::applyMorph(Morph& m)
+{
+    const float t = juce::jlimit(0.0f, 1.0f, morphParam->load());
+    const int generation = m.installGeneration.load(std::memory_order_acquire);
+
+    if (t == m.lastMorph && generation == m.lastGeneration)
+        return;
+
+    m.lastMorph = t;
+    m.lastGeneration = generation;
+
+    const int side = t < 0.5f ? 0 : 1;
+    m.wantedSide.store(side, std::memory_order_release);
+
+    const int numTargets = (int) m.targets.size();
+    const float* a = m.a.data();
+    const float* b = m.b.data();
+    float* out = m.out.data();
+
+    DSPKernels::get().lerp(out, a, b, t, m.numInterpolated);
+
+    for (int i = m.numInterpolated; i < numTargets; ++i)
+        out[i] = side == 0 ? a[i] : b[i];
+
+    // Full wet at the ends, dry around the midpoint and until the module
+    // for this side is in
+    constexpr float fadeHalfWidth = 0.1f;
+
+    for (const auto& fade : m.fades)
+    {
+        const bool installed = m.installedSide[fade.chainIndex][fade.slotID].load(std::memory_order_acquire) == side;
+        const float gain = installed ? juce::jmin(1.0f, std::abs(t - 0.5f) / fadeHalfWidth) : 0.0f;
+
+        out[fade.mixTarget] *= gain;
+    }
+
+    for (int i = 0; i < numTargets; ++i)
+        m.targets[i]->store(out[i], std::memory_order_relaxed);
+}
+
+// Message thread: swaps modules in slots whose type differs between the
+// snapshots, once the morph has crossed the midpoint, frees whatever the
+// audio thread has let go of, and passes on slot moves to the editor
+void ADSREchoAudioProcessor::timerCallback()
+{
+    releaseRetired();
+
+    // Moves run on the audio thread, which cannot post messages itself
+    if (slotsMoved.exchange(false, std::memory_order_acquire))
+        sendChangeMessage();
+
+    // ~3 Hz, so a knob drag queues a few analyses rather than one per step
+    if (++decayCheckTicks >= 10)
+    {
+        decayCheckTicks = 0;
+        updateDecayAnalysis();
+    }
+
+    if (morph == nullptr || morph->fades.empty())
+        return;
+
+    const int side = morph->wantedSide.load(std::memory_order_acquire);
+    bool swapped = false;
+
+    for (const auto& fade : morph->fades)
+    {
+        auto& installed = morph->installedSide[fade.chainIndex][fade.slotID];
+
+        if (installed.load() == side)
+            continue;
+
+        auto* slot = findSlot(fade.chainIndex, fade.slotID);
+
+        if (slot == nullptr)
+            continue;
+
+        const auto& type = morph->types[side][fade.chainIndex][fade.slotID];
+        const bool wasEmpty = slot->get() == nullptr;
+
+        if (type.isEmpty())
+        {
+            if (!wasEmpty)
+            {
+                slot->clearModule();
+                rack->numModules[fade.chainIndex]--;
+            }
+        }
+        else if (auto module = createModule(type))
+        {
+            const auto& irFile = morph->irFiles[side][fade.chainIndex][fade.slotID];
+
+            if (auto* conv = dynamic_cast<ConvolutionModule*>(module.get()))
+                if (irFile.isNotEmpty())
+                    conv->loadIRFile(juce::File(irFile));
+
+            slot->setModule(std::move(module));
+
+            if (wasEmpty)
+                rack->numModules[fade.chainIndex]++;
         }
+
+        installed.store(side, std::memory_order_release);
+        swapped = true;
+    }
+
+    if (swapped)
+    {
+        morph->installGeneration.fetch_add(1, std::memory_order_release);
+        sendChangeMessage();
     }
+}
+
+//==============================================================================
+void ADSREchoAudioProcessor::publishRack(std::unique_ptr<Rack> newRack)
+{
+    activeRack.store(newRack.get());
+
+    // Read after the store: if no callback is running now, the next one
+    // will load the new rack
+    retired.push_back({ std::move(rack), nullptr, callbackCount.load() });
+    rack = std::move(newRack);
+
+    releaseRetired();
+}
+
+void ADSREchoAudioProcessor::publishMorph(std::unique_ptr<Morph> newMorph)
+{
+    activeMorph.store(newMorph.get());
+
+    if (morph != nullptr)
+        retired.push_back({ nullptr, std::move(morph), callbackCount.load() });
+
+    morph = std::move(newMorph);
+
+    releaseRetired();
+}
+
+void ADSREchoAudioProcessor::releaseRetired()
+{
+    const auto count = callbackCount.load();
+
+    for (auto it = retired.begin(); it != retired.end();)
+    {
+        if ((it->callbackCount & 1) != 0 && it->callbackCount == count)
+        {
+            ++it;
+            continue;
+        }
 
-    // Restore Parameters
-    apvts.replaceState(state);
+        // Without a morph the modules should hear the parameters again
+        if (it->morph != nullptr && morph == nullptr)
+            for (size_t i = 0; i < it->morph->targets.size(); ++i)
+                it->morph->targets[i]->store(it->morph->parameters[i]->convertFrom0to1(it->morph->parameters[i]->getValue()));
 
-    uiNeedsRebuild.store(true, std::memory_order_release);
+        it = retired.erase(it);
+    }
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout ADSREchoAudioProcessor::createParameterLayout()
@@ -367,6 +932,11 @@ void ADSREchoAudioProcessor::addGlobalParameters(juce::AudioProcessorValueTreeSt
 {
     layout.add(std::make_unique<juce::AudioParameterBool>(
         "parallelEnabled", "Parallel Enabled", false));
+
+    // A -> B position once both snapshots are captured
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "morph", "Morph",
+        juce::NormalisableRange<float>(0.f, 1.f, 0.001f), 0.f));
 }
 
 
@@ -430,6 +1000,11 @@ void ADSREchoAudioProcessor::addSlotParameters(juce::AudioProcessorValueTreeStat
     layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + ".convHighCut", "Conv High Cut (Hz)",
         juce::NormalisableRange<float>(2000.0f, 20000.0f, 1.0f, 0.3f), 12000.0f));
 
+    layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + ".convTilt", "Conv Tilt (dB)",
+        juce::NormalisableRange<float>(-6.0f, 6.0f, 0.1f), 0.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>(prefix + ".convTrueStereo", "Conv True Stereo", true));
+
     layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + ".reverbType", "Type",
         juce::StringArray{ "Datorro Hall", "Hybrid Plate" }, 0));
 
@@ -444,7 +1019,7 @@ void ADSREchoAudioProcessor::addSlotParameters(juce::AudioProcessorValueTreeStat
                            "1/2 Triplet", "1/4 Triplet", "1/8 Triplet", "1/16 Triplet" }, 2));
 
     layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + ".delayMode", "Delay Mode",
-        juce::StringArray{ "Normal", "Ping Pong", "Inverted" }, 0));
+        juce::StringArray{ "Normal", "Ping Pong", "Inverted", "Tape" }, 0));
 
     layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + ".delayPan", "Delay Pan",
         juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), 0.0f));
@@ -454,6 +1029,39 @@ void ADSREchoAudioProcessor::addSlotParameters(juce::AudioProcessorValueTreeStat
 
     layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + ".delayHighpass", "Delay Highpass",
         juce::NormalisableRange<float>(20.0f, 5000.0f, 1.0f, 0.3f), 20.0f));
+
+    // Tape mode modulation and read interpolation
+    layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + ".delayWow", "Tape Wow",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.3f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + ".delayFlutter", "Tape Flutter",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.2f));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + ".delayInterp", "Tape Interpolation",
+        juce::StringArray{ "Cubic", "Lagrange", "Allpass" }, 0));
+
+    // Multi-tap delay (defaults: eighth notes at 120 BPM, alternating sides, fading out)
+    layout.add(std::make_unique<juce::AudioParameterInt>(prefix + ".tapCount", "Taps",
+        1, MultiTapModule::kNumTaps, 4));
+
+    for (int t = 0; t < MultiTapModule::kNumTaps; ++t)
+    {
+        const auto tapPrefix = prefix + "." + MultiTapModule::tapParameter(t, {});
+        const auto tapName = "Tap " + juce::String(t + 1);
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(tapPrefix + "Time", tapName + " Time",
+            juce::NormalisableRange<float>(1.0f, MultiTapDelay::kMaxDelayMs, 0.1f, 0.4f),
+            juce::jmin(MultiTapDelay::kMaxDelayMs, 250.0f * (float) (t + 1))));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(tapPrefix + "Gain", tapName + " Gain",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f - 0.05f * (float) t));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(tapPrefix + "Pan", tapName + " Pan",
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), (t % 2 == 0) ? -0.5f : 0.5f));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(tapPrefix + "Lowpass", tapName + " Lowpass",
+            juce::NormalisableRange<float>(200.0f, 20000.0f, 1.0f, 0.3f), 20000.0f));
+    }
 }
 
 
@@ -467,48 +1075,158 @@ int ADSREchoAudioProcessor::getNumChains() const
     return NUM_CHAINS;
 }
 
+//==============================================================================
+// Module type, sample rate, every setting but the mix (the analysis runs
+// fully wet) and the module's own key state, hashed with FNV-1a; 0 for an
+// empty slot
+juce::uint64 ADSREchoAudioProcessor::getDecayKey(ModuleSlot& slot, double sampleRate)
+{
+    auto* mod = slot.get();
+
+    if (mod == nullptr)
+        return 0;
+
+    juce::uint64 hash = 14695981039346656037ull;
+
+    auto add = [&hash](const void* data, size_t numBytes)
+    {
+        for (size_t i = 0; i < numBytes; ++i)
+        {
+            hash ^= static_cast<const juce::uint8*>(data)[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    const auto type = mod->getType();
+    add(type.toRawUTF8(), type.getNumBytesAsUTF8());
+    add(&sampleRate, sizeof(sampleRate));
+    add(&delayStorage, sizeof(delayStorage));
+
+    const auto moduleState = mod->getDecayKeyState();
+    add(&moduleState, sizeof(moduleState));
+
+    const auto used = mod->getUsedParameters();
+
+    for (const auto& sp : getSlotParameters(slot.slotID))
+    {
+        if (sp.suffix == "mix" || std::find(used.begin(), used.end(), sp.suffix) == used.end())
+            continue;
+
+        const float value = sp.value->load(std::memory_order_relaxed);
+        add(&value, sizeof(value));
+    }
+
+    return hash != 0 ? hash : 1;
+}
+
+void ADSREchoAudioProcessor::updateDecayAnalysis()
+{
+    const double sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    bool changed = decayAnalyser.takeNewResults();
+
+    for (int j = 0; j < NUM_CHAINS; j++)
+    {
+        for (int i = 0; i < MAX_SLOTS; i++)
+        {
+            auto& slot = *rack->slots[j][i];
+            const auto key = getDecayKey(slot, sampleRate);
+
+            if (key != decayKeys[j][i])
+            {
+                decayKeys[j][i] = key;
+                decayTails[j][i] = 0.0;
+                changed = true;
+            }
+
+            // Also redoes keys the cache has dropped since they were analysed
+            if (key != 0 && !decayAnalyser.isKnown(key))
+                decayAnalyser.request(j * MAX_SLOTS + i, key, slot.get()->createDecaySource(), sampleRate);
+        }
+    }
+
+    // Slots in a chain run in series, so their tails add up; the chains run
+    // side by side. A slot being re-analysed keeps its last tail meanwhile.
+    const int numChains = parallelEnabledParam->load() > 0.5f ? NUM_CHAINS : 1;
+    double longest = 0.0;
+
+    for (int j = 0; j < numChains; j++)
+    {
+        double chainTail = 0.0;
+
+        for (int i = 0; i < MAX_SLOTS; i++)
+        {
+            if (auto result = decayAnalyser.find(decayKeys[j][i]))
+                decayTails[j][i] = result->tailSeconds;
+
+            chainTail += decayTails[j][i];
+        }
+
+        longest = juce::jmax(longest, chainTail);
+    }
+
+    tailLengthSeconds.store(longest, std::memory_order_relaxed);
+
+    if (changed)
+        sendChangeMessage();
+}
+
+std::shared_ptr<const DecayAnalysis::Result> ADSREchoAudioProcessor::getDecayAnalysis(int chainIndex, int slotIndex) const
+{
+    return decayAnalyser.find(decayKeys[chainIndex][slotIndex]);
+}
+
 // Returns SlotInfo struct that contains the id, type, and used parameters of the module in a slot
 SlotInfo ADSREchoAudioProcessor::getSlotInfo(int chainIndex, int slotIndex)
 {
-    auto& slot = slots[chainIndex][slotIndex];
+    auto& slot = rack->slots[chainIndex][slotIndex];
     auto effectModule = slot->get();
-    return { effectModule->getID(), effectModule->getType(), effectModule->getUsedParameters() };
+    return { effectModule->getID(), effectModule->getType(), effectModule->getUsedParameters(), slot->getModuleSerial() };
+}
+
+juce::String ADSREchoAudioProcessor::getMemoryReport()
+{
+    juce::String text;
+    size_t totalBytes = 0;
+
+    for (int j = 0; j < NUM_CHAINS; j++)
+    {
+        for (int i = 0; i < MAX_SLOTS; i++)
+        {
+            auto* mod = rack->slots[j][i]->get();
+
+            if (mod == nullptr)
+                continue;
+
+            const auto report = mod->getMemoryReport();
+            totalBytes += report.totalBytes;
+
+            text << "Chain " << (j + 1) << " slot " << (i + 1) << " (" << mod->getType() << "): "
+                 << report.toString() << "\n";
+        }
+    }
+
+    text << "Total: " << juce::File::descriptionOfSizeInBytes((juce::int64) totalBytes);
+    return text;
 }
 
 bool ADSREchoAudioProcessor::slotIsEmpty(int chainIndex, int slotIndex)
 {
-    return !slots[chainIndex][slotIndex]->get();
+    return !rack->slots[chainIndex][slotIndex]->get();
 }
 
 // Add module of moduleType
 void ADSREchoAudioProcessor::addModule(int chainIndex, ModuleType moduleType)
 {
-    if (numModules[chainIndex] == MAX_SLOTS) { return; }
+    if (rack->numModules[chainIndex] == MAX_SLOTS) { return; }
 
-    for (auto& slot : slots[chainIndex]) {
+    for (auto& slot : rack->slots[chainIndex]) {
         if (slot->get() == nullptr)
         {
             setSlotDefaults(slot->slotID);
-            
-            switch (moduleType)
-            {
-                case ModuleType::Delay:
-                    slot->setModule(std::make_unique<DelayModule>("null", apvts));
-                    break;
-
-                case ModuleType::Reverb:
-                    slot->setModule(std::make_unique<ReverbModule>("null", apvts));
-                    break;
-
-                case ModuleType::Convolution:
-                    auto module = std::make_unique<ConvolutionModule>("null", apvts);
-                    module->setIRBank(irBank);
-                    slot->setModule(std::move(module));
-                    break;
-            }
+            slot->setModule(createModule(moduleType));
 
-            numModules[chainIndex]++;
-            uiNeedsRebuild.store(true, std::memory_order_release);
+            rack->numModules[chainIndex]++;
+            sendChangeMessage();
             return;
         }   
     }
@@ -517,7 +1235,7 @@ void ADSREchoAudioProcessor::addModule(int chainIndex, ModuleType moduleType)
 // Remove module at slotIndex
 void ADSREchoAudioProcessor::removeModule(int chainIndex, int slotIndex)
 {
-    auto& toRemove = slots[chainIndex][slotIndex];
+    auto& toRemove = rack->slots[chainIndex][slotIndex];
     if (toRemove->get() == nullptr)
     {
         DBG("Error: Trying to remove an empty module!");
@@ -525,40 +1243,24 @@ void ADSREchoAudioProcessor::removeModule(int chainIndex, int slotIndex)
     }
 
     toRemove->clearModule();
-    numModules[chainIndex]--;
+    rack->numModules[chainIndex]--;
 
     requestSlotMove(chainIndex, slotIndex, MAX_SLOTS-1);
+    sendChangeMessage();
 }
 
 // Change module at slotIndex to type
 void ADSREchoAudioProcessor::changeModuleType(int chainIndex, int slotIndex, ModuleType moduleType)
 {
-    auto& toChange = slots[chainIndex][slotIndex];
+    auto& toChange = rack->slots[chainIndex][slotIndex];
     if (toChange->get() == nullptr)
     {
         DBG("Error: Trying to change an empty module!");
         return;
     }
 
-    std::unique_ptr<EffectModule> newModule;
-    switch (moduleType)
-    {
-        case ModuleType::Delay:
-            toChange->setModule(std::make_unique<DelayModule>("null", apvts));
-            break;
-
-        case ModuleType::Reverb:
-            toChange->setModule(std::make_unique<ReverbModule>("null", apvts));
-            break;
-
-        case ModuleType::Convolution:
-            auto module = std::make_unique<ConvolutionModule>("null", apvts);
-            module->setIRBank(irBank);  // ADD THIS!
-            toChange->setModule(std::move(module));
-            break;
-    }
-
-    uiNeedsRebuild.store(true, std::memory_order_release);
+    toChange->setModule(createModule(moduleType));
+    sendChangeMessage();
 
 }
 
@@ -571,13 +1273,13 @@ void ADSREchoAudioProcessor::requestSlotMove(int chainIndex, int from, int to)
     moveRequested.store(true, std::memory_order_release);
 }
 
-void ADSREchoAudioProcessor::executeSlotMove()
+void ADSREchoAudioProcessor::executeSlotMove(Rack& target)
 {
     const int chainIndex = pendingMove.chainIndex;
     const int from = pendingMove.from;
     const int to = pendingMove.to;
 
-    auto& chain = slots[chainIndex];
+    auto& chain = target.slots[chainIndex];
 
     if (juce::isPositiveAndBelow(from, MAX_SLOTS) &&
         juce::isPositiveAndBelow(to, MAX_SLOTS) &&
@@ -601,28 +1303,79 @@ void ADSREchoAudioProcessor::executeSlotMove()
         chain[to] = std::move(moved);
     }
 
-    uiNeedsRebuild.store(true, std::memory_order_release);
+    slotsMoved.store(true, std::memory_order_release);
     moveRequested.store(false, std::memory_order_release);
 }
 
 // Reset all parameter values of slot back to default
 void ADSREchoAudioProcessor::setSlotDefaults(juce::String slotID)
 {
-    const auto prefix = slotID + ".";
+    for (const auto& sp : getSlotParameters(slotID))
+        sp.parameter->setValueNotifyingHost(sp.parameter->getDefaultValue());
+}
 
-    for (auto* param : getParameters())
+std::vector<ADSREchoAudioProcessor::SlotParameter>& ADSREchoAudioProcessor::getSlotParameters(const juce::String& slotID)
+{
+    int chainIndex = 0, slotIndex = 0;
+    juce::String suffix;
+
+    RackState::splitSlotParameterID(slotID + ".", chainIndex, slotIndex, suffix);
+    jassert(juce::isPositiveAndBelow(chainIndex, NUM_CHAINS) && juce::isPositiveAndBelow(slotIndex, MAX_SLOTS));
+
+    return slotParameters[chainIndex][slotIndex];
+}
+
+// Load a custom IR into a convolution slot
+void ADSREchoAudioProcessor::loadCustomIR(int chainIndex, int slotIndex, const juce::File& file)
+{
+    auto* conv = dynamic_cast<ConvolutionModule*>(rack->slots[chainIndex][slotIndex]->get());
+    if (conv == nullptr)
     {
-        if (auto* p = dynamic_cast<juce::RangedAudioParameter*>(param))
+        DBG("Error: Trying to load an IR into a non-convolution module!");
+        return;
+    }
+
+    setSelectedSlot(chainIndex, slotIndex);
+    conv->loadIRFile(file);
+}
+
+juce::File ADSREchoAudioProcessor::getCustomIRFile(int chainIndex, int slotIndex)
+{
+    if (auto* conv = dynamic_cast<ConvolutionModule*>(rack->slots[chainIndex][slotIndex]->get()))
+        return conv->getCustomIRFile();
+
+    return {};
+}
+
+// Give the selected slot priority in the IR load queue
+void ADSREchoAudioProcessor::setSelectedSlot(int chainIndex, int slotIndex)
+{
+    for (int j = 0; j < NUM_CHAINS; j++)
+    {
+        for (int i = 0; i < MAX_SLOTS; i++)
         {
-            if (p->getParameterID().startsWith(prefix))
-            {
-                p->setValueNotifyingHost(p->getDefaultValue());
-            }
+            if (auto* conv = dynamic_cast<ConvolutionModule*>(rack->slots[j][i]->get()))
+                conv->setLoadPriority(j == chainIndex && i == slotIndex);
         }
     }
 }
 
 
+bool ADSREchoAudioProcessor::isLoadingIRs() const
+{
+    for (const auto& chain : rack->slots)
+    {
+        for (const auto& slot : chain)
+        {
+            if (auto* conv = dynamic_cast<const ConvolutionModule*>(slot->get()))
+                if (conv->isLoadPending())
+                    return true;
+        }
+    }
+
+    return false;
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -25,17 +25,27 @@
   #include <juce_gui_extra/juce_gui_extra.h>
 #endif
 #include "Modular Classes/ModuleSlot.h"
+#include "Modular Classes/Rack.h"
+#include "Modular Classes/CpuProfiler.h"
+#include "Modular Classes/LevelMeters.h"
+#include "Modular Classes/DecayAnalyser.h"
 #include "Modular Classes/Effect Modules/DelayModule.h"
+#include "Modular Classes/Effect Modules/MultiTapModule.h"
 #include "Modular Classes/Effect Modules/ReverbModule.h"
 #include "Modular Classes/Effect Modules/ConvolutionModule.h"
 #include "Reverb Algorithms/Convolution/IRBank.h"
+#include "RackState.h"
 
 //==============================================================================
 /**
+    Sends a change message whenever slots are added, removed, moved or get a
+    different module, so the editor can update just the affected slots, and
+    when new decay analysis results come in.
 */
 
 
-class ADSREchoAudioProcessor  : public juce::AudioProcessor, public juce::ChangeBroadcaster
+class ADSREchoAudioProcessor  : public juce::AudioProcessor, public juce::ChangeBroadcaster,
+                                private juce::Timer
 {
 public:
     //==============================================================================
@@ -82,20 +92,39 @@ public:
 
     juce::AudioProcessorValueTreeState apvts{ *this, nullptr, "Parameters", createParameterLayout() };
 
-    //std::vector<std::unique_ptr<ModuleSlot>> slots;
-    std::vector<std::vector<std::unique_ptr<ModuleSlot>>> slots;
+    // The current rack, as seen from the message thread
+    Rack& getRack() { return *rack; }
 
     int getNumSlots() const;
     int getNumChains() const;
     SlotInfo getSlotInfo(int chainIndex, int slotIndex);
     bool slotIsEmpty(int chainIndex, int slotIndex);
 
+    // What each slot's delay lines and filter states hold, slot by slot and
+    // piece by piece (message thread)
+    juce::String getMemoryReport();
+
+    // Sample format of the long delay lines in every delay and reverb slot:
+    // what ADSRECHO_DELAY_STORAGE (float32 / fp16 / bf16) asks for, else
+    // float32. Changing it rebuilds the rack with the same settings.
+    void setDelayStorage(DelayStorage storage);
+    DelayStorage getDelayStorage() const { return delayStorage; }
+
     void addModule(int chainIndex, ModuleType moduleType);
     void removeModule(int chainIndex, int slotIndex);
     void changeModuleType(int chainIndex, int slotIndex, ModuleType moduleType);
     void requestSlotMove(int chainIndex, int from, int to);
 
-    std::atomic<bool> uiNeedsRebuild{ false };
+    // Custom IRs (user library / drag and drop) for convolution slots
+    void loadCustomIR(int chainIndex, int slotIndex, const juce::File& file);
+    juce::File getCustomIRFile(int chainIndex, int slotIndex);
+
+    // The slot being edited gets its IR loads serviced first
+    void setSelectedSlot(int chainIndex, int slotIndex);
+
+    // True until every convolution slot has its requested IR installed; offline
+    // renders keep calling processBlock on silence until this clears
+    bool isLoadingIRs() const;
 
     // IR Bank accessor for UI
     std::shared_ptr<IRBank> getIRBank() const { return irBank; }
@@ -103,11 +132,59 @@ public:
     static constexpr int MAX_SLOTS = 8;
     static constexpr int NUM_CHAINS = 2;
 
+    // A/B snapshots for the "morph" parameter. Once both are captured, the
+    // audio thread interpolates every continuous slot and chain parameter
+    // between them; the parameters themselves (and the host) are untouched.
+    void captureSnapshot(int index);    // 0 = A, 1 = B
+    void clearSnapshots();
+    bool hasSnapshot(int index) const;
+
+    // Processing time per slot, chain and callback, for the editor's CPU meters
+    using Profiler = CpuProfiler<NUM_CHAINS, MAX_SLOTS>;
+    Profiler& getCpuProfiler() { return cpuProfiler; }
+
+    // Output level of every slot and chain, and chain spectra, for the editor
+    using Meters = LevelMeters<NUM_CHAINS, MAX_SLOTS>;
+    Meters& getLevelMeters() { return levelMeters; }
+
+    // Background decay analysis (EDCs, octave-band RT60) of each slot's
+    // module, redone when its settings change; also sets the tail length.
+    // nullptr until the slot's current settings have been analysed.
+    std::shared_ptr<const DecayAnalysis::Result> getDecayAnalysis(int chainIndex, int slotIndex) const;
+
+    // Queues analyses for changed slots and collects finished ones. The timer
+    // calls it a few times a second; tests and offline tools can call it
+    // directly and wait for the worker.
+    void updateDecayAnalysis();
+    bool waitForDecayAnalysis(int timeoutMs) const { return decayAnalyser.waitUntilIdle(timeoutMs); }
+
 private:
     juce::dsp::ProcessSpec spec;
 
     std::shared_ptr<IRBank> irBank;
 
+    // Lets parallel convolution slots reuse one forward FFT of the same dry input
+    std::shared_ptr<ConvolutionInputShare> convolutionInputShare;
+
+    TransportService transport;
+
+    Profiler cpuProfiler;
+    Meters levelMeters;
+
+    DecayAnalyser decayAnalyser;
+    juce::uint64 decayKeys[NUM_CHAINS][MAX_SLOTS] {};   // by position; 0 = empty
+    double decayTails[NUM_CHAINS][MAX_SLOTS] {};        // last tail found for the key
+    std::atomic<double> tailLengthSeconds { 0.0 };
+    int decayCheckTicks = 0;
+
+    juce::uint64 getDecayKey(ModuleSlot& slot, double sampleRate);
+
+    // Looked up once; building parameter IDs in processBlock allocates
+    std::atomic<float>* parallelEnabledParam = nullptr;
+    std::atomic<float>* morphParam = nullptr;
+    std::atomic<float>* chainMixParams[NUM_CHAINS] {};
+    std::atomic<float>* chainGainParams[NUM_CHAINS] {};
+
     // Pre-allocated buffer for dry signal (avoids allocation in processBlock)
     juce::AudioBuffer<float> masterDryBuffer;
     juce::AudioBuffer<float> chainTempBuffer;
@@ -121,11 +198,107 @@ private:
 
     std::atomic<bool> moveRequested{ false };
     PendingMove pendingMove;
-    void executeSlotMove();
+    void executeSlotMove(Rack& target);
+
+    // Set by executeSlotMove; the timer turns it into a change message
+    std::atomic<bool> slotsMoved{ false };
+
+    // Modules get the current delay storage before their first prepare()
+    DelayStorage delayStorage = DelayStorage::Float32;
+
+    std::unique_ptr<EffectModule> createModule(const juce::String& type);
+    std::unique_ptr<EffectModule> createModule(ModuleType type);
+    bool describeSlot(ModuleSlot& slot, RackState::Slot& dest);
+
+    //==============================================================================
+    // Morph between the A/B snapshots, compiled into flat arrays on the
+    // message thread. The audio thread only writes out and the last* fields.
+    struct Morph
+    {
+        // APVTS values the modules read: interpolated ones first, then the
+        // ones that switch at the midpoint
+        std::vector<std::atomic<float>*> targets;
+        std::vector<juce::RangedAudioParameter*> parameters;
+        int numInterpolated = 0;
+
+        std::vector<float> a, b, out;
+
+        // Slots whose module type differs between A and B. Their mix fades
+        // out around the midpoint, where the timer swaps the module.
+        struct Fade
+        {
+            int mixTarget = 0;
+            int chainIndex = 0;
+            int slotID = 0;     // number in the slot ID
+        };
+
+        std::vector<Fade> fades;
+        juce::String types[2][NUM_CHAINS][MAX_SLOTS];
+        juce::String irFiles[2][NUM_CHAINS][MAX_SLOTS];
+
+        // -1: neither snapshot's type is installed
+        std::atomic<int> installedSide[NUM_CHAINS][MAX_SLOTS];
+        std::atomic<int> installGeneration{ 0 };
+        std::atomic<int> wantedSide{ 0 };
+
+        float lastMorph = -1.0f;
+        int lastGeneration = -1;
+    };
+
+    RackState::Snapshot snapshots[2];
+    bool snapshotCaptured[2] { false, false };
+
+    std::unique_ptr<Morph> morph;
+    std::atomic<Morph*> activeMorph{ nullptr };
+
+    void rebuildMorph();
+    void applyMorph(Morph& m);
+    void timerCallback() override;
+
+    ModuleSlot* findSlot(int chainIndex, int slotID);
+    int findSlotPosition(int chainIndex, int slotID);
+
+    //==============================================================================
+    // The message thread owns `rack` and `morph`; processBlock reads the
+    // active pointers once per callback. Whatever they replace is kept until
+    // no callback can still be using it: callbackCount is odd while
+    // processBlock runs, so anything retired at an even count, or once the
+    // count has moved on, is safe to delete.
+    std::unique_ptr<Rack> rack;
+    std::atomic<Rack*> activeRack{ nullptr };
+    std::atomic<juce::uint32> callbackCount{ 0 };
+
+    struct Retired
+    {
+        std::unique_ptr<Rack> rack;
+        std::unique_ptr<Morph> morph;
+        juce::uint32 callbackCount = 0;
+    };
+
+    std::vector<Retired> retired;
+
+    void publishRack(std::unique_ptr<Rack> newRack);
+    void publishMorph(std::unique_ptr<Morph> newMorph);
+    void releaseRetired();
 
     void setSlotDefaults(juce::String slotID);
 
-    std::vector<int> numModules = std::vector<int>(NUM_CHAINS, 0);
+    // Parameters grouped once, so saving and loading only visit the globals
+    // and the populated slots. Slot lists are indexed by the number in the
+    // slot ID, which stays with the ModuleSlot when slots are moved.
+    struct SlotParameter
+    {
+        juce::String suffix;    // ID without the "chain_N.slot_M." prefix
+        juce::RangedAudioParameter* parameter = nullptr;
+        std::atomic<float>* value = nullptr;    // as the modules (and the morph) see it
+    };
+
+    std::vector<juce::RangedAudioParameter*> globalParameters;
+    std::vector<SlotParameter> slotParameters[NUM_CHAINS][MAX_SLOTS];
+
+    std::vector<SlotParameter>& getSlotParameters(const juce::String& slotID);
+    RackState captureRackState();
+    void restoreRackState(const RackState& state);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ADSREchoAudioProcessor)
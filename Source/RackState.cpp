@@ -0,0 +1,360 @@
+#include "RackState.h"
+
+// Layout (little-endian; counts and indices use JUCE's compressed ints):
+//
+//   "AERS", version byte
+//   string count, then that many null-terminated UTF-8 strings
+//   values: count, then (ID string index, float value) pairs
+//   slots: count, then per slot:
+//       chain byte, slot byte, type string index,
+//       IR file string index + 1 (0 = none),
+//       values (parameter suffixes instead of full IDs)
+//   version 2: snapshot count, then per snapshot:
+//       index byte, values, slots
+
+static const char binaryMagic[4] = { 'A', 'E', 'R', 'S' };
+
+namespace
+{
+    using Values = std::vector<std::pair<juce::String, float>>;
+
+    class StringTable
+    {
+    public:
+        int add(const juce::String& s)
+        {
+            if (indices.contains(s))
+                return indices[s];
+
+            indices.set(s, strings.size());
+            strings.add(s);
+            return strings.size() - 1;
+        }
+
+        void addAll(const Values& values)
+        {
+            for (const auto& v : values)
+                add(v.first);
+        }
+
+        void addAll(const std::vector<RackState::Slot>& slots)
+        {
+            for (const auto& slot : slots)
+            {
+                add(slot.type);
+
+                if (slot.irFile.isNotEmpty())
+                    add(slot.irFile);
+
+                addAll(slot.parameters);
+            }
+        }
+
+        const juce::StringArray& getStrings() const { return strings; }
+
+    private:
+        juce::StringArray strings;
+        juce::HashMap<juce::String, int> indices;
+    };
+
+    //==============================================================================
+    // Every string is in the table by the time these run
+    void writeValues(juce::OutputStream& out, StringTable& table, const Values& values)
+    {
+        out.writeCompressedInt((int) values.size());
+
+        for (const auto& v : values)
+        {
+            out.writeCompressedInt(table.add(v.first));
+            out.writeFloat(v.second);
+        }
+    }
+
+    void writeSlots(juce::OutputStream& out, StringTable& table, const std::vector<RackState::Slot>& slots)
+    {
+        out.writeCompressedInt((int) slots.size());
+
+        for (const auto& slot : slots)
+        {
+            out.writeByte((char) slot.chainIndex);
+            out.writeByte((char) slot.slotIndex);
+            out.writeCompressedInt(table.add(slot.type));
+            out.writeCompressedInt(slot.irFile.isNotEmpty() ? table.add(slot.irFile) + 1 : 0);
+            writeValues(out, table, slot.parameters);
+        }
+    }
+
+    //==============================================================================
+    // The stream reads zeros past the end, so every read is checked first
+    class Reader
+    {
+    public:
+        Reader(const void* data, int sizeInBytes)
+            : in(data, (size_t) sizeInBytes, false)
+        {
+        }
+
+        bool hasBytes(int numBytes) const { return in.getNumBytesRemaining() >= numBytes; }
+
+        bool readByte(int& dest)
+        {
+            if (!hasBytes(1))
+                return false;
+
+            dest = (int) (juce::uint8) in.readByte();
+            return true;
+        }
+
+        // Every record is at least one byte, so no count can exceed what is left
+        bool readCount(int& dest)
+        {
+            if (!hasBytes(1))
+                return false;
+
+            dest = in.readCompressedInt();
+            return dest >= 0 && dest <= (int) in.getNumBytesRemaining();
+        }
+
+        bool readStrings()
+        {
+            int numStrings = 0;
+
+            if (!readCount(numStrings))
+                return false;
+
+            strings.ensureStorageAllocated(numStrings);
+
+            for (int i = 0; i < numStrings; ++i)
+                strings.add(in.readString());
+
+            return true;
+        }
+
+        bool readStringIndex(juce::String& dest)
+        {
+            if (!hasBytes(1))
+                return false;
+
+            const int index = in.readCompressedInt();
+
+            if (!juce::isPositiveAndBelow(index, strings.size()))
+                return false;
+
+            dest = strings[index];
+            return true;
+        }
+
+        bool readValues(Values& values)
+        {
+            int numValues = 0;
+
+            if (!readCount(numValues))
+                return false;
+
+            values.resize((size_t) numValues);
+
+            for (auto& v : values)
+            {
+                if (!readStringIndex(v.first) || !hasBytes(4))
+                    return false;
+
+                v.second = in.readFloat();
+            }
+
+            return true;
+        }
+
+        bool readSlots(std::vector<RackState::Slot>& slots)
+        {
+            int numSlots = 0;
+
+            if (!readCount(numSlots))
+                return false;
+
+            slots.resize((size_t) numSlots);
+
+            for (auto& slot : slots)
+            {
+                if (!readByte(slot.chainIndex) || !readByte(slot.slotIndex) || !readStringIndex(slot.type))
+                    return false;
+
+                if (!hasBytes(1))
+                    return false;
+
+                const int irFileIndex = in.readCompressedInt();
+
+                if (irFileIndex > 0)
+                {
+                    if (irFileIndex > strings.size())
+                        return false;
+
+                    slot.irFile = strings[irFileIndex - 1];
+                }
+
+                if (!readValues(slot.parameters))
+                    return false;
+            }
+
+            return true;
+        }
+
+        juce::MemoryInputStream in;
+        juce::StringArray strings;
+    };
+}
+
+void RackState::writeBinary(juce::MemoryBlock& dest) const
+{
+    // Strings first, so the table can be written ahead of the records
+    StringTable table;
+    table.addAll(globals);
+    table.addAll(slots);
+
+    for (const auto& snapshot : snapshots)
+    {
+        table.addAll(snapshot.globals);
+        table.addAll(snapshot.slots);
+    }
+
+    juce::MemoryOutputStream out(dest, false);
+
+    out.write(binaryMagic, sizeof(binaryMagic));
+    out.writeByte((char) currentVersion);
+
+    out.writeCompressedInt(table.getStrings().size());
+
+    for (const auto& s : table.getStrings())
+        out.writeString(s);
+
+    writeValues(out, table, globals);
+    writeSlots(out, table, slots);
+
+    out.writeCompressedInt((int) snapshots.size());
+
+    for (const auto& snapshot : snapshots)
+    {
+        out.writeByte((char) snapshot.index);
+        writeValues(out, table, snapshot.globals);
+        writeSlots(out, table, snapshot.slots);
+    }
+}
+
+bool RackState::isBinary(const void* data, int sizeInBytes)
+{
+    return data != nullptr
+        && sizeInBytes > (int) sizeof(binaryMagic)
+        && std::memcmp(data, binaryMagic, sizeof(binaryMagic)) == 0;
+}
+
+bool RackState::readBinary(const void* data, int sizeInBytes, RackState& result)
+{
+    if (!isBinary(data, sizeInBytes))
+        return false;
+
+    Reader reader(data, sizeInBytes);
+    reader.in.skipNextBytes(sizeof(binaryMagic));
+
+    int version = 0;
+
+    if (!reader.readByte(version) || version < 1 || version > currentVersion)
+    {
+        DBG("Rack state version " + juce::String(version) + " is not supported by this build");
+        return false;
+    }
+
+    RackState state;
+
+    if (!reader.readStrings() || !reader.readValues(state.globals) || !reader.readSlots(state.slots))
+        return false;
+
+    if (version >= 2)
+    {
+        int numSnapshots = 0;
+
+        if (!reader.readCount(numSnapshots))
+            return false;
+
+        state.snapshots.resize((size_t) numSnapshots);
+
+        for (auto& snapshot : state.snapshots)
+        {
+            if (!reader.readByte(snapshot.index)
+                || !reader.readValues(snapshot.globals)
+                || !reader.readSlots(snapshot.slots))
+                return false;
+        }
+    }
+
+    result = std::move(state);
+    return true;
+}
+
+bool RackState::splitSlotParameterID(const juce::String& id, int& chainIndex, int& slotIndex, juce::String& suffix)
+{
+    // chain_<c>.slot_<s>.<suffix>
+    if (!id.startsWith("chain_"))
+        return false;
+
+    const int slotStart = id.indexOf(".slot_");
+
+    if (slotStart < 0)
+        return false;
+
+    const int suffixStart = id.indexOfChar(slotStart + 1, '.');
+
+    if (suffixStart < 0)
+        return false;
+
+    chainIndex = id.substring(6, slotStart).getIntValue();
+    slotIndex = id.substring(slotStart + 6, suffixStart).getIntValue();
+    suffix = id.substring(suffixStart + 1);
+    return true;
+}
+
+RackState RackState::fromValueTree(const juce::ValueTree& state)
+{
+    RackState result;
+
+    for (auto chainState : state.getChildWithName("Modules"))
+    {
+        for (auto slotState : chainState)
+        {
+            Slot slot;
+            slot.chainIndex = (int) chainState["index"];
+            slot.slotIndex = (int) slotState["index"];
+            slot.type = slotState["type"].toString();
+            slot.irFile = slotState["irFile"].toString();
+
+            result.slots.push_back(std::move(slot));
+        }
+    }
+
+    for (auto child : state)
+    {
+        if (!child.hasType("PARAM"))
+            continue;
+
+        const auto id = child["id"].toString();
+        const float value = (float) child["value"];
+
+        int chainIndex, slotIndex;
+        juce::String suffix;
+
+        if (!splitSlotParameterID(id, chainIndex, slotIndex, suffix))
+        {
+            result.globals.emplace_back(id, value);
+            continue;
+        }
+
+        for (auto& slot : result.slots)
+        {
+            if (slot.chainIndex == chainIndex && slot.slotIndex == slotIndex)
+            {
+                slot.parameters.emplace_back(suffix, value);
+                break;
+            }
+        }
+    }
+
+    return result;
+}
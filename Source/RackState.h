@@ -0,0 +1,66 @@
+// RackState.h - Saved rack: the modules in each slot and the parameter values
+// that differ from their defaults
+//
+// getStateInformation writes it in a compact, versioned binary form: a string
+// table (parameter IDs, module types, IR paths) followed by the global/chain
+// values and one record per populated slot. Empty slots and default values
+// take no space, so blob size and load time follow the populated slots rather
+// than the ~1,000 parameters of the full layout. Sessions saved before the
+// binary format (APVTS XML with a Modules child) are imported by
+// fromValueTree. Version 2 adds the A/B morph snapshots, stored the same way.
+
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_core/juce_core.h>
+  #include <juce_data_structures/juce_data_structures.h>
+#endif
+
+struct RackState
+{
+    struct Slot
+    {
+        int chainIndex = 0;
+        int slotIndex = 0;
+        juce::String type;       // EffectModule::getType()
+        juce::String irFile;     // custom IR of a convolution slot, if any
+
+        // Parameter ID without the "chain_N.slot_M." prefix -> plain value
+        std::vector<std::pair<juce::String, float>> parameters;
+    };
+
+    // Global and chain parameters: full ID -> plain value
+    std::vector<std::pair<juce::String, float>> globals;
+    std::vector<Slot> slots;
+
+    // A captured morph snapshot: module types and non-default values
+    struct Snapshot
+    {
+        int index = 0;          // 0 = A, 1 = B
+        std::vector<std::pair<juce::String, float>> globals;
+        std::vector<Slot> slots;
+    };
+
+    std::vector<Snapshot> snapshots;
+
+    //==============================================================================
+    static constexpr int currentVersion = 2;
+
+    void writeBinary(juce::MemoryBlock& dest) const;
+
+    // True if the data starts with the binary format's magic number
+    static bool isBinary(const void* data, int sizeInBytes);
+
+    // Fails on truncated or corrupt data and on versions newer than this build
+    static bool readBinary(const void* data, int sizeInBytes, RackState& result);
+
+    // Pre-binary sessions: the APVTS tree, with every parameter, plus Modules.
+    // Only the values of populated slots are kept.
+    static RackState fromValueTree(const juce::ValueTree& state);
+
+    // "chain_0.slot_3.mix" -> chain 0, slot 3, "mix"; false for global and
+    // chain parameters
+    static bool splitSlotParameterID(const juce::String& id, int& chainIndex, int& slotIndex, juce::String& suffix);
+};
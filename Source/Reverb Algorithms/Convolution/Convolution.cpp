@@ -1,8 +1,186 @@
 #include "Convolution.h"
 #include "IRBank.h"
 
-Convolution::Convolution() {}
-Convolution::~Convolution() {}
+//==============================================================================
+// IR file helpers
+//==============================================================================
+
+static bool readImpulseResponse(std::unique_ptr<juce::AudioFormatReader> reader,
+                                juce::AudioBuffer<float>& dest,
+                                double& sampleRate,
+                                int maxSeconds)
+{
+    if (reader == nullptr)
+        return false;
+
+    const auto maxLength  = (juce::int64) (maxSeconds * reader->sampleRate);
+    const int numSamples  = (int) juce::jmin(reader->lengthInSamples, maxLength);
+    const int numChannels = juce::jmin(4, (int) reader->numChannels);
+
+    if (numSamples <= 0 || numChannels <= 0)
+        return false;
+
+    dest.setSize(numChannels, numSamples);
+    reader->read(&dest, 0, numSamples, 0, true, true);
+    sampleRate = reader->sampleRate;
+
+    return true;
+}
+
+// Two stereo files, one per source speaker: LL/LR from the left file, RL/RR from the right
+static bool readTrueStereoPair(juce::AudioFormatManager& formats,
+                               const juce::File& leftFile,
+                               const juce::File& rightFile,
+                               juce::AudioBuffer<float>& dest,
+                               double& sampleRate,
+                               int maxSeconds)
+{
+    juce::AudioBuffer<float> left, right;
+    double leftRate = 0.0, rightRate = 0.0;
+
+    if (!readImpulseResponse(std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(leftFile)),
+                             left, leftRate, maxSeconds)
+        || !readImpulseResponse(std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(rightFile)),
+                                right, rightRate, maxSeconds)
+        || leftRate != rightRate)
+        return false;
+
+    dest.setSize(4, juce::jmax(left.getNumSamples(), right.getNumSamples()));
+    dest.clear();
+
+    dest.copyFrom(0, 0, left,  0,                                 0, left.getNumSamples());
+    dest.copyFrom(1, 0, left,  juce::jmin(1, left.getNumChannels() - 1),  0, left.getNumSamples());
+    dest.copyFrom(2, 0, right, 0,                                 0, right.getNumSamples());
+    dest.copyFrom(3, 0, right, juce::jmin(1, right.getNumChannels() - 1), 0, right.getNumSamples());
+
+    sampleRate = leftRate;
+    return true;
+}
+
+static void resampleImpulseResponse(juce::AudioBuffer<float>& ir, double sourceRate, double targetRate)
+{
+    if (sourceRate <= 0.0 || targetRate <= 0.0 || std::abs(sourceRate - targetRate) < 1.0)
+        return;
+
+    const double ratio   = sourceRate / targetRate;
+    const int inLength   = ir.getNumSamples();
+    const int outLength  = (int) std::ceil((double) inLength / ratio);
+
+    juce::AudioBuffer<float> resampled(ir.getNumChannels(), outLength);
+
+    // Lagrange reads a few samples ahead; give it zeros to read
+    std::vector<float> padded((size_t) inLength + 16, 0.0f);
+
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    {
+        std::copy(ir.getReadPointer(ch), ir.getReadPointer(ch) + inLength, padded.begin());
+
+        juce::LagrangeInterpolator interpolator;
+        interpolator.process(ratio, padded.data(), resampled.getWritePointer(ch), outLength);
+    }
+
+    ir = std::move(resampled);
+}
+
+// Same energy normalisation juce::dsp::Convolution applies with Normalise::yes,
+// so IR loudness matches the previous engine
+static void normaliseImpulseResponse(juce::AudioBuffer<float>& ir)
+{
+    float maxSumSquared = 0.0f;
+
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    {
+        const float* data = ir.getReadPointer(ch);
+        float sumSquared = 0.0f;
+
+        for (int i = 0; i < ir.getNumSamples(); ++i)
+            sumSquared += data[i] * data[i];
+
+        maxSumSquared = juce::jmax(maxSumSquared, sumSquared);
+    }
+
+    if (maxSumSquared > 0.0f)
+        ir.applyGain(0.125f / std::sqrt(maxSumSquared));
+}
+
+// Low/high cut and tilt baked into the IR, so the wet path needs no filters.
+// Uses the same 2nd-order responses the wet-path biquads used to apply.
+static void applyTone(juce::AudioBuffer<float>& ir, double sampleRate,
+                      float lowCutHz, float highCutHz, float tiltDb)
+{
+    const float sr = (float) sampleRate;
+
+    // Ensure low cut is below high cut with proper limits
+    const float lowHz  = juce::jlimit(10.0f, sr * 0.45f, lowCutHz);
+    const float highHz = juce::jlimit(lowHz + 10.0f, sr * 0.49f, highCutHz);
+
+    using Coefficients = juce::dsp::IIR::Coefficients<float>;
+
+    auto lowCut  = Coefficients::makeHighPass(sr, lowHz, 1.0f);
+    auto highCut = Coefficients::makeLowPass(sr, highHz, 1.0f);
+
+    // Tilt pivots around 1 kHz: half the gain on each side
+    const bool useTilt = std::abs(tiltDb) > 0.05f;
+    auto tiltLow  = Coefficients::makeLowShelf(sr, 1000.0f, 0.707f, juce::Decibels::decibelsToGain(-0.5f * tiltDb));
+    auto tiltHigh = Coefficients::makeHighShelf(sr, 1000.0f, 0.707f, juce::Decibels::decibelsToGain(0.5f * tiltDb));
+
+    // Room for the filters to ring out past the end of the IR
+    const int ringOut = (int) (0.05 * sampleRate);
+    juce::AudioBuffer<float> shaped(ir.getNumChannels(), ir.getNumSamples() + ringOut);
+    shaped.clear();
+
+    int length = 1;
+
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    {
+        shaped.copyFrom(ch, 0, ir, ch, 0, ir.getNumSamples());
+
+        juce::dsp::IIR::Filter<float> lowFilter(lowCut), highFilter(highCut);
+        juce::dsp::IIR::Filter<float> tiltLowFilter(tiltLow), tiltHighFilter(tiltHigh);
+
+        float* data = shaped.getWritePointer(ch);
+
+        for (int i = 0; i < shaped.getNumSamples(); ++i)
+        {
+            float x = highFilter.processSample(lowFilter.processSample(data[i]));
+
+            if (useTilt)
+                x = tiltHighFilter.processSample(tiltLowFilter.processSample(x));
+
+            data[i] = x;
+        }
+
+        // Drop the ring-out once it is inaudible (-100 dB below the peak)
+        const float threshold = shaped.getMagnitude(ch, 0, shaped.getNumSamples()) * 1.0e-5f;
+        int last = shaped.getNumSamples() - 1;
+
+        while (last > 0 && std::abs(data[last]) <= threshold)
+            --last;
+
+        length = juce::jmax(length, last + 1);
+    }
+
+    shaped.setSize(shaped.getNumChannels(), length, true);
+    ir = std::move(shaped);
+}
+
+//==============================================================================
+
+Convolution::Convolution()
+{
+    loadQueue->registerClient(loader);
+}
+
+Convolution::~Convolution()
+{
+    loadQueue->unregisterClient(loader.get());
+}
+
+Convolution::Loader::~Loader()
+{
+    delete pendingUpdate.exchange(nullptr);
+    delete retiredUpdate.exchange(nullptr);
+}
 
 void Convolution::prepare(const juce::dsp::ProcessSpec& spec)
 {
@@ -12,8 +190,27 @@ void Convolution::prepare(const juce::dsp::ProcessSpec& spec)
     // Reset all state first
     reset();
 
-    // Convolver
-    convolver.prepare(spec);
+    // Convolver - partitions depend on the block size, so the IR is rebuilt
+    convolver.prepare((int) spec.maximumBlockSize, spec.sampleRate);
+
+    loader->loadSampleRate.store(spec.sampleRate);
+    loader->loadPartitionSize.store(convolver.getPartitionSize());
+    loader->loadHistoryCapacity.store(convolver.getHistoryCapacity());
+    ++loader->loadGeneration;
+
+    delete loader->pendingUpdate.exchange(nullptr);
+
+    IRSource source;
+    {
+        const juce::ScopedLock sl(loader->sourceLock);
+        source = loader->currentSource;
+    }
+
+    if (auto update = loader->createUpdate(source))
+    {
+        convolver.install(*update);
+        loader->loadHistoryCapacity.store(convolver.getHistoryCapacity());
+    }
 
     // Pre-delay
     preDelayL.prepare(spec);
@@ -26,15 +223,6 @@ void Convolution::prepare(const juce::dsp::ProcessSpec& spec)
 
     updatePreDelay();
 
-    // Filters
-    juce::dsp::ProcessSpec filterSpec = spec;
-    lowCutL.prepare(filterSpec);
-    lowCutR.prepare(filterSpec);
-    highCutL.prepare(filterSpec);
-    highCutR.prepare(filterSpec);
-
-    updateFilters();
-
     // Dry/Wet mixer - SIMD optimized
     dryWetMixer.prepare(spec);
     
@@ -47,10 +235,6 @@ void Convolution::reset()
     convolver.reset();
     preDelayL.reset();
     preDelayR.reset();
-    lowCutL.reset();
-    lowCutR.reset();
-    highCutL.reset();
-    highCutR.reset();
     dryWetMixer.reset();
 }
 
@@ -72,33 +256,6 @@ void Convolution::updatePreDelay()
     }
 }
 
-void Convolution::updateFilters()
-{
-    if (!prepared)
-        return;
-
-    const float sr = (float) currentSampleRate;
-
-    // Ensure low cut is below high cut with proper limits
-    const float lowHz  = juce::jlimit(10.0f, sr * 0.45f, parameters.lowCutHz);
-    const float highHz = juce::jlimit(lowHz + 10.0f, sr * 0.49f, parameters.highCutHz);
-
-    // Use Q=1.0 for better resonance control (steeper slope)
-    auto lowCoeffs  = juce::dsp::IIR::Coefficients<float>::makeHighPass(sr, lowHz, 1.0f);
-    auto highCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowPass(sr, highHz, 1.0f);
-
-    lowCutL.coefficients  = lowCoeffs;
-    lowCutR.coefficients  = lowCoeffs;
-    highCutL.coefficients = highCoeffs;
-    highCutR.coefficients = highCoeffs;
-
-    // Snap to zero to prevent zipper noise
-    lowCutL.snapToZero();
-    lowCutR.snapToZero();
-    highCutL.snapToZero();
-    highCutR.snapToZero();
-}
-
 ConvolutionParameters& Convolution::getParameters()
 {
     return parameters;
@@ -112,10 +269,11 @@ void Convolution::setParameters(const ConvolutionParameters& newParams)
     // Check what changed with thresholds to avoid floating-point noise triggering updates
     bool preDelayChanged = std::abs(newParams.preDelay - parameters.preDelay) > 0.1f;
     
-    bool filtersChanged = std::abs(newParams.lowCutHz - parameters.lowCutHz) > 1.0f ||
-                          std::abs(newParams.highCutHz - parameters.highCutHz) > 1.0f;
+    bool toneChanged = std::abs(newParams.lowCutHz - parameters.lowCutHz) > 1.0f ||
+                       std::abs(newParams.highCutHz - parameters.highCutHz) > 1.0f ||
+                       std::abs(newParams.tiltDb - parameters.tiltDb) > 0.05f;
     
-    bool irChanged = (newParams.irIndex != oldIRIndex);
+    bool irChanged = (newParams.irIndex != oldIRIndex) || !parametersReceived;
 
     // Update parameters
     parameters = newParams;
@@ -123,11 +281,21 @@ void Convolution::setParameters(const ConvolutionParameters& newParams)
     if (preDelayChanged)
         updatePreDelay();
 
-    if (filtersChanged)
-        updateFilters();
+    if (toneChanged)
+        requestToneRebuild();
     
     if (irChanged)
-        loadIRAtIndex(newParams.irIndex);
+    {
+        // The first update only restores the bank selection when no custom IR
+        // was loaded; any later move of the IR parameter switches back to the bank
+        if (parametersReceived)
+            customIRActive.store(false);
+
+        if (!customIRActive.load())
+            loadIRAtIndex(newParams.irIndex);
+    }
+
+    parametersReceived = true;
 }
 
 void Convolution::processBlock(juce::AudioBuffer<float>& buffer,
@@ -167,35 +335,17 @@ void Convolution::processBlock(juce::AudioBuffer<float>& buffer,
         }
     }
 
-    // 2) Convolution on wet path
-    {
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        convolver.process(context);
-    }
-
-    // 3) Tone shaping filters on wet path
-    if (numChannels >= 1)
-    {
-        juce::dsp::AudioBlock<float> block(buffer);
-
-        // Process channel 0
-        auto ch0 = block.getSingleChannelBlock(0);
-        juce::dsp::ProcessContextReplacing<float> ctx0(ch0);
-        lowCutL.process(ctx0);
-        highCutL.process(ctx0);
-
-        // Process channel 1 if stereo
-        if (numChannels >= 2)
-        {
-            auto ch1 = block.getSingleChannelBlock(1);
-            juce::dsp::ProcessContextReplacing<float> ctx1(ch1);
-            lowCutR.process(ctx1);
-            highCutR.process(ctx1);
-        }
-    }
-
-    // 4) Apply IR gain to wet - SIMD optimized with smoothing
+    // 2) Convolution on wet path (one forward FFT per input channel,
+    //    shared by all IR paths; one inverse FFT per output channel).
+    //    Low/high cut and tilt are already part of the IR.
+    installPendingUpdate();
+    convolver.setCrossPathsEnabled(parameters.trueStereo);
+    convolver.process(buffer.getArrayOfReadPointers(),
+                      buffer.getArrayOfWritePointers(),
+                      numChannels,
+                      numSamples);
+
+    // 3) Apply IR gain to wet - SIMD optimized with smoothing
     smoothedIRGain.setTargetValue(juce::Decibels::decibelsToGain(parameters.irGainDb));
     
     if (smoothedIRGain.isSmoothing())
@@ -219,133 +369,354 @@ void Convolution::processBlock(juce::AudioBuffer<float>& buffer,
         }
     }
 
-    // 5) Dry/wet mix - automatically handled by DryWetMixer (SIMD optimized)
+    // 4) Dry/wet mix - automatically handled by DryWetMixer (SIMD optimized)
     dryWetMixer.mixWetSamples(juce::dsp::AudioBlock<float>(buffer));
 }
 
+// Audio thread: only records the new tone, the load queue rebuilds the IR
+void Convolution::requestToneRebuild()
+{
+    loader->toneLowCutHz.store(parameters.lowCutHz);
+    loader->toneHighCutHz.store(parameters.highCutHz);
+    loader->toneTiltDb.store(parameters.tiltDb);
+    loader->toneRequested.store(true);
+}
+
 // IR loading helpers
-void Convolution::loadIR(const juce::File& file)
+std::unique_ptr<PartitionedConvolver::Update> Convolution::Loader::createUpdate(const IRSource& source)
 {
-    if (!file.existsAsFile())
+    // Read the generation first: a prepare() during the build invalidates the result
+    const int generation = loadGeneration.load();
+    const double sampleRate = loadSampleRate.load();
+    const int partitionSize = loadPartitionSize.load();
+
+    if (partitionSize <= 0 || sampleRate <= 0.0 || !source.isValid())
+        return nullptr;
+
+    juce::AudioBuffer<float> ir;
+
+    if (source.bankIndex == 0)
     {
-        DBG("Convolution::loadIR - ERROR: File does not exist: " + file.getFullPathName());
-        return;
+        // Explicit bypass IR: unity impulse, not normalised
+        ir.setSize(1, 1);
+        ir.setSample(0, 0, 1.0f);
     }
-
-    try
+    else
     {
-        convolver.loadImpulseResponse(file,
-                                      juce::dsp::Convolution::Stereo::yes,
-                                      juce::dsp::Convolution::Trim::no,
-                                      0); // use full IR length
-        
-        DBG("Convolution::loadIR - Successfully loaded: " + file.getFullPathName());
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        double irSampleRate = sampleRate;
+        bool loaded = false;
+
+        if (source.data.getSize() > 0)
+        {
+            loaded = readImpulseResponse(
+                std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(
+                    std::make_unique<juce::MemoryInputStream>(source.data, false))),
+                ir, irSampleRate, kMaxIRSeconds);
+        }
+        else if (source.pairedFile.existsAsFile())
+        {
+            loaded = readTrueStereoPair(formats, source.file, source.pairedFile,
+                                        ir, irSampleRate, kMaxIRSeconds);
+        }
+        else
+        {
+            loaded = readImpulseResponse(
+                std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(source.file)),
+                ir, irSampleRate, kMaxIRSeconds);
+        }
+
+        if (!loaded)
+        {
+            DBG("Convolution::createUpdate - ERROR: Could not read IR: " + source.file.getFullPathName());
+            return nullptr;
+        }
+
+        // The owner went away while the file was being read
+        if (isCancelled())
+            return nullptr;
+
+        resampleImpulseResponse(ir, irSampleRate, sampleRate);
+        normaliseImpulseResponse(ir);
     }
-    catch (const std::exception& e)
+
+    // Keep the untouched IR so tone changes don't have to read the file again
     {
-        DBG("Convolution::loadIR - Exception loading IR: " + juce::String(e.what()));
+        const juce::ScopedLock sl(buildLock);
+        cachedIR = ir;
+        cachedIRSampleRate = sampleRate;
     }
+
+    return createToneUpdate(ir, sampleRate, partitionSize, generation);
 }
 
-void Convolution::loadIRFromMemory(const void* data,
-                                   size_t dataSize,
-                                   double sampleRate,
-                                   int numChannels)
+// Loader thread: rebuild the cached IR with the current tone settings
+std::unique_ptr<PartitionedConvolver::Update> Convolution::Loader::createToneUpdate()
 {
-    juce::ignoreUnused(sampleRate, numChannels);
+    const int generation = loadGeneration.load();
+    const double sampleRate = loadSampleRate.load();
+    const int partitionSize = loadPartitionSize.load();
 
-    if (data == nullptr || dataSize == 0)
+    juce::AudioBuffer<float> ir;
     {
-        DBG("Convolution::loadIRFromMemory - ERROR: Invalid data or size");
-        return;
-    }
+        const juce::ScopedLock sl(buildLock);
 
-    try
-    {
-        convolver.loadImpulseResponse(data,
-                                      dataSize,
-                                      juce::dsp::Convolution::Stereo::yes,
-                                      juce::dsp::Convolution::Trim::no,
-                                      0);
-        
-        DBG("Convolution::loadIRFromMemory - Successfully loaded IR from memory");
-    }
-    catch (const std::exception& e)
-    {
-        DBG("Convolution::loadIRFromMemory - Exception: " + juce::String(e.what()));
+        // Nothing loaded yet, or built for another rate (prepare() rebuilds it)
+        if (cachedIR.getNumSamples() == 0 || cachedIRSampleRate != sampleRate)
+            return nullptr;
+
+        ir = cachedIR;
     }
+
+    if (partitionSize <= 0)
+        return nullptr;
+
+    return createToneUpdate(ir, sampleRate, partitionSize, generation);
 }
 
-// IR Bank Management
-void Convolution::setIRBank(std::shared_ptr<IRBank> bank)
+std::unique_ptr<PartitionedConvolver::Update> Convolution::Loader::createToneUpdate(juce::AudioBuffer<float>& ir,
+                                                                                    double sampleRate,
+                                                                                    int partitionSize,
+                                                                                    int generation) const
 {
-    irBank = bank;
-    
-    // Load first IR if available
-    if (irBank && irBank->getNumIRs() > 0)
+    if (isCancelled())
+        return nullptr;
+
+    applyTone(ir, sampleRate, toneLowCutHz.load(), toneHighCutHz.load(), toneTiltDb.load());
+
+    auto update = std::make_unique<PartitionedConvolver::Update>();
+    update->ir  = ImpulseResponseData::create(ir, partitionSize);
+    update->tag = generation;
+
+    // The frequency-domain input history only grows
+    if (update->ir->numPartitions > loadHistoryCapacity.load())
+        update->history = std::make_unique<ConvolutionInputHistory>(partitionSize, update->ir->numPartitions);
+
+    return update;
+}
+
+void Convolution::Loader::publishUpdate(std::unique_ptr<PartitionedConvolver::Update> update)
+{
+    if (update == nullptr || isCancelled())
+        return;
+
+    // Replace anything the audio thread has not picked up yet
+    delete pendingUpdate.exchange(update.release(), std::memory_order_acq_rel);
+}
+
+// Audio thread: lock-free handover, nothing is allocated or freed here
+void Convolution::installPendingUpdate()
+{
+    // Wait until the loader has freed the last swapped-out IR
+    if (loader->retiredUpdate.load(std::memory_order_acquire) != nullptr)
+        return;
+
+    auto* update = loader->pendingUpdate.exchange(nullptr, std::memory_order_acq_rel);
+
+    if (update == nullptr)
+        return;
+
+    if (update->tag == loader->loadGeneration.load()
+        && update->ir != nullptr
+        && update->ir->partitionSize == convolver.getPartitionSize())
     {
-        loadIRAtIndex(0);
+        convolver.install(*update);
+        loader->loadHistoryCapacity.store(convolver.getHistoryCapacity());
     }
+
+    loader->retiredUpdate.store(update, std::memory_order_release);
 }
 
-void Convolution::loadIRAtIndex(int index)
+// Loader thread
+bool Convolution::Loader::hasPendingLoad() const
+{
+    return sourceRequested.load() || requestedIRIndex.load() >= 0 || toneRequested.load();
+}
+
+// Loader thread
+void Convolution::Loader::serviceLoad()
 {
-    if (!irBank)
+    loadInProgress.store(true);
+    serviceRequests();
+    loadInProgress.store(false);
+}
+
+// Loader thread: custom files first, so a bank request made after them wins
+void Convolution::Loader::serviceRequests()
+{
+    if (sourceRequested.exchange(false))
     {
-        DBG("Convolution::loadIRAtIndex - ERROR: No IR bank set");
-        return;
+        IRSource source;
+        {
+            const juce::ScopedLock sl(sourceLock);
+            source = requestedSource;
+            currentSource = source;
+        }
+
+        // Built with the latest tone settings anyway
+        toneRequested.store(false);
+
+        if (auto update = createUpdate(source))
+        {
+            publishUpdate(std::move(update));
+            DBG("Convolution::serviceLoad - Loaded: " + (source.data.getSize() > 0 ? juce::String("IR from memory")
+                                                                                  : source.file.getFullPathName()));
+        }
     }
 
-    if (!juce::isPositiveAndBelow(index, irBank->getNumIRs()))
+    const int index = requestedIRIndex.exchange(-1);
+
+    if (index < 0)
     {
-        DBG("Convolution::loadIRAtIndex - ERROR: Index out of range: " + juce::String(index));
+        // Tone change only: same IR, filtered again, crossfaded in
+        if (toneRequested.exchange(false))
+            publishUpdate(createToneUpdate());
+
         return;
     }
 
-    if (index == currentIRIndex)
-        return; // Already loaded
-
-    // Explicit bypass IR at index 0
-    if (index == 0)
+    IRSource source;
     {
-        // Reset ALL state before loading bypass
-        reset();
-        
-        std::vector<float> impulse(1, 1.0f);
+        const juce::ScopedLock sl(sourceLock);
+
+        if (!irBank)
+        {
+            DBG("Convolution::serviceLoad - ERROR: No IR bank set");
+            return;
+        }
 
-        try
+        if (!juce::isPositiveAndBelow(index, irBank->getNumIRs()))
         {
-            convolver.loadImpulseResponse(
-                impulse.data(),
-                impulse.size(),
-                juce::dsp::Convolution::Stereo::no,
-                juce::dsp::Convolution::Trim::no,
-                1);
-
-            DBG("Convolution::loadIRAtIndex - Loaded BYPASS IR (unity impulse)");
-            currentIRIndex = 0;
+            DBG("Convolution::serviceLoad - ERROR: Index out of range: " + juce::String(index));
+            return;
         }
-        catch (const std::exception& e)
+
+        source.bankIndex = index;
+
+        if (index > 0)
         {
-            DBG("Convolution::loadIRAtIndex - Exception loading bypass IR: " + juce::String(e.what()));
+            source.file       = irBank->getIRFile(index);
+            source.pairedFile = irBank->getPairedIRFile(index);
         }
+
+        // Remember it even before prepare(), which rebuilds from it
+        currentSource = source;
+    }
+
+    toneRequested.store(false);
+    publishUpdate(createUpdate(source));
+}
+
+// Any thread: requests are cleared before loadInProgress is, and the update
+// is published before it, so there is no gap between the three checks
+bool Convolution::isLoadPending() const
+{
+    return loader->hasPendingLoad() || loader->loadInProgress.load() || loader->pendingUpdate.load() != nullptr;
+}
+
+// Loader thread
+void Convolution::Loader::freeRetired()
+{
+    delete retiredUpdate.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+// Message thread: the file is read and partitioned by the load queue
+void Convolution::requestSource(const IRSource& source)
+{
+    {
+        const juce::ScopedLock sl(loader->sourceLock);
+        loader->requestedSource = source;
+        loader->customIRFile    = source.file;
+    }
+
+    // Drop a bank request still waiting, and stop following the IR parameter
+    loader->requestedIRIndex.store(-1);
+    customIRActive.store(true);
+
+    // No longer showing a bank entry: selecting one always reloads
+    currentIRIndex = -1;
+
+    loader->sourceRequested.store(true);
+    loadQueue->wakeUp();
+}
+
+void Convolution::loadIR(const juce::File& file, const juce::File& pairedFile)
+{
+    if (!file.existsAsFile())
+    {
+        DBG("Convolution::loadIR - ERROR: File does not exist: " + file.getFullPathName());
         return;
     }
 
-    // Real IRs for index > 0
-    auto irFile = irBank->getIRFile(index);
+    IRSource source;
+    source.file       = file;
+    source.pairedFile = pairedFile;
+
+    requestSource(source);
+}
+
+void Convolution::loadIRFromMemory(const void* data,
+                                   size_t dataSize,
+                                   double sampleRate,
+                                   int numChannels)
+{
+    juce::ignoreUnused(sampleRate, numChannels);
 
-    if (!irFile.existsAsFile())
+    if (data == nullptr || dataSize == 0)
     {
-        DBG("Convolution::loadIRAtIndex - ERROR: IR file does not exist for index "
-            + juce::String(index) + " path: " + irFile.getFullPathName());
+        DBG("Convolution::loadIRFromMemory - ERROR: Invalid data or size");
         return;
     }
 
-    // CRITICAL: Reset ALL state before loading new IR to prevent blips
-    // This clears: convolver buffers, delay lines, filter states
-    reset();
-    
-    loadIR(irFile);
+    IRSource source;
+    source.data = juce::MemoryBlock(data, dataSize);
+
+    requestSource(source);
+}
+
+juce::File Convolution::getCustomIRFile() const
+{
+    const juce::ScopedLock sl(loader->sourceLock);
+    return customIRActive.load() ? loader->customIRFile : juce::File();
+}
+
+void Convolution::setLoadPriority(bool shouldHavePriority)
+{
+    if (shouldHavePriority)
+        loadQueue->setPriorityClient(loader.get());
+    else
+        loadQueue->clearPriorityClient(loader.get());
+}
+
+// IR Bank Management
+void Convolution::setIRBank(std::shared_ptr<IRBank> bank)
+{
+    bool hasIRs = false;
+    {
+        const juce::ScopedLock sl(loader->sourceLock);
+        loader->irBank = bank;
+        hasIRs = bank && bank->getNumIRs() > 0;
+    }
+
+    // Load first IR if available
+    if (hasIRs)
+        loadIRAtIndex(0);
+}
+
+void Convolution::setInputShare(std::shared_ptr<ConvolutionInputShare> share)
+{
+    convolver.setInputShare(std::move(share));
+}
+
+// Called from the audio thread (via setParameters): only posts a request,
+// the loader thread reads and partitions the file
+void Convolution::loadIRAtIndex(int index)
+{
+    if (index == currentIRIndex)
+        return; // Already loaded or requested
+
     currentIRIndex = index;
-}
\ No newline at end of file
+    loader->requestedIRIndex.store(index, std::memory_order_release);
+}
@@ -1,6 +1,14 @@
 #pragma once
 
-#include <JuceHeader.h>
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_audio_formats/juce_audio_formats.h>
+  #include <juce_dsp/juce_dsp.h>
+#endif
+#include "ConvolutionEngine.h"
+#include "IRLoadQueue.h"
 
 // Forward declaration
 class IRBank;
@@ -16,9 +24,12 @@ struct ConvolutionParameters
 
     float lowCutHz   = 80.0f;   // high pass cutoff
     float highCutHz  = 12000.0f; // low pass cutoff
+    float tiltDb     = 0.0f;    // spectral tilt around 1 kHz (+ = brighter)
+
+    bool trueStereo  = true;    // use the LR/RL cross paths of 4-channel IRs
 };
 
-// Simple stereo convolution reverb wrapper using juce::dsp::Convolution
+// Stereo / true-stereo convolution reverb built on PartitionedConvolver
 class Convolution
 {
 public:
@@ -28,7 +39,7 @@ public:
     // Prepare internal DSP for a given sample rate, block size, and channel count
     void prepare(const juce::dsp::ProcessSpec& spec);
 
-    // Reset internal state (clear delay lines, filters, convolver history)
+    // Reset internal state (clear delay lines, convolver history)
     void reset();
 
     // Set all parameters at once (called by ConvolutionModule)
@@ -40,36 +51,127 @@ public:
     // Main processing entry point
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi);
 
-    // IR loading helpers
-    void loadIR(const juce::File& file);
+    // IR loading helpers (message thread - the IR is built by the shared load queue)
+    // A 4-channel file, or a pair of stereo files (LL/LR + RL/RR), loads as true stereo.
+    // A custom IR stays loaded until the IR index parameter is moved.
+    void loadIR(const juce::File& file, const juce::File& pairedFile = {});
     void loadIRFromMemory(const void* data,
                          size_t dataSize,
                          double sampleRate,
                          int numChannels);
-    
+
+    // File of the custom IR in use, or an empty File when following the bank
+    juce::File getCustomIRFile() const;
+
+    // Serviced ahead of other convolutions (the slot being edited)
+    void setLoadPriority(bool shouldHavePriority);
+
     // IR bank management
     void setIRBank(std::shared_ptr<IRBank> bank);
     void loadIRAtIndex(int index);
 
+    // Forward FFTs of identical input are shared with other convolutions
+    void setInputShare(std::shared_ptr<ConvolutionInputShare> share);
+
+    // True until the last requested IR is built and picked up by processBlock
+    // (offline tools keep processing until this clears before they measure)
+    bool isLoadPending() const;
+
 private:
-    // Helper: configure HP/LP filters for a given sample rate
-    void updateFilters();
-    
+    // Where the current IR came from, so it can be rebuilt after prepare()
+    struct IRSource
+    {
+        int bankIndex = -1;          // 0 = bypass (unity impulse)
+        juce::File file;
+        juce::File pairedFile;       // right-speaker half of a true-stereo pair
+        juce::MemoryBlock data;      // in-memory audio file
+
+        bool isValid() const { return bankIndex >= 0 || file != juce::File() || data.getSize() > 0; }
+    };
+
+    // The loader side: requests, build configuration and the IR handover.
+    // The load queue holds a reference too, so a build still running when
+    // this Convolution is destroyed finishes on the queue's copy.
+    class Loader : public IRLoadQueue::Client
+    {
+    public:
+        ~Loader() override;
+
+        // IR loading: build spectra off the audio thread, hand over lock-free.
+        // Tone (low/high cut, tilt) is applied to the IR before partitioning.
+        std::unique_ptr<PartitionedConvolver::Update> createUpdate(const IRSource& source);
+        std::unique_ptr<PartitionedConvolver::Update> createToneUpdate();
+        std::unique_ptr<PartitionedConvolver::Update> createToneUpdate(juce::AudioBuffer<float>& ir,
+                                                                       double sampleRate,
+                                                                       int partitionSize,
+                                                                       int generation) const;
+        void publishUpdate(std::unique_ptr<PartitionedConvolver::Update> update);
+
+        // IRLoadQueue::Client
+        bool hasPendingLoad() const override;
+        void serviceLoad() override;
+        void freeRetired() override;
+
+        // Guards irBank and the sources (message + loader threads only)
+        juce::CriticalSection sourceLock;
+        std::shared_ptr<IRBank> irBank;
+        IRSource currentSource;
+        IRSource requestedSource;
+        juce::File customIRFile;
+
+        // Configuration the loader builds for; generation changes on every prepare()
+        std::atomic<double> loadSampleRate { 0.0 };
+        std::atomic<int> loadPartitionSize { 0 };
+        std::atomic<int> loadHistoryCapacity { 0 };
+        std::atomic<int> loadGeneration { 0 };
+
+        std::atomic<int> requestedIRIndex { -1 };
+        std::atomic<bool> sourceRequested { false };
+
+        // Tone the loader bakes into the IR (written by the audio thread)
+        std::atomic<float> toneLowCutHz { 80.0f };
+        std::atomic<float> toneHighCutHz { 12000.0f };
+        std::atomic<float> toneTiltDb { 0.0f };
+        std::atomic<bool> toneRequested { false };
+
+        // Set while the loader is building, between taking a request and publishing
+        std::atomic<bool> loadInProgress { false };
+
+        // Resampled, normalised IR before tone shaping (loader thread + prepare())
+        juce::CriticalSection buildLock;
+        juce::AudioBuffer<float> cachedIR;
+        double cachedIRSampleRate = 0.0;
+        std::atomic<PartitionedConvolver::Update*> pendingUpdate { nullptr };
+        std::atomic<PartitionedConvolver::Update*> retiredUpdate { nullptr };
+
+    private:
+        void serviceRequests();
+    };
+
     // Helper: update pre-delay samples based on parameters
     void updatePreDelay();
 
+    void requestToneRebuild();
+    void installPendingUpdate();
+    void requestSource(const IRSource& source);
+
     ConvolutionParameters parameters;
 
     bool prepared = false;
     double currentSampleRate = 44100.0;
     float preDelaySamples = 0.0f;
     bool isPreDelayActive = false;  // Cache to avoid checking every block
-    int currentIRIndex = -1;
-    
-    std::shared_ptr<IRBank> irBank;
+    std::atomic<int> currentIRIndex { -1 };
+    bool parametersReceived = false;
+    std::atomic<bool> customIRActive { false };
+
+    // Partitioned FFT engine (one forward FFT per input, shared by all IR paths)
+    PartitionedConvolver convolver;
 
-    // JUCE convolution engine (handles stereo buffers if IR is stereo)
-    juce::dsp::Convolution convolver;
+    std::shared_ptr<Loader> loader { std::make_shared<Loader>() };
+    juce::SharedResourcePointer<IRLoadQueue> loadQueue;
+
+    static constexpr int kMaxIRSeconds = 10;
 
     static constexpr int kMaxPreDelaySeconds = 2;
     static constexpr int kMaxSampleRate      = 192000;
@@ -78,15 +180,9 @@ private:
     juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> preDelayL { kMaxDelaySamples };
     juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> preDelayR { kMaxDelaySamples };
 
-    // Simple HP / LP filters per channel for tone shaping
-    juce::dsp::IIR::Filter<float> lowCutL;
-    juce::dsp::IIR::Filter<float> lowCutR;
-    juce::dsp::IIR::Filter<float> highCutL;
-    juce::dsp::IIR::Filter<float> highCutR;
-    
     // SIMD-optimized dry/wet mixer
     juce::dsp::DryWetMixer<float> dryWetMixer;
-    
+
     // Parameter smoothing for IR gain
     juce::SmoothedValue<float> smoothedIRGain;
-};
\ No newline at end of file
+};
@@ -0,0 +1,618 @@
+#include "ConvolutionEngine.h"
+#include "../../DSPKernels.h"
+
+//==============================================================================
+// Spectrum helpers
+//
+// juce::dsp::FFT works on interleaved complex data. The convolution MAC runs on
+// split-complex data (all reals, then all imaginaries) so the inner loop is a
+// straight, vectorisable pass over contiguous floats.
+//==============================================================================
+
+static int getFFTOrder(int fftSize)
+{
+    int order = 0;
+    while ((1 << order) < fftSize)
+        ++order;
+    return order;
+}
+
+static void interleavedToSplit(const float* interleaved, float* split, int numBins)
+{
+    float* re = split;
+    float* im = split + numBins;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        re[k] = interleaved[2 * k];
+        im[k] = interleaved[2 * k + 1];
+    }
+}
+
+// Also rebuilds the negative frequencies, as juce::dsp::ConvolutionEngine does,
+// so the inverse transform is valid for every FFT backend
+static void splitToInterleaved(const float* split, float* interleaved, int numBins, int fftSize)
+{
+    const float* re = split;
+    const float* im = split + numBins;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        interleaved[2 * k]     = re[k];
+        interleaved[2 * k + 1] = im[k];
+    }
+
+    for (int k = numBins; k < fftSize; ++k)
+    {
+        interleaved[2 * k]     =  re[fftSize - k];
+        interleaved[2 * k + 1] = -im[fftSize - k];
+    }
+}
+
+// Runs the MAC kernel picked for this CPU (see DSPKernels)
+static void multiplyAccumulate(float* acc, const float* a, const float* b, int numBins)
+{
+    DSPKernels::get().complexMultiplyAccumulate(acc, a, b, numBins);
+}
+
+//==============================================================================
+// ImpulseResponseData
+//==============================================================================
+
+std::unique_ptr<ImpulseResponseData> ImpulseResponseData::create(const juce::AudioBuffer<float>& ir,
+                                                                  int partitionSize)
+{
+    jassert(juce::isPowerOfTwo(partitionSize));
+
+    auto data = std::make_unique<ImpulseResponseData>();
+
+    const int numChannels = ir.getNumChannels();
+    const int numSamples  = juce::jmax(1, ir.getNumSamples());
+
+    data->layout        = numChannels >= 4 ? Layout::TrueStereo
+                        : numChannels >= 2 ? Layout::Stereo
+                                           : Layout::Mono;
+    data->partitionSize = partitionSize;
+    data->fftSize       = 2 * partitionSize;
+    data->numBins       = partitionSize + 1;
+    data->spectrumSize  = 2 * data->numBins;
+    data->numPartitions = (numSamples + partitionSize - 1) / partitionSize;
+
+    // Engine choice by IR length: the FIR head pays off for short IRs, and for
+    // small partitions where a forward FFT every callback dominates the cost.
+    // At 128 and up the head's taps outweigh the FFT it saves.
+    if (numSamples <= kMaxDirectTaps || partitionSize <= kMaxHybridPartition)
+        data->headLength = juce::jmin(partitionSize, numSamples);
+
+    juce::dsp::FFT fft(getFFTOrder(data->fftSize));
+    std::vector<float> fftBuffer((size_t) (2 * data->fftSize), 0.0f);
+
+    auto buildPath = [&](int irChannel, int input, int output)
+    {
+        auto& dest = data->paths[input][output];
+        dest.assign((size_t) data->numPartitions * (size_t) data->spectrumSize, 0.0f);
+
+        auto& head = data->headTaps[input][output];
+        head.assign((size_t) data->headLength, 0.0f);
+
+        if (irChannel >= numChannels)
+            return;
+
+        const float* src = ir.getReadPointer(irChannel);
+
+        juce::FloatVectorOperations::copy(head.data(), src,
+                                          juce::jmin(data->headLength, ir.getNumSamples()));
+
+        for (int p = 0; p < data->numPartitions; ++p)
+        {
+            std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+
+            const int start = p * partitionSize;
+            const int count = juce::jmin(partitionSize, ir.getNumSamples() - start);
+
+            if (count > 0)
+                juce::FloatVectorOperations::copy(fftBuffer.data(), src + start, count);
+
+            fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+            interleavedToSplit(fftBuffer.data(),
+                               dest.data() + (size_t) p * (size_t) data->spectrumSize,
+                               data->numBins);
+        }
+    };
+
+    switch (data->layout)
+    {
+        case Layout::Mono:
+            buildPath(0, 0, 0);
+            data->paths[1][1]    = data->paths[0][0];
+            data->headTaps[1][1] = data->headTaps[0][0];
+            break;
+
+        case Layout::Stereo:
+            buildPath(0, 0, 0);
+            buildPath(1, 1, 1);
+            break;
+
+        case Layout::TrueStereo:
+            buildPath(0, 0, 0);   // LL
+            buildPath(1, 0, 1);   // LR
+            buildPath(2, 1, 0);   // RL
+            buildPath(3, 1, 1);   // RR
+            break;
+    }
+
+    return data;
+}
+
+//==============================================================================
+// ConvolutionInputHistory
+//==============================================================================
+
+ConvolutionInputHistory::ConvolutionInputHistory(int partitionSizeIn, int numPartitions)
+    : partitionSize(partitionSizeIn),
+      fftSize(2 * partitionSizeIn),
+      spectrumSize(2 * (partitionSizeIn + 1)),
+      capacity(juce::jmax(1, numPartitions))
+{
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        inputBlock[ch].assign((size_t) (2 * partitionSize), 0.0f);
+        segments[ch].assign((size_t) capacity * (size_t) spectrumSize, 0.0f);
+    }
+}
+
+void ConvolutionInputHistory::reset()
+{
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        std::fill(inputBlock[ch].begin(), inputBlock[ch].end(), 0.0f);
+        std::fill(segments[ch].begin(), segments[ch].end(), 0.0f);
+    }
+
+    currentSegment = 0;
+}
+
+//==============================================================================
+// ConvolutionInputShare
+//==============================================================================
+
+void ConvolutionInputShare::prepare(int maxBlockSize)
+{
+    partitionSize = PartitionedConvolver::getPartitionSizeForBlockSize(maxBlockSize);
+
+    const int spectrumSize = 2 * (partitionSize + 1);
+
+    for (auto& entry : entries)
+    {
+        entry.block = 0;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            entry.input[ch].assign((size_t) partitionSize, 0.0f);
+            entry.spectrum[ch].assign((size_t) spectrumSize, 0.0f);
+        }
+    }
+}
+
+const ConvolutionInputShare::Entry* ConvolutionInputShare::find(int subBlock, int partitionSizeIn, int inputPos,
+                                                                int numSamples, int numChannels) const
+{
+    if (!juce::isPositiveAndBelow(subBlock, kMaxSubBlocks))
+        return nullptr;
+
+    const auto& entry = entries[subBlock];
+
+    if (entry.block != currentBlock
+        || entry.partitionSize != partitionSizeIn
+        || entry.inputPos != inputPos
+        || entry.numSamples != numSamples
+        || entry.numChannels != numChannels)
+        return nullptr;
+
+    return &entry;
+}
+
+ConvolutionInputShare::Entry* ConvolutionInputShare::claim(int subBlock, int partitionSizeIn, int inputPos,
+                                                           int numSamples, int numChannels)
+{
+    if (!juce::isPositiveAndBelow(subBlock, kMaxSubBlocks)
+        || partitionSizeIn != partitionSize
+        || !juce::isPositiveAndNotGreaterThan(numChannels, 2))
+        return nullptr;
+
+    auto& entry = entries[subBlock];
+
+    if (entry.block == currentBlock)
+        return nullptr;
+
+    entry.block         = currentBlock;
+    entry.partitionSize = partitionSizeIn;
+    entry.inputPos      = inputPos;
+    entry.numSamples    = numSamples;
+    entry.numChannels   = numChannels;
+
+    return &entry;
+}
+
+//==============================================================================
+// PartitionedConvolver
+//==============================================================================
+
+PartitionedConvolver::PartitionedConvolver() {}
+PartitionedConvolver::~PartitionedConvolver() {}
+
+int PartitionedConvolver::getPartitionSizeForBlockSize(int maxBlockSize)
+{
+    return juce::jmax(32, juce::nextPowerOfTwo(maxBlockSize));
+}
+
+void PartitionedConvolver::prepare(int maxBlockSize, double sampleRate)
+{
+    partitionSize = getPartitionSizeForBlockSize(maxBlockSize);
+    fftSize       = 2 * partitionSize;
+    numBins       = partitionSize + 1;
+
+    fft = std::make_unique<juce::dsp::FFT>(getFFTOrder(fftSize));
+
+    fftBuffer.assign((size_t) (2 * fftSize), 0.0f);
+    spectrum.assign((size_t) (2 * numBins), 0.0f);
+    fadeScratch.assign((size_t) partitionSize, 0.0f);
+
+    for (auto* slot : { &current, &previous })
+    {
+        // Partitions were built for the old size; the owner reloads the IR
+        slot->ir.reset();
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            slot->tail[ch].assign((size_t) (2 * numBins), 0.0f);
+            slot->overlap[ch].assign((size_t) partitionSize, 0.0f);
+            slot->tailOutput[ch].assign((size_t) partitionSize, 0.0f);
+        }
+    }
+
+    history = std::make_unique<ConvolutionInputHistory>(partitionSize, 1);
+
+    // ~50 ms crossfade between IRs
+    fadeLength = juce::jmax(1, (int) (0.05 * sampleRate));
+
+    reset();
+}
+
+void PartitionedConvolver::reset()
+{
+    inputPos      = 0;
+    fadeRemaining = 0;
+
+    if (history != nullptr)
+        history->reset();
+
+    for (auto* slot : { &current, &previous })
+    {
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            std::fill(slot->tail[ch].begin(), slot->tail[ch].end(), 0.0f);
+            std::fill(slot->overlap[ch].begin(), slot->overlap[ch].end(), 0.0f);
+            std::fill(slot->tailOutput[ch].begin(), slot->tailOutput[ch].end(), 0.0f);
+        }
+
+        slot->tailValid = false;
+    }
+}
+
+void PartitionedConvolver::install(Update& update)
+{
+    jassert(update.ir != nullptr && update.ir->partitionSize == partitionSize);
+
+    // A fade still in progress is cut short
+    update.retired = std::move(previous.ir);
+    fadeRemaining  = 0;
+
+    if (update.history != nullptr)
+    {
+        // New history => nothing to crossfade from, switch hard
+        std::swap(history, update.history);
+        std::swap(current.ir, update.ir);
+        reset();
+        return;
+    }
+
+    // Keep the input history and fade the old IR out over fadeLength
+    previous.ir = std::move(current.ir);
+    current.ir  = std::move(update.ir);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        std::swap(previous.tail[ch], current.tail[ch]);
+        std::swap(previous.overlap[ch], current.overlap[ch]);
+        std::swap(previous.tailOutput[ch], current.tailOutput[ch]);
+        std::fill(current.overlap[ch].begin(), current.overlap[ch].end(), 0.0f);
+    }
+
+    previous.tailValid = current.tailValid;
+    current.tailValid  = false;
+
+    if (previous.ir != nullptr)
+        fadeRemaining = fadeLength;
+}
+
+bool PartitionedConvolver::pathActive(const ImpulseResponseData& ir, int input, int output) const
+{
+    return ir.hasPath(input, output) && (input == output || crossPathsEnabled);
+}
+
+void PartitionedConvolver::pushInput(const float* const* input, int numInputs, int offset, int numSamples)
+{
+    for (int ch = 0; ch < numInputs; ++ch)
+        juce::FloatVectorOperations::copy(history->getCurrentBlock(ch) + inputPos, input[ch] + offset, numSamples);
+}
+
+void PartitionedConvolver::transformInput(int numInputs, int numSamples, int subBlock)
+{
+    if (reuseSharedInput(numInputs, numSamples, subBlock))
+        return;
+
+    for (int ch = 0; ch < numInputs; ++ch)
+    {
+        // Forward transform of the (possibly partial) current block, zero padded
+        juce::FloatVectorOperations::copy(fftBuffer.data(), history->getCurrentBlock(ch), partitionSize);
+        juce::FloatVectorOperations::clear(fftBuffer.data() + partitionSize, partitionSize);
+        fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+        interleavedToSplit(fftBuffer.data(), history->getSegment(ch, history->currentSegment), numBins);
+    }
+
+    publishSharedInput(numInputs, numSamples, subBlock);
+}
+
+bool PartitionedConvolver::reuseSharedInput(int numInputs, int numSamples, int subBlock)
+{
+    if (inputShare == nullptr)
+        return false;
+
+    const auto* entry = inputShare->find(subBlock, partitionSize, inputPos, numSamples, numInputs);
+
+    if (entry == nullptr)
+        return false;
+
+    // The spectrum covers the whole block so far, not just this callback's samples
+    const auto filled = (size_t) (inputPos + numSamples) * sizeof(float);
+
+    for (int ch = 0; ch < numInputs; ++ch)
+        if (std::memcmp(entry->input[ch].data(), history->getCurrentBlock(ch), filled) != 0)
+            return false;
+
+    for (int ch = 0; ch < numInputs; ++ch)
+        std::copy(entry->spectrum[ch].begin(), entry->spectrum[ch].end(),
+                  history->getSegment(ch, history->currentSegment));
+
+    return true;
+}
+
+void PartitionedConvolver::publishSharedInput(int numInputs, int numSamples, int subBlock)
+{
+    if (inputShare == nullptr)
+        return;
+
+    auto* entry = inputShare->claim(subBlock, partitionSize, inputPos, numSamples, numInputs);
+
+    if (entry == nullptr)
+        return;
+
+    for (int ch = 0; ch < numInputs; ++ch)
+    {
+        const float* segment = history->getSegment(ch, history->currentSegment);
+        const float* block   = history->getCurrentBlock(ch);
+
+        std::copy(block, block + partitionSize, entry->input[ch].begin());
+        std::copy(segment, segment + 2 * numBins, entry->spectrum[ch].begin());
+    }
+}
+
+void PartitionedConvolver::accumulateTail(Slot& slot, int numInputs, int numOutputs)
+{
+    const auto& ir      = *slot.ir;
+    const int capacity  = history->capacity;
+    const int numParts  = juce::jmin(ir.numPartitions, capacity);
+
+    for (int out = 0; out < numOutputs; ++out)
+    {
+        auto* acc = slot.tail[out].data();
+        std::fill(slot.tail[out].begin(), slot.tail[out].end(), 0.0f);
+
+        int index = history->currentSegment;
+
+        for (int p = 1; p < numParts; ++p)
+        {
+            // Older blocks sit after the current one in the ring
+            if (++index >= capacity)
+                index = 0;
+
+            for (int in = 0; in < numInputs; ++in)
+            {
+                if (pathActive(ir, in, out))
+                    multiplyAccumulate(acc, history->getSegment(in, index), ir.getPartition(in, out, p), numBins);
+            }
+        }
+    }
+
+    slot.tailValid = true;
+
+    if (ir.usesDirectHead())
+        renderTailOutput(slot, numOutputs);
+}
+
+// Direct-head slots: the tail only changes once per block, so it is
+// transformed back once per block instead of once per callback
+void PartitionedConvolver::renderTailOutput(Slot& slot, int numOutputs)
+{
+    const bool hasTail = juce::jmin(slot.ir->numPartitions, history->capacity) > 1;
+
+    for (int out = 0; out < numOutputs; ++out)
+    {
+        auto* tailOutput = slot.tailOutput[out].data();
+        auto* overlap    = slot.overlap[out].data();
+
+        if (!hasTail)
+        {
+            juce::FloatVectorOperations::copy(tailOutput, overlap, partitionSize);
+            juce::FloatVectorOperations::clear(overlap, partitionSize);
+            continue;
+        }
+
+        splitToInterleaved(slot.tail[out].data(), fftBuffer.data(), numBins, fftSize);
+        fft->performRealOnlyInverseTransform(fftBuffer.data());
+
+        juce::FloatVectorOperations::add(tailOutput, fftBuffer.data(), overlap, partitionSize);
+        juce::FloatVectorOperations::copy(overlap, fftBuffer.data() + partitionSize, partitionSize);
+    }
+}
+
+// Partition 0 as a direct-form FIR, blocked per tap: each tap is one vectorised
+// multiply-add over the whole sub-block (transposed form), which suits the
+// short heads this is used for better than a per-sample dot product
+void PartitionedConvolver::renderDirect(Slot& slot, int numInputs, int output, float* dest, int numSamples)
+{
+    const auto& ir = *slot.ir;
+
+    const auto& kernels = DSPKernels::get();
+
+    juce::FloatVectorOperations::copy(dest, slot.tailOutput[output].data() + inputPos, numSamples);
+
+    for (int in = 0; in < numInputs; ++in)
+    {
+        if (!pathActive(ir, in, output))
+            continue;
+
+        const float* taps = ir.headTaps[in][output].data();
+        const float* x    = history->getCurrentBlock(in) + inputPos;
+
+        // x - k reaches back into the previous block (headLength <= partitionSize)
+        for (int k = 0; k < ir.headLength; ++k)
+            kernels.addWithMultiply(dest, x - k, taps[k], numSamples);
+    }
+}
+
+void PartitionedConvolver::renderSlot(Slot& slot, int numInputs, int output,
+                                      float* dest, int numSamples, bool blockComplete)
+{
+    const auto& ir = *slot.ir;
+    auto* acc = spectrum.data();
+
+    std::copy(slot.tail[output].begin(), slot.tail[output].end(), spectrum.begin());
+
+    for (int in = 0; in < numInputs; ++in)
+    {
+        if (pathActive(ir, in, output))
+            multiplyAccumulate(acc, history->getSegment(in, history->currentSegment),
+                               ir.getPartition(in, output, 0), numBins);
+    }
+
+    splitToInterleaved(acc, fftBuffer.data(), numBins, fftSize);
+    fft->performRealOnlyInverseTransform(fftBuffer.data());
+
+    auto* overlap = slot.overlap[output].data();
+
+    juce::FloatVectorOperations::add(dest, fftBuffer.data() + inputPos, overlap + inputPos, numSamples);
+
+    if (blockComplete)
+        juce::FloatVectorOperations::copy(overlap, fftBuffer.data() + partitionSize, partitionSize);
+}
+
+void PartitionedConvolver::process(const float* const* input, float* const* output,
+                                   int numChannels, int numSamples)
+{
+    if (fft == nullptr || history == nullptr)
+        return;
+
+    const int numIO = juce::jmin(2, numChannels);
+
+    if (current.ir == nullptr)
+    {
+        for (int ch = 0; ch < numIO; ++ch)
+            if (output[ch] != input[ch])
+                juce::FloatVectorOperations::copy(output[ch], input[ch], numSamples);
+        return;
+    }
+
+    int done = 0;
+    int subBlock = 0;
+
+    while (done < numSamples)
+    {
+        const int  count         = juce::jmin(numSamples - done, partitionSize - inputPos);
+        const bool blockComplete = (inputPos + count == partitionSize);
+        const bool fading        = fadeRemaining > 0 && previous.ir != nullptr;
+
+        // FFT heads need the spectrum of the partial block every callback; direct
+        // heads only need complete blocks, and only when there is a tail to feed
+        const bool fftHead = !current.ir->usesDirectHead()
+                          || (fading && !previous.ir->usesDirectHead());
+
+        // Partitions 1..N-1 only depend on complete past blocks:
+        // accumulate them once at the start of each block
+        if (inputPos == 0)
+        {
+            current.tailValid  = false;
+            previous.tailValid = false;
+        }
+
+        // All inputs are consumed before any output is written (in-place safe)
+        pushInput(input, numIO, done, count);
+
+        if (fftHead || (blockComplete && history->capacity > 1))
+            transformInput(numIO, count, subBlock);
+
+        ++subBlock;
+
+        if (!current.tailValid)
+            accumulateTail(current, numIO, numIO);
+
+        if (fading && !previous.tailValid)
+            accumulateTail(previous, numIO, numIO);
+
+        for (int out = 0; out < numIO; ++out)
+        {
+            float* dest = output[out] + done;
+
+            if (current.ir->usesDirectHead())
+                renderDirect(current, numIO, out, dest, count);
+            else
+                renderSlot(current, numIO, out, dest, count, blockComplete);
+
+            if (fading)
+            {
+                if (previous.ir->usesDirectHead())
+                    renderDirect(previous, numIO, out, fadeScratch.data(), count);
+                else
+                    renderSlot(previous, numIO, out, fadeScratch.data(), count, blockComplete);
+
+                for (int i = 0; i < count; ++i)
+                {
+                    const float oldGain = (float) juce::jmax(0, fadeRemaining - i) / (float) fadeLength;
+                    dest[i] = dest[i] * (1.0f - oldGain) + fadeScratch[(size_t) i] * oldGain;
+                }
+            }
+        }
+
+        if (fading)
+            fadeRemaining = juce::jmax(0, fadeRemaining - count);
+
+        inputPos += count;
+        done     += count;
+
+        if (inputPos == partitionSize)
+        {
+            // Block full => next segment; the block becomes the FIR's look-back
+            for (int ch = 0; ch < numIO; ++ch)
+            {
+                float* block = history->inputBlock[ch].data();
+                juce::FloatVectorOperations::copy(block, block + partitionSize, partitionSize);
+                juce::FloatVectorOperations::clear(block + partitionSize, partitionSize);
+            }
+
+            history->currentSegment = (history->currentSegment > 0) ? history->currentSegment - 1
+                                                                     : history->capacity - 1;
+            inputPos = 0;
+        }
+    }
+}
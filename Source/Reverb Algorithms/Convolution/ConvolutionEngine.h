@@ -0,0 +1,233 @@
+// ==============================================================================
+// ConvolutionEngine.h - Uniformly partitioned FFT convolution
+//
+// Zero-latency overlap-add engine in the style of juce::dsp::ConvolutionEngine,
+// but with an explicit input/output channel matrix so that one forward FFT per
+// input channel can feed several IR paths (true stereo: LL, LR, RL, RR).
+// ==============================================================================
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_dsp/juce_dsp.h>
+#endif
+
+//==============================================================================
+// Frequency-domain impulse response, split into partitions of partitionSize.
+// Built off the audio thread, then handed to a PartitionedConvolver.
+//
+// Short IRs and small partitions render partition 0 with a direct-form FIR
+// instead of a per-callback FFT: a pure FIR when the whole IR fits in the
+// head, a hybrid (FIR head + FFT tail) otherwise. None of the bundled IRs is
+// short enough for the pure FIR (the Direct Cabinet ones run 759 to 4097
+// frames), so with them the FIR only shows up as the hybrid head. The hybrid
+// head costs partitionSize taps per sample on top of the tail's inverse FFT,
+// so it only wins while the partition is small.
+//==============================================================================
+struct ImpulseResponseData
+{
+    enum class Layout { Mono, Stereo, TrueStereo };
+
+    // Longest head the direct-form FIR takes on
+    static constexpr int kMaxDirectTaps = 256;
+
+    // Largest partition that gets a hybrid head in front of an FFT tail
+    static constexpr int kMaxHybridPartition = 64;
+
+    // Build from a time-domain IR that is already at the processing sample rate.
+    //  1 channel  -> Mono        (same IR on both channels)
+    //  2 channels -> Stereo      (L->L, R->R)
+    //  4 channels -> TrueStereo  (LL, LR, RL, RR)
+    static std::unique_ptr<ImpulseResponseData> create(const juce::AudioBuffer<float>& ir,
+                                                       int partitionSize);
+
+    bool hasPath(int input, int output) const
+    {
+        return !paths[input][output].empty();
+    }
+
+    bool usesDirectHead() const { return headLength > 0; }
+
+    // Split-complex spectrum (numBins reals followed by numBins imaginaries)
+    const float* getPartition(int input, int output, int partition) const
+    {
+        return paths[input][output].data() + (size_t) partition * (size_t) spectrumSize;
+    }
+
+    Layout layout = Layout::Stereo;
+
+    int partitionSize = 0;
+    int fftSize       = 0;
+    int numBins       = 0;   // fftSize / 2 + 1
+    int spectrumSize  = 0;   // 2 * numBins
+    int numPartitions = 0;
+    int headLength    = 0;   // taps of partition 0 rendered by the FIR (0 = FFT only)
+
+    // paths[input][output]; empty when there is no path between the two channels
+    std::vector<float> paths[2][2];
+    std::vector<float> headTaps[2][2];   // time-domain partition 0, headLength taps
+};
+
+//==============================================================================
+// Frequency-domain delay line: the partitioned spectra of past input blocks.
+// Sized for a given number of partitions, so it is allocated together with
+// an IR that needs more room than the current one.
+//==============================================================================
+struct ConvolutionInputHistory
+{
+    ConvolutionInputHistory(int partitionSize, int numPartitions);
+
+    void reset();
+
+    float* getSegment(int channel, int index)
+    {
+        return segments[(size_t) channel].data() + (size_t) index * (size_t) spectrumSize;
+    }
+
+    float* getCurrentBlock(int channel)
+    {
+        return inputBlock[(size_t) channel].data() + partitionSize;
+    }
+
+    int partitionSize = 0;
+    int fftSize       = 0;
+    int spectrumSize  = 0;
+    int capacity      = 0;   // partitions held per channel
+
+    int currentSegment = 0;
+
+    // Time-domain input per channel: [previous block | current block],
+    // so the direct-form head can read back across the block boundary
+    std::vector<float> inputBlock[2];
+    std::vector<float> segments[2];
+};
+
+//==============================================================================
+// Forward transforms shared between convolvers within one audio callback.
+// Parallel chains that start with a convolution slot get the same dry input,
+// so the first convolver publishes its input spectra and the others copy them
+// instead of running their own forward FFT. Reuse is only taken when the
+// time-domain input block is bit-identical, so differing sources (other
+// upstream modules, pre-delay settings, block phase) fall back to an FFT.
+// Audio thread only, except prepare().
+//==============================================================================
+class ConvolutionInputShare
+{
+public:
+    struct Entry
+    {
+        juce::uint64 block = 0;
+        int partitionSize  = 0;
+        int inputPos       = 0;
+        int numSamples     = 0;
+        int numChannels    = 0;
+
+        std::vector<float> input[2];      // time-domain block the spectra were taken from
+        std::vector<float> spectrum[2];   // split-complex
+    };
+
+    void prepare(int maxBlockSize);
+
+    // Called by the processor once per callback, before any module runs
+    void beginBlock() { ++currentBlock; }
+
+    // Entry published this callback for the given sub-block with a matching layout, or nullptr
+    const Entry* find(int subBlock, int partitionSize, int inputPos, int numSamples, int numChannels) const;
+
+    // Entry to publish into, or nullptr if another convolver already did this callback
+    Entry* claim(int subBlock, int partitionSize, int inputPos, int numSamples, int numChannels);
+
+private:
+    // A callback spans at most two partitions (partition size >= block size)
+    static constexpr int kMaxSubBlocks = 2;
+
+    Entry entries[kMaxSubBlocks];
+    int partitionSize = 0;
+    juce::uint64 currentBlock = 1;
+};
+
+//==============================================================================
+class PartitionedConvolver
+{
+public:
+    // Everything the audio thread swaps in at once. After install() it holds
+    // the objects that were swapped out, which must be freed off the audio thread.
+    struct Update
+    {
+        std::unique_ptr<ImpulseResponseData>     ir;
+        std::unique_ptr<ConvolutionInputHistory> history;   // only when the IR outgrows the current one
+        std::unique_ptr<ImpulseResponseData>     retired;
+        int tag = 0;                                         // caller-defined (e.g. config generation)
+    };
+
+    PartitionedConvolver();
+    ~PartitionedConvolver();
+
+    // Partition size follows the host block size, rounded up to a power of two
+    static int getPartitionSizeForBlockSize(int maxBlockSize);
+
+    void prepare(int maxBlockSize, double sampleRate);
+    void reset();
+
+    int getPartitionSize() const { return partitionSize; }
+    int getHistoryCapacity() const { return history != nullptr ? history->capacity : 0; }
+    bool hasImpulseResponse() const { return current.ir != nullptr; }
+
+    // Audio thread: swap in a new IR. Crossfades from the old IR when the
+    // input history can be kept, hard-switches when a new history comes along.
+    void install(Update& update);
+
+    // When false, a true-stereo IR only uses its LL and RR paths
+    void setCrossPathsEnabled(bool shouldBeEnabled) { crossPathsEnabled = shouldBeEnabled; }
+
+    // Optional: reuse forward transforms of identical input across convolvers
+    void setInputShare(std::shared_ptr<ConvolutionInputShare> share) { inputShare = std::move(share); }
+
+    // In-place capable: output pointers may alias the inputs.
+    // Passes the input through unchanged until an IR is installed.
+    void process(const float* const* input, float* const* output, int numChannels, int numSamples);
+
+private:
+    struct Slot
+    {
+        std::unique_ptr<ImpulseResponseData> ir;
+        std::vector<float> tail[2];      // accumulated spectra of partitions 1..N-1
+        std::vector<float> overlap[2];   // second half of the previous block's IFFT
+        std::vector<float> tailOutput[2]; // direct-head slots: time-domain tail for the current block
+        bool tailValid = false;
+    };
+
+    void pushInput(const float* const* input, int numInputs, int offset, int numSamples);
+    void transformInput(int numInputs, int numSamples, int subBlock);
+    bool reuseSharedInput(int numInputs, int numSamples, int subBlock);
+    void publishSharedInput(int numInputs, int numSamples, int subBlock);
+    void accumulateTail(Slot& slot, int numInputs, int numOutputs);
+    void renderSlot(Slot& slot, int numInputs, int output, float* dest, int numSamples, bool blockComplete);
+    void renderTailOutput(Slot& slot, int numOutputs);
+    void renderDirect(Slot& slot, int numInputs, int output, float* dest, int numSamples);
+    bool pathActive(const ImpulseResponseData& ir, int input, int output) const;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::unique_ptr<ConvolutionInputHistory> history;
+    std::shared_ptr<ConvolutionInputShare> inputShare;
+
+    Slot current, previous;
+
+    std::vector<float> fftBuffer;      // 2 * fftSize, JUCE interleaved layout
+    std::vector<float> spectrum;       // split-complex accumulator
+    std::vector<float> fadeScratch;    // previous-slot output while crossfading
+
+    int partitionSize = 0;
+    int fftSize       = 0;
+    int numBins       = 0;
+    int inputPos      = 0;
+
+    int fadeLength    = 0;
+    int fadeRemaining = 0;
+
+    bool crossPathsEnabled = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PartitionedConvolver)
+};
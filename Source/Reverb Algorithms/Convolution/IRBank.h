@@ -3,7 +3,12 @@
 // Looks for IRs next to the plugin binary (where post-build script copies them)
 // ==============================================================================
 #pragma once
-#include <JuceHeader.h>
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_formats/juce_audio_formats.h>
+  #include <juce_core/juce_core.h>
+#endif
 
 class IRBank
 {
@@ -12,6 +17,7 @@ public:
     {
         juce::String name;
         juce::File file;
+        juce::File pairedFile;   // right-speaker file of a true-stereo L/R pair
     };
     
     IRBank()
@@ -29,6 +35,14 @@ public:
         return juce::File();
     }
     
+    // Get the right-speaker file of a true-stereo pair (empty if not a pair)
+    juce::File getPairedIRFile(int index) const
+    {
+        if (juce::isPositiveAndBelow(index, irList.size()))
+            return irList[index].pairedFile;
+        return juce::File();
+    }
+    
     // Get IR name at index
     juce::String getIRName(int index) const
     {
@@ -55,6 +69,26 @@ public:
 private:
     std::vector<IRInfo> irList;
     
+    // For "Name L.wav" / "Name_L.wav", returns the matching right-speaker file if it exists
+    static juce::File findTrueStereoPartner(const juce::File& leftFile, juce::String& baseName)
+    {
+        const auto name = leftFile.getFileNameWithoutExtension();
+        
+        for (auto* suffix : { " L", "_L" })
+        {
+            if (name.endsWith(suffix))
+            {
+                baseName = name.dropLastCharacters(2);
+                auto rightFile = leftFile.getSiblingFile(baseName + juce::String(suffix).replace("L", "R")
+                                                        + leftFile.getFileExtension());
+                if (rightFile.existsAsFile())
+                    return rightFile;
+            }
+        }
+        
+        return juce::File();
+    }
+    
     void loadIRsFromPluginBundle()
     {
         DBG("=== IRBank::loadIRsFromPluginBundle ===");
@@ -161,12 +195,36 @@ private:
         
         DBG("Found " + juce::String(wavFiles.size()) + " WAV files");
         
-        // Add each WAV file
+        // Add each WAV file ("Name L" / "Name R" pairs become one true-stereo entry)
+        juce::Array<juce::File> pairedRightFiles;
+        
+        for (const auto& file : wavFiles)
+        {
+            juce::String baseName;
+            auto rightFile = findTrueStereoPartner(file, baseName);
+            
+            if (rightFile.existsAsFile())
+                pairedRightFiles.add(rightFile);
+        }
+        
         for (const auto& file : wavFiles)
         {
+            if (pairedRightFiles.contains(file))
+                continue;
+            
             IRInfo info;
             info.name = file.getFileNameWithoutExtension();
             info.file = file;
+            
+            juce::String baseName;
+            auto rightFile = findTrueStereoPartner(file, baseName);
+            
+            if (rightFile.existsAsFile())
+            {
+                info.name = baseName + " (True Stereo)";
+                info.pairedFile = rightFile;
+            }
+            
             irList.push_back(info);
             
             DBG("  [" + juce::String(irList.size()-1) + "] " + info.name);
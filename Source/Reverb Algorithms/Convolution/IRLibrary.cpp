@@ -0,0 +1,220 @@
+#include "IRLibrary.h"
+
+IRLibrary::IRLibrary()
+    : juce::Thread("IR Library Scanner")
+{
+    juce::PropertiesFile::Options options;
+    options.applicationName     = "ADSREcho";
+    options.filenameSuffix      = ".settings";
+    options.folderName          = "ADSREcho";
+    options.osxLibrarySubFolder = "Application Support";
+
+    settings = std::make_unique<juce::PropertiesFile>(options);
+
+    for (const auto& path : juce::StringArray::fromLines(settings->getValue("irFolders")))
+    {
+        juce::File folder(path);
+
+        if (path.isNotEmpty() && folder.isDirectory())
+            folders.add(folder);
+    }
+
+    DBG("IRLibrary initialized with " + juce::String(folders.size()) + " user folders");
+
+    startThread();
+    rescan();
+}
+
+IRLibrary::~IRLibrary()
+{
+    stopThread(4000);
+}
+
+bool IRLibrary::isSupportedFile(const juce::File& file)
+{
+    return file.hasFileExtension("wav;aif;aiff;flac");
+}
+
+//==============================================================================
+// Folder management (message thread)
+//==============================================================================
+
+void IRLibrary::addFolder(const juce::File& folder)
+{
+    if (!folder.isDirectory())
+        return;
+
+    {
+        const juce::ScopedLock sl(folderLock);
+
+        if (folders.contains(folder))
+            return;
+
+        folders.add(folder);
+        pendingScans.add(folder);
+    }
+
+    saveFolders();
+
+    // Only the new folder is scanned; existing entries stay
+    scanning.store(true);
+    notify();
+}
+
+void IRLibrary::removeFolder(const juce::File& folder)
+{
+    {
+        const juce::ScopedLock sl(folderLock);
+        folders.removeFirstMatchingValue(folder);
+    }
+
+    saveFolders();
+    rescan();
+}
+
+juce::Array<juce::File> IRLibrary::getFolders() const
+{
+    const juce::ScopedLock sl(folderLock);
+    return folders;
+}
+
+void IRLibrary::rescan()
+{
+    scanning.store(true);
+    rescanRequested.store(true);
+    notify();
+}
+
+void IRLibrary::saveFolders()
+{
+    juce::StringArray paths;
+
+    for (const auto& folder : getFolders())
+        paths.add(folder.getFullPathName());
+
+    settings->setValue("irFolders", paths.joinIntoString("\n"));
+    settings->saveIfNeeded();
+}
+
+//==============================================================================
+// Entries
+//==============================================================================
+
+IRLibrary::Entry IRLibrary::getEntry(int index) const
+{
+    const juce::ScopedLock sl(entryLock);
+
+    if (!juce::isPositiveAndBelow(index, numEntries.load()))
+        return {};
+
+    return (*pages[(size_t) (index / kPageSize)])[(size_t) (index % kPageSize)];
+}
+
+// Scanner thread
+void IRLibrary::appendBatch(std::vector<Entry>& batch)
+{
+    if (batch.empty())
+        return;
+
+    {
+        const juce::ScopedLock sl(entryLock);
+
+        int count = numEntries.load();
+
+        for (auto& entry : batch)
+        {
+            // New pages are allocated whole, so existing rows never move
+            if (pages.empty() || (int) pages.back()->size() == kPageSize)
+            {
+                pages.push_back(std::make_unique<std::vector<Entry>>());
+                pages.back()->reserve((size_t) kPageSize);
+            }
+
+            pages.back()->push_back(std::move(entry));
+            ++count;
+        }
+
+        numEntries.store(count);
+    }
+
+    batch.clear();
+    sendChangeMessage();
+}
+
+//==============================================================================
+// Scanner thread
+//==============================================================================
+
+void IRLibrary::scanFolder(const juce::File& folder)
+{
+    DBG("IRLibrary::scanFolder - " + folder.getFullPathName());
+
+    std::vector<Entry> batch;
+    batch.reserve((size_t) kScanBatch);
+
+    for (const auto& item : juce::RangedDirectoryIterator(folder, true, "*", juce::File::findFiles))
+    {
+        if (threadShouldExit() || rescanRequested.load())
+            return;
+
+        const auto file = item.getFile();
+
+        if (!isSupportedFile(file))
+            continue;
+
+        Entry entry;
+        entry.name = file.getRelativePathFrom(folder).upToLastOccurrenceOf(".", false, false);
+        entry.file = file;
+        batch.push_back(std::move(entry));
+
+        if ((int) batch.size() >= kScanBatch)
+            appendBatch(batch);
+    }
+
+    appendBatch(batch);
+}
+
+void IRLibrary::run()
+{
+    while (!threadShouldExit())
+    {
+        if (rescanRequested.exchange(false))
+        {
+            {
+                const juce::ScopedLock sl(entryLock);
+                pages.clear();
+                numEntries.store(0);
+            }
+
+            {
+                const juce::ScopedLock sl(folderLock);
+                pendingScans = folders;
+            }
+
+            sendChangeMessage();
+        }
+
+        juce::File next;
+        {
+            const juce::ScopedLock sl(folderLock);
+
+            if (!pendingScans.isEmpty())
+                next = pendingScans.removeAndReturn(0);
+        }
+
+        if (next != juce::File())
+        {
+            scanning.store(true);
+            scanFolder(next);
+            continue;
+        }
+
+        if (scanning.exchange(false))
+        {
+            DBG("IRLibrary - scan finished, " + juce::String(numEntries.load()) + " IRs");
+            sendChangeMessage();
+        }
+
+        wait(-1);
+    }
+}
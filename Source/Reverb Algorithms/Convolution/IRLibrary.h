@@ -0,0 +1,74 @@
+// ==============================================================================
+// IRLibrary.h - User impulse response folders
+//
+// Folders the user adds are scanned recursively on a background thread, a
+// batch of files at a time, so libraries with thousands of IRs show up
+// progressively instead of stalling the UI. Entries are stored in fixed-size
+// pages that never move once written, so readers only ever copy the rows
+// they are drawing. The folder list is kept in the plugin's settings file and
+// shared by all plugin instances through juce::SharedResourcePointer.
+// ==============================================================================
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_formats/juce_audio_formats.h>
+  #include <juce_core/juce_core.h>
+  #include <juce_events/juce_events.h>
+#endif
+
+class IRLibrary : public juce::ChangeBroadcaster,
+                  private juce::Thread
+{
+public:
+    struct Entry
+    {
+        juce::String name;   // path relative to its folder, without extension
+        juce::File file;
+    };
+
+    IRLibrary();
+    ~IRLibrary() override;
+
+    void addFolder(const juce::File& folder);
+    void removeFolder(const juce::File& folder);
+    juce::Array<juce::File> getFolders() const;
+
+    // Drop everything and scan all folders again
+    void rescan();
+
+    int getNumEntries() const { return numEntries.load(); }
+
+    // Copy of one row (empty Entry when out of range)
+    Entry getEntry(int index) const;
+
+    bool isScanning() const { return scanning.load(); }
+
+    static bool isSupportedFile(const juce::File& file);
+
+private:
+    void run() override;
+
+    void scanFolder(const juce::File& folder);
+    void appendBatch(std::vector<Entry>& batch);
+    void saveFolders();
+
+    static constexpr int kPageSize  = 512;
+    static constexpr int kScanBatch = 64;
+
+    mutable juce::CriticalSection entryLock;   // guards pages
+    std::vector<std::unique_ptr<std::vector<Entry>>> pages;
+    std::atomic<int> numEntries { 0 };
+
+    mutable juce::CriticalSection folderLock;  // guards folders, pendingScans
+    juce::Array<juce::File> folders;
+    juce::Array<juce::File> pendingScans;
+
+    std::atomic<bool> rescanRequested { false };
+    std::atomic<bool> scanning { false };
+
+    std::unique_ptr<juce::PropertiesFile> settings;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IRLibrary)
+};
@@ -0,0 +1,102 @@
+#include "IRLoadQueue.h"
+
+IRLoadQueue::IRLoadQueue()
+    : juce::Thread("Convolution IR Loader")
+{
+    startThread();
+}
+
+IRLoadQueue::~IRLoadQueue()
+{
+    stopThread(2000);
+}
+
+void IRLoadQueue::registerClient(std::shared_ptr<Client> client)
+{
+    const juce::ScopedLock sl(clientLock);
+
+    if (std::find(clients.begin(), clients.end(), client) == clients.end())
+        clients.push_back(std::move(client));
+}
+
+void IRLoadQueue::unregisterClient(Client* client)
+{
+    client->cancelled.store(true);
+
+    const juce::ScopedLock sl(clientLock);
+
+    clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                 [client] (const auto& c) { return c.get() == client; }),
+                  clients.end());
+
+    if (priorityClient == client)
+        priorityClient = nullptr;
+}
+
+void IRLoadQueue::setPriorityClient(Client* client)
+{
+    const juce::ScopedLock sl(clientLock);
+    priorityClient = client;
+}
+
+void IRLoadQueue::clearPriorityClient(Client* client)
+{
+    const juce::ScopedLock sl(clientLock);
+
+    if (priorityClient == client)
+        priorityClient = nullptr;
+}
+
+// Called with clientLock held
+std::shared_ptr<IRLoadQueue::Client> IRLoadQueue::pickNextClient()
+{
+    if (priorityClient != nullptr && priorityClient->hasPendingLoad())
+    {
+        for (const auto& c : clients)
+            if (c.get() == priorityClient)
+                return c;
+    }
+
+    const int numClients = (int) clients.size();
+
+    for (int i = 0; i < numClients; ++i)
+    {
+        const int index = (nextIndex + i) % numClients;
+
+        if (clients[(size_t) index]->hasPendingLoad())
+        {
+            nextIndex = (index + 1) % numClients;
+            return clients[(size_t) index];
+        }
+    }
+
+    return nullptr;
+}
+
+void IRLoadQueue::run()
+{
+    while (!threadShouldExit())
+    {
+        std::shared_ptr<Client> client;
+
+        {
+            const juce::ScopedLock sl(clientLock);
+
+            for (auto& c : clients)
+                c->freeRetired();
+
+            client = pickNextClient();
+        }
+
+        // Serviced without the lock, so unregistering never waits for a
+        // build. One request at a time, so a new priority request never
+        // waits behind more than the load that is already running.
+        if (client != nullptr)
+        {
+            client->serviceLoad();
+            continue;
+        }
+
+        wait(kPollIntervalMs);
+    }
+}
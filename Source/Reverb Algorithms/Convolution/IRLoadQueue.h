@@ -0,0 +1,77 @@
+// ==============================================================================
+// IRLoadQueue.h - One background worker that builds IRs for every convolution
+//
+// Each client holds at most one pending request (newer requests replace older
+// ones), so the queue is bounded by the number of convolution slots no matter
+// how fast the user scrolls through IRs. The client marked as priority (the
+// slot being edited) is always serviced first.
+// Shared by all plugin instances through juce::SharedResourcePointer.
+// ==============================================================================
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_core/juce_core.h>
+#endif
+
+class IRLoadQueue : private juce::Thread
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // Worker thread: true if a load request is waiting
+        virtual bool hasPendingLoad() const = 0;
+
+        // Worker thread: build and publish the most recent request
+        virtual void serviceLoad() = 0;
+
+        // Worker thread: free whatever the audio thread swapped out
+        virtual void freeRetired() = 0;
+
+        // Set once the client is unregistered: a load still running then
+        // stops at its next check and publishes nothing
+        bool isCancelled() const { return cancelled.load(); }
+
+    private:
+        friend class IRLoadQueue;
+        std::atomic<bool> cancelled { false };
+    };
+
+    IRLoadQueue();
+    ~IRLoadQueue() override;
+
+    // The queue keeps a reference, so a client outlives its owner until the
+    // load it may be running has finished
+    void registerClient(std::shared_ptr<Client> client);
+
+    // Returns at once and cancels the client; never waits for its load
+    void unregisterClient(Client* client);
+
+    // Serviced ahead of everyone else (nullptr = plain round robin)
+    void setPriorityClient(Client* client);
+    void clearPriorityClient(Client* client);
+
+    // Wake the worker now instead of at its next poll (not for the audio thread)
+    void wakeUp() { notify(); }
+
+private:
+    void run() override;
+
+    std::shared_ptr<Client> pickNextClient();
+
+    juce::CriticalSection clientLock;    // guards clients, priorityClient, nextIndex
+
+    std::vector<std::shared_ptr<Client>> clients;
+    Client* priorityClient = nullptr;
+    int nextIndex = 0;
+
+    // Audio-thread requests are only flagged, so the worker polls for them
+    static constexpr int kPollIntervalMs = 20;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IRLoadQueue)
+};
@@ -1,6 +1,33 @@
 #include "CustomDelays.h"
+#include "../DSPKernels.h"
 #include <algorithm>
 #include <cmath>
+#include <type_traits>
+
+juce::String getDelayStorageName(DelayStorage storage)
+{
+    switch (storage)
+    {
+        case DelayStorage::Float16:  return "fp16";
+        case DelayStorage::BFloat16: return "bf16";
+        case DelayStorage::Float32:
+        default:                     return "float32";
+    }
+}
+
+bool parseDelayStorage(const juce::String& name, DelayStorage& result)
+{
+    for (auto storage : { DelayStorage::Float32, DelayStorage::Float16, DelayStorage::BFloat16 })
+    {
+        if (name.trim().equalsIgnoreCase(getDelayStorageName(storage)))
+        {
+            result = storage;
+            return true;
+        }
+    }
+
+    return false;
+}
 
 //==============================================================================
 // DelayLineWithSampleAccess
@@ -11,38 +38,92 @@ DelayLineWithSampleAccess<SampleType>::DelayLineWithSampleAccess(int maximumDela
 {
     jassert(maximumDelayInSamples >= 0);
 
+    // Storage waits for prepare()
     totalSize = std::max(maximumDelayInSamples + 1, 4);
-    delayBuffer.setSize(1, totalSize, false, false, false);
-    delayBuffer.clear();
-
-    numSamples = delayBuffer.getNumSamples();
+    numSamples = totalSize;
 }
 
 template <typename SampleType>
 DelayLineWithSampleAccess<SampleType>::~DelayLineWithSampleAccess() {}
 
+template <typename SampleType>
+SampleType DelayLineWithSampleAccess<SampleType>::load(int channel, int index) const
+{
+    switch (storage)
+    {
+        case DelayStorage::Float16:  return (SampleType) HalfFloat::halfToFloat(getPackedChannel(channel)[index]);
+        case DelayStorage::BFloat16: return (SampleType) HalfFloat::bfloat16ToFloat(getPackedChannel(channel)[index]);
+        case DelayStorage::Float32:
+        default:                     return getChannel(channel)[index];
+    }
+}
+
+template <typename SampleType>
+void DelayLineWithSampleAccess<SampleType>::store(int channel, int index, SampleType value)
+{
+    switch (storage)
+    {
+        case DelayStorage::Float16:  getPackedChannel(channel)[index] = HalfFloat::floatToHalf((float) value); break;
+        case DelayStorage::BFloat16: getPackedChannel(channel)[index] = HalfFloat::floatToBFloat16((float) value); break;
+        case DelayStorage::Float32:
+        default:                     getChannel(channel)[index] = value; break;
+    }
+}
+
+template <typename SampleType>
+void DelayLineWithSampleAccess<SampleType>::decode(const juce::uint16* source, SampleType* dest, int num) const
+{
+    // setStorage() keeps double lines at Float32, so only floats get here
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        if (storage == DelayStorage::Float16)
+            DSPKernels::get().halfToFloat(source, dest, num);
+        else
+            HalfFloat::bfloat16ToFloat(source, dest, num);
+    }
+    else
+    {
+        juce::ignoreUnused(source, dest, num);
+        jassertfalse;
+    }
+}
+
+template <typename SampleType>
+void DelayLineWithSampleAccess<SampleType>::encode(const SampleType* source, juce::uint16* dest, int num) const
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        if (storage == DelayStorage::Float16)
+            DSPKernels::get().floatToHalf(source, dest, num);
+        else
+            HalfFloat::floatToBFloat16(source, dest, num);
+    }
+    else
+    {
+        juce::ignoreUnused(source, dest, num);
+        jassertfalse;
+    }
+}
+
 template <typename SampleType>
 void DelayLineWithSampleAccess<SampleType>::pushSample(int channel, SampleType newValue)
 {
-    const size_t ch = static_cast<size_t>(channel);
-    delayBuffer.setSample(channel, writePosition[ch], newValue);
-    writePosition[ch] = (writePosition[ch] + 1) % numSamples;
+    store(channel, writePosition[channel], newValue);
+    writePosition[channel] = (writePosition[channel] + 1) % numSamples;
 }
 
 template <typename SampleType>
 SampleType DelayLineWithSampleAccess<SampleType>::popSample(int channel)
 {
-    const size_t ch = static_cast<size_t>(channel);
-    const int readPos = (writePosition[ch] - delayInSamples + numSamples) % numSamples;
-    readPosition[ch] = readPos;
-    return delayBuffer.getSample(channel, readPos);
+    const int readPos = (writePosition[channel] - delayInSamples + numSamples) % numSamples;
+    return load(channel, readPos);
 }
 
 template <typename SampleType>
 SampleType DelayLineWithSampleAccess<SampleType>::getSampleAtDelay(int channel, int delay) const
 {
-    const int idx = (writePosition[static_cast<size_t>(channel)] - delay + numSamples) % numSamples;
-    return delayBuffer.getSample(channel, idx);
+    const int idx = (writePosition[channel] - delay + numSamples) % numSamples;
+    return load(channel, idx);
 }
 
 template <typename SampleType>
@@ -73,57 +154,274 @@ SampleType DelayLineWithSampleAccess<SampleType>::readFractional(int channel, fl
 {
     delaySamples = juce::jlimit(1.0f, (float)(numSamples - 1), delaySamples);
 
-    const int writePos = writePosition[(size_t) channel];
+    const int writePos = writePosition[channel];
     const int delayInt = (int) std::floor(delaySamples);
     const float frac = delaySamples - (float) delayInt;
 
     const int idx1 = (writePos - delayInt + numSamples) % numSamples;
     const int idx2 = (writePos - delayInt - 1 + numSamples) % numSamples;
 
-    const SampleType s1 = delayBuffer.getSample(channel, idx1);
-    const SampleType s2 = delayBuffer.getSample(channel, idx2);
+    const SampleType s1 = load(channel, idx1);
+    const SampleType s2 = load(channel, idx2);
 
     return s1 + frac * (s2 - s1);
 }
 
+template <typename SampleType>
+void DelayLineWithSampleAccess<SampleType>::readBlock(int channel, int delay, SampleType* dest, int numToRead) const
+{
+    jassert(delay >= numToRead && delay < numSamples);
+
+    const int start = (writePosition[channel] - delay + numSamples) % numSamples;
+    const int firstPart = std::min(numToRead, numSamples - start);
+
+    if (storage != DelayStorage::Float32)
+    {
+        const juce::uint16* samples = getPackedChannel(channel);
+        decode(samples + start, dest, firstPart);
+        decode(samples, dest + firstPart, numToRead - firstPart);
+        return;
+    }
+
+    const SampleType* samples = getChannel(channel);
+
+    std::copy(samples + start, samples + start + firstPart, dest);
+    std::copy(samples, samples + (numToRead - firstPart), dest + firstPart);
+}
+
+template <typename SampleType>
+void DelayLineWithSampleAccess<SampleType>::writeBlock(int channel, const SampleType* source, int numToWrite)
+{
+    jassert(numToWrite <= numSamples);
+
+    const int start = writePosition[channel];
+    const int firstPart = std::min(numToWrite, numSamples - start);
+
+    if (storage != DelayStorage::Float32)
+    {
+        juce::uint16* samples = getPackedChannel(channel);
+        encode(source, samples + start, firstPart);
+        encode(source + firstPart, samples, numToWrite - firstPart);
+    }
+    else
+    {
+        SampleType* samples = getChannel(channel);
+
+        std::copy(source, source + firstPart, samples + start);
+        std::copy(source + firstPart, source + numToWrite, samples);
+    }
+
+    writePosition[channel] = (start + numToWrite) % numSamples;
+}
+
+template <typename SampleType>
+int DelayLineWithSampleAccess<SampleType>::getDelayInSamples() const
+{
+    return delayInSamples;
+}
+
+template <typename SampleType>
+void DelayLineWithSampleAccess<SampleType>::readFractionalBlock(int channel,
+                                                                const float* delays,
+                                                                SampleType* dest,
+                                                                int numToRead,
+                                                                DelayInterpolation interpolation,
+                                                                SampleType& allpassState) const
+{
+    constexpr int chunkSize = 64;
+
+    const int writePos = writePosition[channel];
+    const int size = numSamples;
+
+    // Indices stay within one buffer length either side
+    auto wrap = [size](int index) { return index < 0 ? index + size : (index >= size ? index - size : index); };
+
+    SampleType newer[chunkSize], current[chunkSize], older[chunkSize], oldest[chunkSize], frac[chunkSize];
+
+    for (int start = 0; start < numToRead; start += chunkSize)
+    {
+        const int num = std::min(chunkSize, numToRead - start);
+
+        // 1) Gather the four neighbours of each read position, with the
+        //    storage picked once per chunk rather than per sample
+        auto gather = [&](auto read)
+        {
+            for (int i = 0; i < num; ++i)
+            {
+                const int n = start + i;
+                const float delaySamples = juce::jlimit(2.0f, (float) (size - 3), delays[n]);
+                jassert(delays[n] >= (float) (n + 2));
+
+                int delayInt = (int) delaySamples;
+                SampleType delayFrac = (SampleType) (delaySamples - (float) delayInt);
+
+                // Keeps the allpass coefficient away from the unstable end
+                if (interpolation == DelayInterpolation::Allpass && delayFrac < (SampleType) 0.618 && delayInt > 1)
+                {
+                    delayFrac += (SampleType) 1;
+                    --delayInt;
+                }
+
+                const int index = wrap(writePos + n - delayInt);
+
+                newer[i]   = read(wrap(index + 1));
+                current[i] = read(index);
+                older[i]   = read(wrap(index - 1));
+                oldest[i]  = read(wrap(index - 2));
+                frac[i]    = delayFrac;
+            }
+        };
+
+        switch (storage)
+        {
+            case DelayStorage::Float16:
+            {
+                const juce::uint16* samples = getPackedChannel(channel);
+                gather([samples](int index) { return (SampleType) HalfFloat::halfToFloat(samples[index]); });
+                break;
+            }
+
+            case DelayStorage::BFloat16:
+            {
+                const juce::uint16* samples = getPackedChannel(channel);
+                gather([samples](int index) { return (SampleType) HalfFloat::bfloat16ToFloat(samples[index]); });
+                break;
+            }
+
+            case DelayStorage::Float32:
+            default:
+            {
+                const SampleType* samples = getChannel(channel);
+                gather([samples](int index) { return samples[index]; });
+                break;
+            }
+        }
+
+        SampleType* out = dest + start;
+
+        // 2) Interpolate
+        switch (interpolation)
+        {
+            case DelayInterpolation::Cubic:
+                // Catmull-Rom (Hermite) spline through the four samples
+                for (int i = 0; i < num; ++i)
+                {
+                    const SampleType f = frac[i];
+                    const SampleType c1 = (SampleType) 0.5 * (older[i] - newer[i]);
+                    const SampleType c2 = newer[i] - (SampleType) 2.5 * current[i] + (SampleType) 2 * older[i] - (SampleType) 0.5 * oldest[i];
+                    const SampleType c3 = (SampleType) 0.5 * (oldest[i] - newer[i]) + (SampleType) 1.5 * (current[i] - older[i]);
+                    out[i] = ((c3 * f + c2) * f + c1) * f + current[i];
+                }
+                break;
+
+            case DelayInterpolation::Lagrange:
+                // Third-order Lagrange polynomial at offsets -1, 0, 1, 2
+                for (int i = 0; i < num; ++i)
+                {
+                    const SampleType f = frac[i];
+                    const SampleType fm1 = f - (SampleType) 1;
+                    const SampleType fm2 = f - (SampleType) 2;
+                    const SampleType fp1 = f + (SampleType) 1;
+
+                    out[i] = newer[i]   * (-f * fm1 * fm2 / (SampleType) 6)
+                           + current[i] * (fp1 * fm1 * fm2 / (SampleType) 2)
+                           + older[i]   * (-fp1 * f * fm2 / (SampleType) 2)
+                           + oldest[i]  * (fp1 * f * fm1 / (SampleType) 6);
+                }
+                break;
+
+            case DelayInterpolation::Allpass:
+            {
+                // First-order allpass: recursive, so this loop stays scalar
+                SampleType state = allpassState;
+
+                for (int i = 0; i < num; ++i)
+                {
+                    const SampleType alpha = ((SampleType) 1 - frac[i]) / ((SampleType) 1 + frac[i]);
+                    state = older[i] + alpha * (current[i] - state);
+                    out[i] = state;
+                }
+
+                allpassState = state;
+                break;
+            }
+        }
+    }
+}
+
 template <typename SampleType>
 void DelayLineWithSampleAccess<SampleType>::setSize(const int numChannels, const int newSize)
 {
-    totalSize = newSize;
-    delayBuffer.setSize(numChannels, totalSize, false, false, true);
-    reset();
+    totalSize = std::max(newSize, 4);
+    prepare({ sampleRate, 0, (juce::uint32) numChannels });
 }
 
 template <typename SampleType>
 int DelayLineWithSampleAccess<SampleType>::getNumSamples() const
 {
-    return delayBuffer.getNumSamples();
+    return numSamples;
 }
 
 template <typename SampleType>
-void DelayLineWithSampleAccess<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+void DelayLineWithSampleAccess<SampleType>::setStorage(DelayStorage newStorage)
 {
-    jassert(spec.numChannels > 0);
+    constexpr bool isFloat = std::is_same_v<SampleType, float>;
+    jassert(isFloat || newStorage == DelayStorage::Float32);
 
-    delayBuffer.setSize((int) spec.numChannels, totalSize, false, false, true);
+    storage = isFloat ? newStorage : DelayStorage::Float32;
+}
 
-    writePosition.resize(spec.numChannels);
-    readPosition.resize(spec.numChannels);
-    v.resize(spec.numChannels);
+template <typename SampleType>
+void DelayLineWithSampleAccess<SampleType>::prepare(const juce::dsp::ProcessSpec& spec, DelayArena& arena, const char* name)
+{
+    jassert(spec.numChannels > 0);
 
+    numChannels = (int) spec.numChannels;
+    numSamples = totalSize;
     sampleRate = spec.sampleRate;
 
+    // Each channel starts on its own cache line
+    const size_t bytesPerSample = storage == DelayStorage::Float32 ? sizeof(SampleType) : sizeof(juce::uint16);
+    const int samplesPerLine = (int) (DelayArena::alignment / bytesPerSample);
+    channelStride = (numSamples + samplesPerLine - 1) / samplesPerLine * samplesPerLine;
+
+    const size_t count = (size_t) channelStride * (size_t) numChannels;
+
+    data = storage == DelayStorage::Float32 ? arena.take<SampleType>(count, name) : nullptr;
+    packed = storage != DelayStorage::Float32 ? arena.take<juce::uint16>(count, name) : nullptr;
+    writePosition = arena.take<int>((size_t) numChannels, name);
+
     reset();
 }
 
+template <typename SampleType>
+void DelayLineWithSampleAccess<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    if (ownArena == nullptr)
+        ownArena = std::make_unique<DelayArena>();
+
+    ownArena->beginLayout();
+    prepare(spec, *ownArena);
+    ownArena->allocate(false);
+    prepare(spec, *ownArena);
+}
+
 template <typename SampleType>
 void DelayLineWithSampleAccess<SampleType>::reset()
 {
-    std::fill(writePosition.begin(), writePosition.end(), 0);
-    std::fill(readPosition.begin(), readPosition.end(), 0);
-    std::fill(v.begin(), v.end(), (SampleType) 0);
+    // Nothing to clear during an arena's counting pass
+    if (writePosition == nullptr)
+        return;
+
+    const size_t count = (size_t) channelStride * (size_t) numChannels;
+
+    std::fill(writePosition, writePosition + numChannels, 0);
 
-    delayBuffer.clear();
+    // Zero is all-zero bits in every storage
+    if (data != nullptr)
+        std::fill(data, data + count, (SampleType) 0);
+    else
+        std::fill(packed, packed + count, (juce::uint16) 0);
 }
 
 //==============================================================================
@@ -150,29 +448,42 @@ void Allpass<SampleType>::setDelay(SampleType newDelayInSamples)
 }
 
 template <typename SampleType>
-void Allpass<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+void Allpass<SampleType>::prepare(const juce::dsp::ProcessSpec& spec, DelayArena& arena, const char* name)
 {
     sampleRate = spec.sampleRate;
+    numChannels = (int) spec.numChannels;
 
-    delayLine.prepare(spec);
+    delayLine.prepare(spec, arena, name);
 
-    drySample.resize(spec.numChannels);
-    delayOutput.resize(spec.numChannels);
-    feedforward.resize(spec.numChannels);
-    feedback.resize(spec.numChannels);
+    auto* state = arena.take<SampleType>(4 * (size_t) numChannels, name);
 
-    std::fill(drySample.begin(), drySample.end(), 0);
-    std::fill(delayOutput.begin(), delayOutput.end(), 0);
-    std::fill(feedforward.begin(), feedforward.end(), 0);
-    std::fill(feedback.begin(), feedback.end(), 0);
+    drySample   = state;
+    delayOutput = state != nullptr ? state + numChannels : nullptr;
+    feedforward = state != nullptr ? state + 2 * numChannels : nullptr;
+    feedback    = state != nullptr ? state + 3 * numChannels : nullptr;
 
     reset();
 }
 
+template <typename SampleType>
+void Allpass<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    if (ownArena == nullptr)
+        ownArena = std::make_unique<DelayArena>();
+
+    ownArena->beginLayout();
+    prepare(spec, *ownArena);
+    ownArena->allocate(false);
+    prepare(spec, *ownArena);
+}
+
 template <typename SampleType>
 void Allpass<SampleType>::reset()
 {
     delayLine.reset();
+
+    if (drySample != nullptr)
+        std::fill(drySample, drySample + 4 * numChannels, (SampleType) 0);
 }
 
 template <typename SampleType>
@@ -1,6 +1,9 @@
 /*
 Tapped delay line, Allpass classes
 Delay based on juce::dsp::DelayLine, but allows access to the underlying buffer at specified sample offsets for multiple-tap delays.
+Storage comes from a DelayArena: the algorithm's own, shared by all its lines, or a private one.
+Float lines can store their history as 16-bit floats (HalfFloat.h), halving the memory and the
+bandwidth of long lines; samples are converted as they are written and read.
 */
 
 #pragma once
@@ -22,6 +25,22 @@ Delay based on juce::dsp::DelayLine, but allows access to the underlying buffer
   #include <juce_gui_extra/juce_gui_extra.h>
 #endif
 // #include "Utilities.h"
+#include "DelayArena.h"
+#include "../HalfFloat.h"
+
+// Kernels for block fractional reads (modulated delays)
+enum class DelayInterpolation { Cubic, Lagrange, Allpass };
+
+// How a line stores its samples. One pass through a Float16 line leaves
+// rounding noise about 72 dB below the signal (never above -150 dBFS for
+// quiet signals), BFloat16 about 54 dB below. In a reverb tank the noise
+// recirculates with the tail: about -68 and -50 dB over a 4 s RT60 network's
+// first two seconds (see DSPTests).
+enum class DelayStorage { Float32, Float16, BFloat16 };
+
+// "float32", "fp16" and "bf16", as ADSRECHO_DELAY_STORAGE and --storage take them
+juce::String getDelayStorageName(DelayStorage storage);
+bool parseDelayStorage(const juce::String& name, DelayStorage& result);
 
 template <typename SampleType>
 class DelayLineWithSampleAccess
@@ -32,6 +51,9 @@ public:
     DelayLineWithSampleAccess(int maximumDelayInSamples);
     
     ~DelayLineWithSampleAccess();
+
+    DelayLineWithSampleAccess(DelayLineWithSampleAccess&&) noexcept = default;
+    DelayLineWithSampleAccess& operator=(DelayLineWithSampleAccess&&) noexcept = default;
     
     void pushSample(int channel, SampleType newValue);
     
@@ -43,25 +65,66 @@ public:
     void setDelay(float newDelayInSamples);
 
     SampleType readFractional(int channel, float delayInSamples) const;
+
+    // Block access for delays of at least numToRead samples: the samples the
+    // next numToRead popSample() calls would return, and the matching writes
+    void readBlock(int channel, int delay, SampleType* dest, int numToRead) const;
+    void writeBlock(int channel, const SampleType* source, int numToWrite);
+
+    int getDelayInSamples() const;
+
+    // Fractional reads for the next numToRead samples, delays[i] being the
+    // delay of the i-th one. Each must be at least i + 2 so nothing read is
+    // written during the block. Samples are gathered a chunk at a time and the
+    // kernel then runs over plain arrays, so it vectorises. allpassState
+    // carries the allpass interpolator from one block to the next.
+    void readFractionalBlock(int channel, const float* delays, SampleType* dest, int numToRead,
+                             DelayInterpolation interpolation, SampleType& allpassState) const;
     
     void setSize(const int numChannels, const int newSize);
     
     int getNumSamples() const;
-    
+
+    // Takes effect at the next prepare(). Float lines only: double lines
+    // always store doubles.
+    void setStorage(DelayStorage newStorage);
+    DelayStorage getStorage() const { return storage; }
+    
+    // Samples and write positions come out of the arena; call it in both of
+    // the arena's passes, with spec.numChannels the channels actually used
+    void prepare(const juce::dsp::ProcessSpec& spec, DelayArena& arena, const char* name = "delay line");
+
+    // Standalone: the line gets an arena of its own
     void prepare(const juce::dsp::ProcessSpec& spec);
     
     void reset();
 private:
-    juce::AudioBuffer<SampleType> delayBuffer;
-    std::vector<SampleType> v;
-    int numSamples = 0;
-    std::vector<int> writePosition, readPosition;
-    SampleType delay = 0.0, delayFrac = 0.0;
+    SampleType* getChannel(int channel) const { return data + (size_t) channel * (size_t) channelStride; }
+    juce::uint16* getPackedChannel(int channel) const { return packed + (size_t) channel * (size_t) channelStride; }
+
+    // One sample, whatever the storage
+    SampleType load(int channel, int index) const;
+    void store(int channel, int index, SampleType value);
+
+    // Runs of samples, converted a block at a time
+    void decode(const juce::uint16* source, SampleType* dest, int num) const;
+    void encode(const SampleType* source, juce::uint16* dest, int num) const;
+
+    DelayStorage storage = DelayStorage::Float32;
+
+    SampleType* data = nullptr;         // numChannels runs of channelStride samples
+    juce::uint16* packed = nullptr;     // the same, as 16-bit floats, instead of data
+    int* writePosition = nullptr;       // per channel
+    int numChannels = 0;
+    int channelStride = 0;              // numSamples rounded up to whole cache lines
+    int numSamples = 4;
     int delayInSamples = 0;
     int totalSize = 4;
     float fractionalDelay = 0.0f;
     
     double sampleRate = 44100.0;
+
+    std::unique_ptr<DelayArena> ownArena;
 };
 
 //============================================================================
@@ -78,6 +141,8 @@ public:
     
     void setDelay(SampleType newDelayInSamples);
     
+    // As DelayLineWithSampleAccess: both arena passes, or standalone
+    void prepare(const juce::dsp::ProcessSpec& spec, DelayArena& arena, const char* name = "allpass");
     void prepare(const juce::dsp::ProcessSpec& spec);
     
     void reset();
@@ -95,10 +160,14 @@ private:
     
     SampleType gain = 0.5;
     
-    std::vector<SampleType> drySample { };
-    std::vector<SampleType> delayOutput { };
-    std::vector<SampleType> feedforward { };
-    std::vector<SampleType> feedback { };
+    // Per channel, carved next to the line
+    SampleType* drySample = nullptr;
+    SampleType* delayOutput = nullptr;
+    SampleType* feedforward = nullptr;
+    SampleType* feedback = nullptr;
+    int numChannels = 0;
     
     SampleType sampleRate = 44100.0;
+
+    std::unique_ptr<DelayArena> ownArena;
 };
\ No newline at end of file
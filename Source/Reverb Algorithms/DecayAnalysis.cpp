@@ -0,0 +1,199 @@
+#include "DecayAnalysis.h"
+
+namespace DecayAnalysis
+{
+namespace
+{
+    constexpr int renderBlockSize = 512;
+
+    // Parameter smoothers (pre-delay, decay) settle before the impulse
+    constexpr double settleSeconds = 0.25;
+
+    // Rendering ends once the source's hold time has stayed below the floor
+    constexpr float floorDb = -90.0f;
+
+    // A source still silent by then (disabled, or a dead-end setting) has no tail
+    constexpr double silentLimitSeconds = 5.0;
+
+    // Schroeder backward integration, sampled every `hop` samples
+    std::vector<float> energyDecayCurve(const std::vector<float>& h, int hop)
+    {
+        std::vector<float> edc;
+
+        if (h.empty())
+            return edc;
+
+        std::vector<double> remaining(h.size() + 1, 0.0);
+
+        for (size_t i = h.size(); i-- > 0;)
+            remaining[i] = remaining[i + 1] + (double) h[i] * h[i];
+
+        const double total = remaining[0];
+
+        if (total <= 0.0)
+            return edc;
+
+        edc.reserve(h.size() / (size_t) hop + 1);
+
+        for (size_t i = 0; i < h.size(); i += (size_t) hop)
+            edc.push_back(juce::jmax(-200.0f, (float) (10.0 * std::log10(remaining[i] / total + 1.0e-20))));
+
+        return edc;
+    }
+
+    // Least-squares line through the EDC between -5 dB and the deepest of
+    // -35 / -25 / -15 dB it reaches (T30, T20, T10), extrapolated to -60 dB
+    bool fitDecay(const std::vector<float>& edcDb, double& slopeDbPerSecond, double& interceptDb)
+    {
+        for (const float end : { -35.0f, -25.0f, -15.0f })
+        {
+            double n = 0.0, sumT = 0.0, sumL = 0.0, sumTT = 0.0, sumTL = 0.0;
+
+            for (size_t i = 0; i < edcDb.size(); ++i)
+            {
+                if (edcDb[i] > -5.0f)
+                    continue;
+
+                if (edcDb[i] < end)
+                    break;
+
+                const double t = (double) i * edcResolutionSeconds;
+                n += 1.0;
+                sumT += t;
+                sumL += edcDb[i];
+                sumTT += t * t;
+                sumTL += t * edcDb[i];
+            }
+
+            const bool reachesEnd = !edcDb.empty() && edcDb.back() <= end;
+            const double denominator = n * sumTT - sumT * sumT;
+
+            if (!reachesEnd || n < 3.0 || denominator <= 0.0)
+                continue;
+
+            slopeDbPerSecond = (n * sumTL - sumT * sumL) / denominator;
+            interceptDb = (sumL - slopeDbPerSecond * sumT) / n;
+
+            if (slopeDbPerSecond < 0.0)
+                return true;
+        }
+
+        return false;
+    }
+
+    Curve makeCurve(const std::vector<float>& h, int hop)
+    {
+        Curve curve;
+        curve.edcDb = energyDecayCurve(h, hop);
+
+        double slope = 0.0, intercept = 0.0;
+
+        if (fitDecay(curve.edcDb, slope, intercept))
+            curve.rt60 = (float) (-60.0 / slope);
+
+        return curve;
+    }
+
+    // Fourth-order octave band pass: two RBJ band passes in series
+    std::vector<float> bandPass(const std::vector<float>& h, double sampleRate, float centre)
+    {
+        auto coefficients = juce::dsp::IIR::Coefficients<float>::makeBandPass(sampleRate, centre,
+                                                                              juce::MathConstants<float>::sqrt2);
+        juce::dsp::IIR::Filter<float> first(coefficients), second(coefficients);
+
+        std::vector<float> out(h.size());
+
+        for (size_t i = 0; i < h.size(); ++i)
+            out[i] = second.processSample(first.processSample(h[i]));
+
+        return out;
+    }
+}
+
+std::vector<float> render(Source& source, double sampleRate, double maxSeconds,
+                          const std::function<bool()>& shouldStop)
+{
+    source.prepare({ sampleRate, (juce::uint32) renderBlockSize, 2 });
+
+    juce::AudioBuffer<float> block(2, renderBlockSize);
+
+    for (int settled = 0; settled < (int) (settleSeconds * sampleRate); settled += renderBlockSize)
+    {
+        block.clear();
+        source.process(block);
+    }
+
+    // The response starts at the impulse
+    std::vector<float> response;
+    response.reserve((size_t) (sampleRate * juce::jmin(maxSeconds, 4.0)));
+
+    const auto maxSamples = (size_t) (maxSeconds * sampleRate);
+    const auto holdSamples = (size_t) (source.getHoldSeconds() * sampleRate);
+    const auto silentLimit = (size_t) (silentLimitSeconds * sampleRate);
+    const float floorGain = juce::Decibels::decibelsToGain(floorDb);
+
+    float peak = 0.0f;
+    size_t quiet = 0;
+
+    while (response.size() < maxSamples)
+    {
+        if (shouldStop())
+            return {};
+
+        block.clear();
+
+        if (response.empty())
+        {
+            block.setSample(0, 0, 1.0f);
+            block.setSample(1, 0, 1.0f);
+        }
+
+        source.process(block);
+
+        const auto* left = block.getReadPointer(0);
+        const auto* right = block.getReadPointer(1);
+
+        for (int i = 0; i < renderBlockSize; ++i)
+        {
+            const float x = 0.5f * (left[i] + right[i]);
+            response.push_back(x);
+
+            peak = juce::jmax(peak, std::abs(x));
+            quiet = std::abs(x) <= peak * floorGain ? quiet + 1 : 0;
+        }
+
+        if (peak > 0.0f && quiet >= holdSamples)
+            break;
+
+        if (peak == 0.0f && response.size() >= silentLimit)
+            return {};
+    }
+
+    // Trailing silence would only flatten the end of the curves
+    response.resize(response.size() - juce::jmin(quiet, response.size()));
+    return response;
+}
+
+Result analyse(const std::vector<float>& impulseResponse, double sampleRate)
+{
+    Result result;
+
+    const int hop = juce::jmax(1, (int) std::round(edcResolutionSeconds * sampleRate));
+
+    result.broadband = makeCurve(impulseResponse, hop);
+
+    for (int b = 0; b < numBands; ++b)
+        if (bandCentres[b] < 0.45 * sampleRate)
+            result.bands[b] = makeCurve(bandPass(impulseResponse, sampleRate, bandCentres[b]), hop);
+
+    double slope = 0.0, intercept = 0.0;
+
+    if (fitDecay(result.broadband.edcDb, slope, intercept))
+        result.tailSeconds = (-60.0 - intercept) / slope;
+    else
+        result.tailSeconds = (double) impulseResponse.size() / sampleRate;
+
+    result.tailSeconds = juce::jmax(0.0, result.tailSeconds);
+    return result;
+}
+}
@@ -0,0 +1,62 @@
+// DecayAnalysis.h - Energy decay curves and RT60 of an impulse response
+//
+// render() feeds a unit impulse through an offline copy of a module's DSP and
+// keeps going until the response has died away; analyse() turns the response
+// into Schroeder energy decay curves (backward-integrated energy, in dB) for
+// the broadband signal and each octave band, and fits RT60 to them. Used by
+// DecayAnalyser on its worker thread, never on the audio thread.
+
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_dsp/juce_dsp.h>
+#endif
+
+namespace DecayAnalysis
+{
+    constexpr int numBands = 7;
+    constexpr float bandCentres[numBands] = { 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f };
+
+    // EDC points are this far apart
+    constexpr double edcResolutionSeconds = 0.005;
+
+    struct Curve
+    {
+        std::vector<float> edcDb;   // 0 dB at the start, one point per edcResolutionSeconds
+        float rt60 = 0.0f;          // seconds; 0 if the curve is too short to fit
+    };
+
+    struct Result
+    {
+        Curve broadband;
+        Curve bands[numBands];      // empty above 0.45 * sample rate
+
+        // Until the broadband decay reaches -60 dB, pre-delay included
+        double tailSeconds = 0.0;
+    };
+
+    // A copy of a module's DSP, configured like the module and fully wet
+    class Source
+    {
+    public:
+        virtual ~Source() = default;
+
+        virtual void prepare(const juce::dsp::ProcessSpec& spec) = 0;
+        virtual void process(juce::AudioBuffer<float>& buffer) = 0;
+
+        // Longest gap the response can have before it is over, e.g. between echoes
+        virtual double getHoldSeconds() const { return 0.2; }
+    };
+
+    // Stereo impulse response, summed to mono. Stops once the response has
+    // stayed 90 dB below its peak for the source's hold time, or after
+    // maxSeconds. Empty if shouldStop returned true or the source stayed
+    // silent.
+    std::vector<float> render(Source& source, double sampleRate, double maxSeconds,
+                              const std::function<bool()>& shouldStop);
+
+    Result analyse(const std::vector<float>& impulseResponse, double sampleRate);
+}
@@ -11,14 +11,37 @@ void BasicDelay::prepare(const juce::dsp::ProcessSpec& spec)
     juce::dsp::ProcessSpec monoSpec = spec;
     monoSpec.numChannels = 1;
 
-    delayLineL.prepare(monoSpec);
-    delayLineR.prepare(monoSpec);
+    delayLineL.setStorage(delayStorage);
+    delayLineR.setStorage(delayStorage);
+
+    arena.beginLayout();
+    delayLineL.prepare(monoSpec, arena, "delay lines");
+    delayLineR.prepare(monoSpec, arena, "delay lines");
+    arena.allocate();
+    delayLineL.prepare(monoSpec, arena, "delay lines");
+    delayLineR.prepare(monoSpec, arena, "delay lines");
 
     // Recalculate delay time in samples
-    delayTimeSamples = (delayTimeMs / 1000.0f) * sampleRate;
+    delayTimeSamples = std::round((delayTimeMs / 1000.0f) * sampleRate);
     delayLineL.setDelay(delayTimeSamples);
     delayLineR.setDelay(delayTimeSamples);
 
+    smoothedDelay.reset(spec.sampleRate, kDelayGlideSeconds);
+    smoothedDelay.setCurrentAndTargetValue((double) delayLineL.getDelayInSamples());
+
+    // Tape modulation: slow wow, faster flutter
+    OscillatorParameters wowParams;
+    wowParams.waveform = generatorWaveform::sin;
+    wowParams.frequency_Hz = 0.7;
+    wowLFO.setParameters(wowParams);
+    wowLFO.prepare(spec);
+
+    OscillatorParameters flutterParams;
+    flutterParams.waveform = generatorWaveform::sin;
+    flutterParams.frequency_Hz = 6.3;
+    flutterLFO.setParameters(flutterParams);
+    flutterLFO.prepare(spec);
+
     // Prepare feedback path filters
     lowpassL.prepare(monoSpec);
     lowpassR.prepare(monoSpec);
@@ -35,6 +58,9 @@ void BasicDelay::prepare(const juce::dsp::ProcessSpec& spec)
     highpassL.setCutoffFrequency(highpassFreqValue);
     highpassR.setCutoffFrequency(highpassFreqValue);
 
+    maxBlockSize = (int) spec.maximumBlockSize;
+    scratch.setSize(numScratchChannels, maxBlockSize + 1);
+
     reset();
 }
 
@@ -46,6 +72,40 @@ void BasicDelay::processBlock(juce::AudioBuffer<float>& buffer)
     float* leftChannel = buffer.getWritePointer(0);
     float* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
 
+    // Both lines always share the same delay
+    const int delaySamples = delayLineL.getDelayInSamples();
+
+    if (delayMode == DelayMode::Tape && maxBlockSize > 0)
+    {
+        for (int start = 0; start < numSamples; start += maxBlockSize)
+        {
+            const int num = juce::jmin(maxBlockSize, numSamples - start);
+            processTape(leftChannel + start,
+                        rightChannel != nullptr ? rightChannel + start : nullptr,
+                        num);
+        }
+
+        return;
+    }
+
+    if (delaySamples < numSamples || maxBlockSize <= 0 || smoothedDelay.isSmoothing())
+    {
+        processSamples(leftChannel, rightChannel, numSamples);
+        return;
+    }
+
+    // Hosts may send more than the prepared block size
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+    {
+        const int num = juce::jmin(maxBlockSize, numSamples - start);
+        processBlockCopy(leftChannel + start,
+                         rightChannel != nullptr ? rightChannel + start : nullptr,
+                         num);
+    }
+}
+
+void BasicDelay::processSamples(float* leftChannel, float* rightChannel, int numSamples)
+{
     // Cache values to avoid repeated member access in tight loop
     const float wet = mixAmount;
     const float dry = 1.0f - mixAmount;
@@ -58,16 +118,20 @@ void BasicDelay::processBlock(juce::AudioBuffer<float>& buffer)
     const float panGainR = 1.0f + juce::jmin(0.0f, panValue);
     const float phaseSign = (delayMode == DelayMode::Inverted) ? -1.0f : 1.0f;
     const bool isPingPong = (delayMode == DelayMode::PingPong) && (rightChannel != nullptr);
+    const bool isGliding = smoothedDelay.isSmoothing();
 
     for (int i = 0; i < numSamples; ++i)
     {
+        // Fractional reads only while gliding
+        const float glideDelay = isGliding ? (float) smoothedDelay.getNextValue() : 0.0f;
+
         float inputL = leftChannel[i];
-        float delayedL = delayLineL.popSample(0);
+        float delayedL = isGliding ? delayLineL.readFractional(0, glideDelay) : delayLineL.popSample(0);
 
         if (rightChannel != nullptr)
         {
             float inputR = rightChannel[i];
-            float delayedR = delayLineR.popSample(0);
+            float delayedR = isGliding ? delayLineR.readFractional(0, glideDelay) : delayLineR.popSample(0);
 
             // Push with mode-dependent feedback routing
             // fbL/fbR already filtered from previous iteration
@@ -102,6 +166,159 @@ void BasicDelay::processBlock(juce::AudioBuffer<float>& buffer)
     // Store feedback state back
     feedbackL = fbL;
     feedbackR = fbR;
+
+    if (isGliding)
+        finishGlide();
+}
+
+void BasicDelay::processBlockCopy(float* leftChannel, float* rightChannel, int numSamples)
+{
+    const int delaySamples = delayLineL.getDelayInSamples();
+
+    // Delayed samples for the whole block
+    delayLineL.readBlock(0, delaySamples, scratch.getWritePointer(delayedLeft), numSamples);
+
+    if (rightChannel != nullptr)
+        delayLineR.readBlock(0, delaySamples, scratch.getWritePointer(delayedRight), numSamples);
+
+    mixDelayedBlock(leftChannel, rightChannel, numSamples);
+}
+
+void BasicDelay::processTape(float* leftChannel, float* rightChannel, int numSamples)
+{
+    float* delaysL = scratch.getWritePointer(tapeDelayLeft);
+    float* delaysR = scratch.getWritePointer(tapeDelayRight);
+
+    const float wowSamples = wowDepth * kMaxWowMs * 0.001f * sampleRate;
+    const float flutterSamples = flutterDepth * kMaxFlutterMs * 0.001f * sampleRate;
+    const bool isGliding = smoothedDelay.isSmoothing();
+    const float staticDelay = (float) delayLineL.getDelayInSamples();
+
+    // 1) Modulated delay of every sample (the LFOs are cheap next to the reads)
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float baseDelay = isGliding ? (float) smoothedDelay.getNextValue() : staticDelay;
+        const auto wow = wowLFO.renderAudioOutput();
+        const auto flutter = flutterLFO.renderAudioOutput();
+
+        // Offset by the full depth so modulation only ever lengthens the delay
+        delaysL[i] = baseDelay + wowSamples * (1.0f + (float) wow.normalOutput)
+                               + flutterSamples * (1.0f + (float) flutter.normalOutput);
+        delaysR[i] = baseDelay + wowSamples * (1.0f + (float) wow.quadPhaseOutput_pos)
+                               + flutterSamples * (1.0f + (float) flutter.quadPhaseOutput_pos);
+    }
+
+    if (isGliding)
+        finishGlide();
+
+    // 2) Sub-blocks short enough that nothing they read is written within them
+    const float maxDelay = (float) (delayLineL.getNumSamples() - 3);
+
+    for (int start = 0; start < numSamples;)
+    {
+        int length = 0;
+
+        while (start + length < numSamples)
+        {
+            const int n = start + length;
+            delaysL[n] = juce::jlimit(2.0f, maxDelay, delaysL[n]);
+            delaysR[n] = juce::jlimit(2.0f, maxDelay, delaysR[n]);
+
+            if (length > 0 && juce::jmin(delaysL[n], delaysR[n]) < (float) (length + 2))
+                break;
+
+            ++length;
+        }
+
+        processFractionalBlock(leftChannel + start,
+                               rightChannel != nullptr ? rightChannel + start : nullptr,
+                               delaysL + start, delaysR + start, length);
+        start += length;
+    }
+}
+
+void BasicDelay::processFractionalBlock(float* leftChannel, float* rightChannel,
+                                        const float* delaysL, const float* delaysR, int numSamples)
+{
+    delayLineL.readFractionalBlock(0, delaysL, scratch.getWritePointer(delayedLeft),
+                                   numSamples, interpolation, allpassStateL);
+
+    if (rightChannel != nullptr)
+        delayLineR.readFractionalBlock(0, delaysR, scratch.getWritePointer(delayedRight),
+                                       numSamples, interpolation, allpassStateR);
+
+    mixDelayedBlock(leftChannel, rightChannel, numSamples);
+}
+
+void BasicDelay::mixDelayedBlock(float* leftChannel, float* rightChannel, int numSamples)
+{
+    using FVO = juce::FloatVectorOperations;
+
+    const float wet = mixAmount;
+    const float dry = 1.0f - mixAmount;
+    const float fb = feedbackAmount;
+
+    const float panGainL = 1.0f - juce::jmax(0.0f, panValue);
+    const float panGainR = 1.0f + juce::jmin(0.0f, panValue);
+    const float phaseSign = (delayMode == DelayMode::Inverted) ? -1.0f : 1.0f;
+    const bool isPingPong = (delayMode == DelayMode::PingPong) && (rightChannel != nullptr);
+
+    float* delayed[2]  = { scratch.getWritePointer(delayedLeft), scratch.getWritePointer(delayedRight) };
+    float* feedback[2] = { scratch.getWritePointer(feedbackLeft), scratch.getWritePointer(feedbackRight) };
+    float* writeBack   = scratch.getWritePointer(writeBackChannel);
+
+    DelayLineWithSampleAccess<float>* lines[2] = { &delayLineL, &delayLineR };
+    juce::dsp::FirstOrderTPTFilter<float>* lowpass[2]  = { &lowpassL, &lowpassR };
+    juce::dsp::FirstOrderTPTFilter<float>* highpass[2] = { &highpassL, &highpassR };
+    float* io[2] = { leftChannel, rightChannel };
+    float* feedbackState[2] = { &feedbackL, &feedbackR };
+
+    const int numChannels = rightChannel != nullptr ? 2 : 1;
+
+    // 1) Feedback filters over the delayed block. feedback[ch][i] is what
+    //    sample i feeds back: the filtered delayed sample before it, so
+    //    index 0 carries last block's value
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* fbOut = feedback[ch];
+        fbOut[0] = *feedbackState[ch];
+
+        for (int i = 0; i < numSamples; ++i)
+            fbOut[i + 1] = highpass[ch]->processSample(0, lowpass[ch]->processSample(0, delayed[ch][i]));
+
+        *feedbackState[ch] = fbOut[numSamples];
+    }
+
+    // 2) Input plus (possibly crossed) feedback goes back into the lines
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const int source = isPingPong ? 1 - ch : ch;
+
+        FVO::copy(writeBack, io[ch], numSamples);
+        FVO::addWithMultiply(writeBack, feedback[source], fb, numSamples);
+        lines[ch]->writeBlock(0, writeBack, numSamples);
+    }
+
+    // 3) Output with phase inversion and panning applied to wet signal
+    //    (mono path: no panning)
+    const float wetGain[2] = { phaseSign * wet * (numChannels > 1 ? panGainL : 1.0f),
+                               phaseSign * wet * panGainR };
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        FVO::multiply(io[ch], dry, numSamples);
+        FVO::addWithMultiply(io[ch], delayed[ch], wetGain[ch], numSamples);
+    }
+}
+
+void BasicDelay::finishGlide()
+{
+    // Glide targets are whole samples, so the integer read picks up exactly
+    if (!smoothedDelay.isSmoothing())
+    {
+        delayLineL.setDelay((float) smoothedDelay.getTargetValue());
+        delayLineR.setDelay((float) smoothedDelay.getTargetValue());
+    }
 }
 
 void BasicDelay::reset()
@@ -114,17 +331,46 @@ void BasicDelay::reset()
     lowpassR.reset();
     highpassL.reset();
     highpassR.reset();
+    allpassStateL = 0.0f;
+    allpassStateR = 0.0f;
+
+    // Nothing to glide through after a reset
+    if (smoothedDelay.isSmoothing())
+    {
+        smoothedDelay.setCurrentAndTargetValue(smoothedDelay.getTargetValue());
+        delayLineL.setDelay((float) smoothedDelay.getTargetValue());
+        delayLineR.setDelay((float) smoothedDelay.getTargetValue());
+    }
 }
 
 void BasicDelay::setDelayTime(float delayMs)
+{
+    if (delayTimeMs == delayMs && !smoothedDelay.isSmoothing())
+        return;  // Skip if unchanged
+
+    setDelayTarget(delayMs);
+
+    // Jump straight to the target, ending any glide
+    smoothedDelay.setCurrentAndTargetValue(smoothedDelay.getTargetValue());
+    finishGlide();
+}
+
+void BasicDelay::glideToDelayTime(float delayMs)
 {
     if (delayTimeMs == delayMs)
         return;  // Skip if unchanged
 
+    setDelayTarget(delayMs);
+}
+
+void BasicDelay::setDelayTarget(float delayMs)
+{
     delayTimeMs = delayMs;
-    delayTimeSamples = (delayTimeMs / 1000.0f) * sampleRate;
-    delayLineL.setDelay(delayTimeSamples);
-    delayLineR.setDelay(delayTimeSamples);
+    delayTimeSamples = std::round((delayTimeMs / 1000.0f) * sampleRate);
+
+    // Same limits the delay lines apply
+    const float maxDelay = (float) (delayLineL.getNumSamples() - 1);
+    smoothedDelay.setTargetValue((double) juce::jlimit(1.0f, maxDelay, delayTimeSamples));
 }
 
 void BasicDelay::setFeedback(float feedback)
@@ -174,3 +420,18 @@ void BasicDelay::setHighpassFreq(float freq)
         highpassR.setCutoffFrequency(highpassFreqValue);
     }
 }
+
+void BasicDelay::setWow(float depth)
+{
+    wowDepth = juce::jlimit(0.0f, 1.0f, depth);
+}
+
+void BasicDelay::setFlutter(float depth)
+{
+    flutterDepth = juce::jlimit(0.0f, 1.0f, depth);
+}
+
+void BasicDelay::setInterpolation(DelayInterpolation type)
+{
+    interpolation = type;
+}
@@ -1,4 +1,4 @@
-// BasicDelay.h - Stereo delay with BPM sync, ping pong, panning, and filters
+// BasicDelay.h - Stereo delay with BPM sync, ping pong, tape modulation, panning, and filters
 
 #pragma once
 
@@ -10,11 +10,12 @@
 #endif
 
 #include "../CustomDelays.h"
+#include "../Reverb/LFO.h"
 
 class BasicDelay
 {
 public:
-    enum class DelayMode { Normal, PingPong, Inverted };
+    enum class DelayMode { Normal, PingPong, Inverted, Tape };
 
     BasicDelay();
     ~BasicDelay();
@@ -23,7 +24,12 @@ public:
     void processBlock(juce::AudioBuffer<float>& buffer);
     void reset();
 
+    // Moves the read head at once
     void setDelayTime(float delayMs);
+
+    // Moves it over kDelayGlideSeconds instead (tempo-synced time changes)
+    void glideToDelayTime(float delayMs);
+
     void setFeedback(float feedback);
     void setMix(float mix);
     void setMode(DelayMode mode);
@@ -31,12 +37,56 @@ public:
     void setLowpassFreq(float freq);
     void setHighpassFreq(float freq);
 
+    // Tape mode: wow (slow) and flutter (fast) depth 0..1, read kernel
+    void setWow(float depth);
+    void setFlutter(float depth);
+    void setInterpolation(DelayInterpolation type);
+
+    // Memory held by the delay lines, after prepare()
+    DelayArena::Report getMemoryReport() const { return arena.getReport(); }
+
+    // Sample format of both lines, from the next prepare()
+    void setDelayStorage(DelayStorage newStorage) { delayStorage = newStorage; }
+
 private:
+    // Per-sample path, needed when the delay is shorter than the block or
+    // while the delay time glides
+    void processSamples(float* left, float* right, int numSamples);
+
+    // Whole-block path: every delayed sample of the block is already in the
+    // delay line, so reads, feedback filtering, mixing and writes are done a
+    // block at a time
+    void processBlockCopy(float* left, float* right, int numSamples);
+
+    // Tape mode: per-sample modulated delays, read a sub-block at a time with
+    // readFractionalBlock and then mixed like the whole-block path
+    void processTape(float* left, float* right, int numSamples);
+    void processFractionalBlock(float* left, float* right, const float* delaysL, const float* delaysR, int numSamples);
+
+    // Delayed samples of the block path, read by processBlockCopy and
+    // processFractionalBlock, then filtered, fed back and mixed
+    void mixDelayedBlock(float* left, float* right, int numSamples);
+
+    // Hands the lines the glide's end point once it is reached
+    void finishGlide();
+
+    // New delay time as the smoothed delay's target, in whole samples
+    void setDelayTarget(float delayMs);
+
+    // Both lines live in one block
+    DelayArena arena;
+    DelayStorage delayStorage = DelayStorage::Float32;
     DelayLineWithSampleAccess<float> delayLineL { 88200 };  // ~2 sec at 44.1k
     DelayLineWithSampleAccess<float> delayLineR { 88200 };
 
     float delayTimeMs = 250.0f;
     float delayTimeSamples = 0.0f;
+
+    // glideToDelayTime() ramps the read head instead of jumping it (double,
+    // so the ramp lands on its whole-sample target without a step)
+    static constexpr double kDelayGlideSeconds = 0.25;
+    juce::SmoothedValue<double> smoothedDelay;
+
     float feedbackAmount = 0.3f;
     float mixAmount = 0.5f;
 
@@ -45,6 +95,16 @@ private:
     float lowpassFreqValue = 20000.0f;
     float highpassFreqValue = 20.0f;
 
+    // Tape modulation; the right channel's LFOs run in quadrature for width
+    static constexpr float kMaxWowMs = 4.0f;
+    static constexpr float kMaxFlutterMs = 0.4f;
+    float wowDepth = 0.0f;
+    float flutterDepth = 0.0f;
+    DelayInterpolation interpolation = DelayInterpolation::Cubic;
+    LFO wowLFO, flutterLFO;
+    float allpassStateL = 0.0f;
+    float allpassStateR = 0.0f;
+
     float sampleRate = 44100.0f;
 
     // Feedback state
@@ -55,5 +115,13 @@ private:
     juce::dsp::FirstOrderTPTFilter<float> lowpassL, lowpassR;
     juce::dsp::FirstOrderTPTFilter<float> highpassL, highpassR;
 
+    // Scratch for the block path: delayed, feedback (one sample longer, the
+    // first being last block's), the signal written back, and tape mode's
+    // per-sample delays
+    enum { delayedLeft, delayedRight, feedbackLeft, feedbackRight, writeBackChannel,
+           tapeDelayLeft, tapeDelayRight, numScratchChannels };
+    juce::AudioBuffer<float> scratch;
+    int maxBlockSize = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BasicDelay)
 };
@@ -0,0 +1,170 @@
+#include "MultiTapDelay.h"
+
+MultiTapDelay::MultiTapDelay() {}
+
+MultiTapDelay::~MultiTapDelay() {}
+
+void MultiTapDelay::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = static_cast<float>(spec.sampleRate);
+
+    // Sized for the longest tap at this sample rate
+    maxDelaySamples = (int) std::ceil(kMaxDelayMs * 0.001f * sampleRate);
+    delayLine = DelayLineWithSampleAccess<float>(maxDelaySamples + 1);
+    delayLine.setStorage(delayStorage);
+
+    // Always two channels; mono input is fed to both and summed on the way out
+    juce::dsp::ProcessSpec stereoSpec = spec;
+    stereoSpec.numChannels = 2;
+    arena.beginLayout();
+    delayLine.prepare(stereoSpec, arena, "delay line");
+    arena.allocate();
+    delayLine.prepare(stereoSpec, arena, "delay line");
+
+    for (int t = 0; t < kMaxTaps; ++t)
+        updateTap(t);
+
+    reset();
+}
+
+void MultiTapDelay::processBlock(juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = buffer.getNumChannels();
+
+    float* leftChannel = buffer.getWritePointer(0);
+    float* rightChannel = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+
+    // Cache values to avoid repeated member access in tight loop
+    const float wet = mixAmount;
+    const float dry = 1.0f - mixAmount;
+    const float fb = feedbackAmount;
+    const int activeTaps = numTaps;
+    const int numGroups = (activeTaps + kGroupSize - 1) / kGroupSize;
+
+    // Feedback comes from the last tap, after its filter
+    const int feedbackTap = activeTaps - 1;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float inputL = leftChannel[i];
+        const float inputR = rightChannel != nullptr ? rightChannel[i] : inputL;
+
+        // Gather: one read per tap from the shared buffer
+        for (int t = 0; t < activeTaps; ++t)
+        {
+            tapInputL[t] = delayLine.getSampleAtDelay(0, tapDelay[t]);
+            tapInputR[t] = delayLine.getSampleAtDelay(1, tapDelay[t]);
+        }
+
+        // Filter, pan and sum a register of taps at a time
+        auto wetL = Register::expand(0.0f);
+        auto wetR = Register::expand(0.0f);
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            const int base = g * kGroupSize;
+            const auto coeff = Register::fromRawArray(tapCoeff + base);
+
+            auto stateL = Register::fromRawArray(tapStateL + base);
+            auto stateR = Register::fromRawArray(tapStateR + base);
+
+            stateL += coeff * (Register::fromRawArray(tapInputL + base) - stateL);
+            stateR += coeff * (Register::fromRawArray(tapInputR + base) - stateR);
+
+            stateL.copyToRawArray(tapStateL + base);
+            stateR.copyToRawArray(tapStateR + base);
+
+            wetL += stateL * Register::fromRawArray(tapGainL + base);
+            wetR += stateR * Register::fromRawArray(tapGainR + base);
+        }
+
+        delayLine.pushSample(0, inputL + tapStateL[feedbackTap] * fb);
+        delayLine.pushSample(1, inputR + tapStateR[feedbackTap] * fb);
+
+        if (rightChannel != nullptr)
+        {
+            leftChannel[i]  = inputL * dry + wetL.sum() * wet;
+            rightChannel[i] = inputR * dry + wetR.sum() * wet;
+        }
+        else
+        {
+            leftChannel[i] = inputL * dry + 0.5f * (wetL.sum() + wetR.sum()) * wet;
+        }
+    }
+}
+
+void MultiTapDelay::reset()
+{
+    delayLine.reset();
+
+    std::fill(std::begin(tapStateL), std::end(tapStateL), 0.0f);
+    std::fill(std::begin(tapStateR), std::end(tapStateR), 0.0f);
+    std::fill(std::begin(tapInputL), std::end(tapInputL), 0.0f);
+    std::fill(std::begin(tapInputR), std::end(tapInputR), 0.0f);
+}
+
+void MultiTapDelay::setNumTaps(int newNumTaps)
+{
+    newNumTaps = juce::jlimit(1, kMaxTaps, newNumTaps);
+
+    if (numTaps == newNumTaps)
+        return;
+
+    numTaps = newNumTaps;
+
+    for (int t = 0; t < kMaxTaps; ++t)
+        updateTap(t);
+}
+
+void MultiTapDelay::setTap(int index, float delayMs, float gain, float pan, float lowpassFreq)
+{
+    if (!juce::isPositiveAndBelow(index, kMaxTaps))
+        return;
+
+    auto& tap = taps[index];
+
+    if (tap.delayMs == delayMs && tap.gain == gain && tap.pan == pan && tap.lowpassFreq == lowpassFreq)
+        return;  // Skip if unchanged
+
+    tap.delayMs = delayMs;
+    tap.gain = gain;
+    tap.pan = juce::jlimit(-1.0f, 1.0f, pan);
+    tap.lowpassFreq = lowpassFreq;
+
+    updateTap(index);
+}
+
+void MultiTapDelay::updateTap(int index)
+{
+    const auto& tap = taps[index];
+
+    tapDelay[index] = juce::jlimit(1, maxDelaySamples,
+                                   juce::roundToInt(tap.delayMs * 0.001f * sampleRate));
+
+    // Same pan law as BasicDelay; taps past the active count are silent
+    const float gain = index < numTaps ? tap.gain : 0.0f;
+    tapGainL[index] = gain * (1.0f - juce::jmax(0.0f, tap.pan));
+    tapGainR[index] = gain * (1.0f + juce::jmin(0.0f, tap.pan));
+
+    // One-pole lowpass: y += a * (x - y), fully open at the top of the range
+    if (tap.lowpassFreq >= 20000.0f)
+    {
+        tapCoeff[index] = 1.0f;
+    }
+    else
+    {
+        const float freq = juce::jlimit(20.0f, sampleRate * 0.49f, tap.lowpassFreq);
+        tapCoeff[index] = 1.0f - std::exp(-juce::MathConstants<float>::twoPi * freq / sampleRate);
+    }
+}
+
+void MultiTapDelay::setFeedback(float feedback)
+{
+    feedbackAmount = juce::jlimit(0.0f, 0.95f, feedback);
+}
+
+void MultiTapDelay::setMix(float mix)
+{
+    mixAmount = juce::jlimit(0.0f, 1.0f, mix);
+}
@@ -0,0 +1,82 @@
+// MultiTapDelay.h - Up to 16 taps reading one shared delay buffer
+//
+// All taps read from a single ring buffer per channel, so adding a tap costs
+// one read and a one-pole filter instead of a whole delay line. Tap settings
+// and filter states are stored per field (all times, all gains, ...) so the
+// taps are filtered, panned and summed a SIMD register of taps at a time.
+
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_dsp/juce_dsp.h>
+#endif
+
+#include "../CustomDelays.h"
+
+class MultiTapDelay
+{
+public:
+    static constexpr int kMaxTaps = 16;
+    static constexpr float kMaxDelayMs = 2000.0f;
+
+    MultiTapDelay();
+    ~MultiTapDelay();
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void processBlock(juce::AudioBuffer<float>& buffer);
+    void reset();
+
+    void setNumTaps(int numTaps);
+    void setTap(int index, float delayMs, float gain, float pan, float lowpassFreq);
+    void setFeedback(float feedback);
+    void setMix(float mix);
+
+    // Memory held by the delay line, after prepare()
+    DelayArena::Report getMemoryReport() const { return arena.getReport(); }
+
+    // Sample format of the line, from the next prepare()
+    void setDelayStorage(DelayStorage newStorage) { delayStorage = newStorage; }
+
+private:
+    using Register = juce::dsp::SIMDRegister<float>;
+    static constexpr int kGroupSize = (int) Register::SIMDNumElements;
+    static constexpr int kPaddedTaps = ((kMaxTaps + kGroupSize - 1) / kGroupSize) * kGroupSize;
+
+    struct TapSettings
+    {
+        float delayMs = 0.0f;
+        float gain = 0.0f;
+        float pan = 0.0f;
+        float lowpassFreq = 20000.0f;
+    };
+
+    void updateTap(int index);
+
+    // One line, one channel per audio channel, shared by all taps
+    DelayArena arena;
+    DelayLineWithSampleAccess<float> delayLine;
+    DelayStorage delayStorage = DelayStorage::Float32;
+
+    TapSettings taps[kMaxTaps];
+    int numTaps = 4;
+
+    // Per-tap values, padded to whole registers (unused taps have zero gain)
+    int tapDelay[kPaddedTaps] = {};
+    alignas(Register::SIMDRegisterSize) float tapGainL[kPaddedTaps] = {};
+    alignas(Register::SIMDRegisterSize) float tapGainR[kPaddedTaps] = {};
+    alignas(Register::SIMDRegisterSize) float tapCoeff[kPaddedTaps] = {};
+    alignas(Register::SIMDRegisterSize) float tapStateL[kPaddedTaps] = {};
+    alignas(Register::SIMDRegisterSize) float tapStateR[kPaddedTaps] = {};
+    alignas(Register::SIMDRegisterSize) float tapInputL[kPaddedTaps] = {};
+    alignas(Register::SIMDRegisterSize) float tapInputR[kPaddedTaps] = {};
+
+    float feedbackAmount = 0.3f;
+    float mixAmount = 0.5f;
+    float sampleRate = 44100.0f;
+    int maxDelaySamples = 1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultiTapDelay)
+};
@@ -0,0 +1,76 @@
+#include "DelayArena.h"
+
+#if JUCE_LINUX
+  #include <sys/mman.h>
+#endif
+
+void DelayArena::beginLayout()
+{
+    carving = false;
+    layoutBytes = 0;
+    entries.clear();
+}
+
+void DelayArena::allocate(bool allowHugePages)
+{
+    jassert(!carving);
+
+    size = layoutBytes;
+    used = 0;
+    carving = true;
+    hugePages = false;
+
+    storage.reset();
+    base = nullptr;
+
+    if (size == 0)
+        return;
+
+    const bool large = allowHugePages && size >= hugePageSize;
+    const size_t blockAlignment = large ? hugePageSize : alignment;
+
+    // Not value-initialised: only the aligned part is touched, so the slack
+    // never gets physical pages
+    storage.reset(new char[size + blockAlignment]);
+
+    const auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+    base = storage.get() + ((blockAlignment - address % blockAlignment) % blockAlignment);
+
+   #if JUCE_LINUX && defined(MADV_HUGEPAGE)
+    // Before the first touch, so the kernel can back it with huge pages
+    if (large)
+        hugePages = madvise(base, size - size % hugePageSize, MADV_HUGEPAGE) == 0;
+   #endif
+
+    std::memset(base, 0, size);
+}
+
+DelayArena::Report DelayArena::getReport() const
+{
+    Report report;
+    report.entries = entries;
+    report.totalBytes = size;
+    report.numBlocks = size > 0 ? 1 : 0;
+    report.hugePages = hugePages;
+    return report;
+}
+
+void DelayArena::Report::add(const Report& other)
+{
+    entries.insert(entries.end(), other.entries.begin(), other.entries.end());
+    totalBytes += other.totalBytes;
+    numBlocks += other.numBlocks;
+    hugePages = hugePages || other.hugePages;
+}
+
+juce::String DelayArena::Report::toString() const
+{
+    juce::String text;
+    text << juce::File::descriptionOfSizeInBytes((juce::int64) totalBytes) << " in " << numBlocks
+         << (numBlocks == 1 ? " block" : " blocks") << (hugePages ? " (huge pages)" : "");
+
+    for (const auto& entry : entries)
+        text << "\n  " << entry.name << ": " << juce::File::descriptionOfSizeInBytes((juce::int64) entry.bytes);
+
+    return text;
+}
@@ -0,0 +1,104 @@
+/*
+DelayArena - one aligned block holding all the delay lines and filter states
+of an algorithm.
+
+An algorithm lays its lines out twice in prepare(): once after beginLayout(),
+when take() only adds up the sizes, and once after allocate(), when take()
+hands out consecutive cache-line-aligned pieces of a single zeroed block.
+Large blocks are offered to the OS as huge pages where that is supported.
+*/
+
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"  // for Projucer
+#else // for Cmake
+  #include <juce_core/juce_core.h>
+#endif
+
+class DelayArena
+{
+public:
+    // Every piece starts on its own cache line
+    static constexpr size_t alignment = 64;
+
+    // Blocks at least this big are aligned to it and advised as huge pages
+    static constexpr size_t hugePageSize = 2 * 1024 * 1024;
+
+    struct Entry
+    {
+        const char* name = "";
+        size_t bytes = 0;
+    };
+
+    // What an algorithm holds, piece by piece (message thread, after prepare)
+    struct Report
+    {
+        std::vector<Entry> entries;
+        size_t totalBytes = 0;
+        int numBlocks = 0;
+        bool hugePages = false;
+
+        // Folds in another algorithm's pieces and totals
+        void add(const Report& other);
+
+        juce::String toString() const;
+    };
+
+    DelayArena() = default;
+
+    // Starts the counting pass; the previous block stays valid until allocate()
+    void beginLayout();
+
+    // Replaces the block with one of the size counted, zeroed, and starts the
+    // carving pass. Not for the audio thread.
+    void allocate(bool allowHugePages = true);
+
+    // Room for count values: nullptr while counting, then the next piece.
+    // Both passes must take the same sizes in the same order.
+    template <typename T>
+    T* take(size_t count, const char* name)
+    {
+        static_assert(alignof(T) <= alignment, "DelayArena pieces are only cache-line aligned");
+
+        const size_t bytes = roundUp(count * sizeof(T));
+
+        if (!carving)
+        {
+            layoutBytes += bytes;
+
+            // Consecutive pieces of one line (samples, positions) report as one
+            if (!entries.empty() && std::strcmp(entries.back().name, name) == 0)
+                entries.back().bytes += count * sizeof(T);
+            else
+                entries.push_back({ name, count * sizeof(T) });
+
+            return nullptr;
+        }
+
+        jassert(used + bytes <= size);
+        auto* piece = reinterpret_cast<T*>(base + used);
+        used += bytes;
+        return piece;
+    }
+
+    bool isCarving() const { return carving; }
+    size_t getSize() const { return size; }
+
+    Report getReport() const;
+
+private:
+    static size_t roundUp(size_t bytes) { return (bytes + alignment - 1) & ~(alignment - 1); }
+
+    std::unique_ptr<char[]> storage;
+    char* base = nullptr;
+    size_t size = 0;
+    size_t used = 0;
+    size_t layoutBytes = 0;
+    bool carving = false;
+    bool hugePages = false;
+
+    std::vector<Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE(DelayArena)
+};
@@ -12,7 +12,8 @@ DatorroHall::~DatorroHall() {}
 void DatorroHall::prepareAllpass(Allpass<float>& ap,
                                  const juce::dsp::ProcessSpec& spec,
                                  float delayMs,
-                                 float gain)
+                                 float gain,
+                                 const char* name)
 {
     // delayMs is desired nominal delay; allocate a bit of headroom
     const int desiredSamples = (int) std::round((delayMs * 0.001f) * (float) spec.sampleRate);
@@ -21,10 +22,79 @@ void DatorroHall::prepareAllpass(Allpass<float>& ap,
     ap.setMaximumDelayInSamples(maxSamples);
     ap.setDelay((float) desiredSamples);
     ap.setGain(gain);
-    ap.prepare(spec);
+    ap.prepare(spec, arena, name);
     ap.reset();
 }
 
+void DatorroHall::prepareDelayLines(const juce::dsp::ProcessSpec& monoSpec)
+{
+    for (auto* line : { &preDelayL, &preDelayR, &erL, &erR })
+        line->setStorage(delayStorage);
+
+    // Pre Delay
+    preDelayL.prepare(monoSpec, arena, "pre-delay");
+    preDelayR.prepare(monoSpec, arena, "pre-delay");
+    preDelayL.reset();
+    preDelayR.reset();
+
+    erL.prepare(monoSpec, arena, "early reflections");
+    erR.prepare(monoSpec, arena, "early reflections");
+    erL.reset();
+    erR.reset();
+
+    //=====================================
+    // Prepare delay lines (4 per channel)
+    //=====================================
+    auto prepDL = [&](DelayLineWithSampleAccess<float>& d)
+    {
+        d.setStorage(delayStorage);
+        d.prepare(monoSpec, arena, "tank lines");
+        d.reset();
+    };
+
+    prepDL(tankDelayL1);
+    prepDL(tankDelayL2);
+    prepDL(tankDelayL3);
+    prepDL(tankDelayL4);
+
+    prepDL(tankDelayR1);
+    prepDL(tankDelayR2);
+    prepDL(tankDelayR3);
+    prepDL(tankDelayR4);
+
+    //=====================================
+    // Prepare early diffusion allpasses
+    //=====================================
+    auto prepAP = [&](Allpass<float>& ap, float delayMs, float gain, const char* name)
+    {
+        prepareAllpass(ap, monoSpec, delayMs, gain, name);
+    };
+
+    // Early diffusion (4 APs), strong diffusion
+    prepAP(earlyL1,  8.0f, 0.70f, "early diffusion");
+    prepAP(earlyL2, 12.0f, 0.72f, "early diffusion");
+    prepAP(earlyL3, 15.0f, 0.68f, "early diffusion");
+    prepAP(earlyL4, 22.0f, 0.70f, "early diffusion");
+
+    prepAP(earlyR1,  8.8f, 0.70f, "early diffusion");
+    prepAP(earlyR2, 10.5f, 0.72f, "early diffusion");
+    prepAP(earlyR3, 16.0f, 0.68f, "early diffusion");
+    prepAP(earlyR4, 21.0f, 0.70f, "early diffusion");
+
+    //=====================================
+    // Prepare tank diffusion APs (per-line)
+    //=====================================
+    prepAP(tankLAP1, 35.0f, 0.72f, "tank diffusion");
+    prepAP(tankLAP2, 55.0f, 0.70f, "tank diffusion");
+    prepAP(tankLAP3, 78.0f, 0.72f, "tank diffusion");
+    prepAP(tankLAP4, 92.0f, 0.70f, "tank diffusion");
+
+    prepAP(tankRAP1, 35.0f, 0.72f, "tank diffusion");
+    prepAP(tankRAP2, 55.0f, 0.70f, "tank diffusion");
+    prepAP(tankRAP3, 78.0f, 0.72f, "tank diffusion");
+    prepAP(tankRAP4, 92.0f, 0.70f, "tank diffusion");
+}
+
 //==============================================================================
 
 void DatorroHall::prepare(const juce::dsp::ProcessSpec& spec)
@@ -50,45 +120,26 @@ void DatorroHall::prepare(const juce::dsp::ProcessSpec& spec)
     loopDamping.setCutoffFrequency(parameters.damping);
     loopDamping.reset();
 
-    // Pre Delay
-    preDelayL.prepare(spec);
-    preDelayR.prepare(spec);
-    preDelayL.reset();
-    preDelayR.reset();
-
-    erL.prepare(spec);
-    erR.prepare(spec);
-    erL.reset();
-    erR.reset();
-
-
-
     //=====================================
-    // Prepare delay lines (4 per channel)
+    // Delay lines and allpasses: each runs a single channel, and all of
+    // them share one block (a counting pass, then the real one)
     //=====================================
-    auto prepDL = [&](DelayLineWithSampleAccess<float>& d)
-    {
-        d.prepare(spec);
-        d.reset();
-    };
-
-    prepDL(tankDelayL1);
-    prepDL(tankDelayL2);
-    prepDL(tankDelayL3);
-    prepDL(tankDelayL4);
+    juce::dsp::ProcessSpec monoSpec = spec;
+    monoSpec.numChannels = 1;
 
-    prepDL(tankDelayR1);
-    prepDL(tankDelayR2);
-    prepDL(tankDelayR3);
-    prepDL(tankDelayR4);
+    arena.beginLayout();
+    prepareDelayLines(monoSpec);
+    arena.allocate();
+    prepareDelayLines(monoSpec);
 
+    // Per-line filters only run channel 0 too
     for (int i = 0; i < 4; ++i)
     {
-        dampingFiltersL[i].prepare(spec);
+        dampingFiltersL[i].prepare(monoSpec);
         dampingFiltersL[i].setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
         dampingFiltersL[i].reset();
 
-        dampingFiltersR[i].prepare(spec);
+        dampingFiltersR[i].prepare(monoSpec);
         dampingFiltersR[i].setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
         dampingFiltersR[i].reset();
     }
@@ -133,14 +184,6 @@ void DatorroHall::prepare(const juce::dsp::ProcessSpec& spec)
         currentDelayR_samps[i] = baseDelaySamplesR[i];
     }
 
-    //=====================================
-    // Prepare early diffusion allpasses
-    //=====================================
-    auto prepAP = [&](Allpass<float>& ap, float delayMs, float gain)
-    {
-        prepareAllpass(ap, spec, delayMs, gain);
-    };
-
     for (int i = 0; i < ER_count; ++i)
     {
         ER_tapSamplesLeft[i]  = ER_tapTimesMsLeft[i]  * 0.001f * sampleRate;
@@ -148,30 +191,6 @@ void DatorroHall::prepare(const juce::dsp::ProcessSpec& spec)
     }
 
 
-    // Early diffusion (4 APs), strong diffusion
-    prepAP(earlyL1,  8.0f, 0.70f);
-    prepAP(earlyL2, 12.0f, 0.72f);
-    prepAP(earlyL3, 15.0f, 0.68f);
-    prepAP(earlyL4, 22.0f, 0.70f);
-
-    prepAP(earlyR1,  8.8f, 0.70f);
-    prepAP(earlyR2, 10.5f, 0.72f);
-    prepAP(earlyR3, 16.0f, 0.68f);
-    prepAP(earlyR4, 21.0f, 0.70f);
-
-    //=====================================
-    // Prepare tank diffusion APs (per-line)
-    //=====================================
-    prepAP(tankLAP1, 35.0f, 0.72f);
-    prepAP(tankLAP2, 55.0f, 0.70f);
-    prepAP(tankLAP3, 78.0f, 0.72f);
-    prepAP(tankLAP4, 92.0f, 0.70f);
-
-    prepAP(tankRAP1, 35.0f, 0.72f);
-    prepAP(tankRAP2, 55.0f, 0.70f);
-    prepAP(tankRAP3, 78.0f, 0.72f);
-    prepAP(tankRAP4, 92.0f, 0.70f);
-
     //=====================================
     // LFO Setup
     //=====================================
@@ -39,12 +39,22 @@ public:
     ReverbProcessorParameters& getParameters() override;
     void setParameters(const ReverbProcessorParameters& params) override;
 
+    DelayArena::Report getMemoryReport() const override { return arena.getReport(); }
+
+    void setDelayStorage(DelayStorage newStorage) override { delayStorage = newStorage; }
+
 private:
     //======================================================================
     // Parameters (user-facing wrapped in ReverbProcessorParameters)
     //======================================================================
     ReverbProcessorParameters parameters;
 
+    // Holds every delay line and allpass below (all mono)
+    DelayArena arena;
+
+    // Pre-delay and early reflection and tank lines; the short allpasses stay float
+    DelayStorage delayStorage = DelayStorage::Float32;
+
     //======================================================================
     // Tank damping (high-cut in the feedback loop)
     //======================================================================
@@ -177,7 +187,11 @@ private:
     void prepareAllpass(Allpass<float>& ap,
                         const juce::dsp::ProcessSpec& spec,
                         float delayMs,
-                        float gain);
+                        float gain,
+                        const char* name);
+
+    // Run once per arena pass
+    void prepareDelayLines(const juce::dsp::ProcessSpec& monoSpec);
 
     void updateInternalParamsFromUserParams();
 
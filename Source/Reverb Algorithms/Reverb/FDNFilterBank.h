@@ -0,0 +1,128 @@
+// FDNFilterBank.h - The per-line loop filters of an FDN, all lines at once
+//
+// Each line runs the same chain: a TPT one-pole lowpass (as
+// juce::dsp::FirstOrderTPTFilter), the psychoacoustic one-pole (as
+// PsychoOnePole) and a biquad (as juce::dsp::IIR::Filter, transposed direct
+// form II). The lines' states are stored per field and padded to whole SIMD
+// registers, like MultiTapDelay's taps, so one pass of register arithmetic
+// filters a register of lines instead of three scalar calls per line.
+// Coefficients are shared by all lines and kept as plain floats, so there
+// are no reference-counted coefficient objects on the audio thread.
+
+#pragma once
+
+#if __has_include("JuceHeader.h")
+  #include "JuceHeader.h"
+#else
+  #include <juce_audio_basics/juce_audio_basics.h>
+  #include <juce_dsp/juce_dsp.h>
+#endif
+
+#include "PsychoDamping.h"
+
+template <int NumLines>
+class FDNFilterBank
+{
+public:
+    using Register = juce::dsp::SIMDRegister<float>;
+    static constexpr int groupSize = (int) Register::SIMDNumElements;
+    static constexpr int paddedLines = ((NumLines + groupSize - 1) / groupSize) * groupSize;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        setLowpassCutoff(lowpassCutoff);
+        setPsychoDamping(psychoDamping);
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(std::begin(lowpassState), std::end(lowpassState), 0.0f);
+        std::fill(std::begin(psychoState), std::end(psychoState), 0.0f);
+        std::fill(std::begin(biquadState1), std::end(biquadState1), 0.0f);
+        std::fill(std::begin(biquadState2), std::end(biquadState2), 0.0f);
+    }
+
+    // Same mapping as FirstOrderTPTFilter::setCutoffFrequency
+    void setLowpassCutoff(float cutoffHz)
+    {
+        lowpassCutoff = cutoffHz;
+
+        const float g = (float) std::tan(juce::MathConstants<double>::pi * cutoffHz / sampleRate);
+        lowpassG = g / (1.0f + g);
+    }
+
+    // Same mapping as PsychoOnePole::setDamping
+    void setPsychoDamping(float userDamping)
+    {
+        psychoDamping = userDamping;
+
+        const float cutoffHz = PsychoDamping::mapPsychoDamping(userDamping);
+        psychoG = std::exp(-2.0f * juce::MathConstants<float>::pi * cutoffHz / (float) sampleRate);
+    }
+
+    // Any second-order IIR::Coefficients, e.g. makeHighShelf
+    void setBiquad(const juce::dsp::IIR::Coefficients<float>& coefficients)
+    {
+        const auto* c = coefficients.getRawCoefficients();
+        jassert(coefficients.getFilterOrder() == 2);
+
+        b0 = c[0];
+        b1 = c[1];
+        b2 = c[2];
+        a1 = c[3];
+        a2 = c[4];
+    }
+
+    // Filters lines[0 .. paddedLines) in place; the array must be aligned to
+    // Register::SIMDRegisterSize. Padding lanes are filtered too and ignored.
+    void process(float* lines)
+    {
+        const auto lpG = Register::expand(lowpassG);
+        const auto pG = Register::expand(psychoG);
+        const auto pIn = Register::expand(1.0f - psychoG);
+        const auto c0 = Register::expand(b0), c1 = Register::expand(b1), c2 = Register::expand(b2);
+        const auto d1 = Register::expand(a1), d2 = Register::expand(a2);
+
+        for (int base = 0; base < paddedLines; base += groupSize)
+        {
+            auto x = Register::fromRawArray(lines + base);
+
+            // TPT lowpass
+            auto s = Register::fromRawArray(lowpassState + base);
+            const auto v = lpG * (x - s);
+            x = v + s;
+            (x + v).copyToRawArray(lowpassState + base);
+
+            // Psychoacoustic one-pole
+            x = pG * Register::fromRawArray(psychoState + base) + pIn * x;
+            x.copyToRawArray(psychoState + base);
+
+            // Biquad, TDF-II
+            auto z1 = Register::fromRawArray(biquadState1 + base);
+            const auto z2 = Register::fromRawArray(biquadState2 + base);
+            const auto y = c0 * x + z1;
+            z1 = c1 * x - d1 * y + z2;
+            (c2 * x - d2 * y).copyToRawArray(biquadState2 + base);
+            z1.copyToRawArray(biquadState1 + base);
+
+            y.copyToRawArray(lines + base);
+        }
+    }
+
+private:
+    double sampleRate = 44100.0;
+
+    float lowpassCutoff = 1000.0f;
+    float psychoDamping = 8000.0f;
+
+    float lowpassG = 0.0f;
+    float psychoG = 0.0f;
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+
+    alignas(Register::SIMDRegisterSize) float lowpassState[paddedLines] = {};
+    alignas(Register::SIMDRegisterSize) float psychoState[paddedLines] = {};
+    alignas(Register::SIMDRegisterSize) float biquadState1[paddedLines] = {};
+    alignas(Register::SIMDRegisterSize) float biquadState2[paddedLines] = {};
+};
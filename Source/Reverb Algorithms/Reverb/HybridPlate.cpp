@@ -11,7 +11,8 @@ HybridPlate::~HybridPlate() = default;
 void HybridPlate::prepareAllpass(Allpass<float>& ap,
                                  const juce::dsp::ProcessSpec& spec,
                                  float delayMs,
-                                 float gain)
+                                 float gain,
+                                 const char* name)
 {
     const int desiredSamples =
         (int) std::round((delayMs * 0.001f) * (float) spec.sampleRate);
@@ -20,21 +21,19 @@ void HybridPlate::prepareAllpass(Allpass<float>& ap,
     ap.setMaximumDelayInSamples(maxSamples);
     ap.setDelay((float) desiredSamples);
     ap.setGain(gain);
-    ap.prepare(spec);
+    ap.prepare(spec, arena, name);
     ap.reset();
 }
 
-//==============================================================================
-
-void HybridPlate::prepare(const juce::dsp::ProcessSpec& spec)
+void HybridPlate::prepareDelayLines(const juce::dsp::ProcessSpec& monoSpec)
 {
-    sampleRate = (int) spec.sampleRate;
-
     // -------------------------
     // Pre-delay setup
     // -------------------------
-    preDelayL.prepare(spec);
-    preDelayR.prepare(spec);
+    preDelayL.setStorage(delayStorage);
+    preDelayR.setStorage(delayStorage);
+    preDelayL.prepare(monoSpec, arena, "pre-delay");
+    preDelayR.prepare(monoSpec, arena, "pre-delay");
     preDelayL.reset();
     preDelayR.reset();
 
@@ -49,13 +48,42 @@ void HybridPlate::prepare(const juce::dsp::ProcessSpec& spec)
         const float dL = earlyDelaysMs[i];
         const float dR = earlyDelaysMs[i] * 1.11f; // slight L/R decorrelation
 
-        prepareAllpass(earlyL[i], spec, dL, earlyGain);
-        prepareAllpass(earlyR[i], spec, dR, earlyGain);
+        prepareAllpass(earlyL[i], monoSpec, dL, earlyGain, "early diffusion");
+        prepareAllpass(earlyR[i], monoSpec, dR, earlyGain, "early diffusion");
     }
 
     // -------------------------
     // FDN delay lines
     // -------------------------
+    for (int i = 0; i < fdnCount; ++i)
+    {
+        fdnLines[i].setStorage(delayStorage);
+        fdnLines[i].prepare(monoSpec, arena, "FDN lines");
+        fdnLines[i].reset();
+    }
+}
+
+//==============================================================================
+
+void HybridPlate::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = (int) spec.sampleRate;
+
+    // -------------------------
+    // Delay lines and allpasses: every one runs a single channel, and all
+    // of them share one block (a counting pass, then the real one)
+    // -------------------------
+    juce::dsp::ProcessSpec monoSpec = spec;
+    monoSpec.numChannels = 1;
+
+    arena.beginLayout();
+    prepareDelayLines(monoSpec);
+    arena.allocate();
+    prepareDelayLines(monoSpec);
+
+    // -------------------------
+    // FDN delay times
+    // -------------------------
     const float fdnDelayMs[fdnCount] = {
         32.0f,
         44.0f,
@@ -65,9 +93,6 @@ void HybridPlate::prepare(const juce::dsp::ProcessSpec& spec)
 
     for (int i = 0; i < fdnCount; ++i)
     {
-        fdnLines[i].prepare(spec);
-        fdnLines[i].reset();
-
         const float baseSamps = fdnDelayMs[i] * 0.001f * (float) sampleRate;
         maxDelaySamples[i]    = (float) (fdnLines[i].getNumSamples() - 2);
 
@@ -76,36 +101,19 @@ void HybridPlate::prepare(const juce::dsp::ProcessSpec& spec)
     }
 
     // -------------------------
-    // Damping filters per FDN line
+    // Damping filters per FDN line: lowpass, psycho damping, and a
+    // high shelf for no ring
     // -------------------------
-    for (int i = 0; i < fdnCount; ++i)
-    {
-        dampingFilters[i].prepare(spec);
-        dampingFilters[i].reset();
-        dampingFilters[i].setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
-    }
-
-    for (int i = 0; i < fdnCount; ++i)
-        extraDampL[i].prepare(sampleRate, parameters.damping);
+    loopFilters.prepare(spec.sampleRate);
 
+    auto shelf = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
+        sampleRate,
+        3000.0f,   // frequency where ringing builds
+        0.707f,     // Q
+        0.5f        // gain factor < 1.0 removes ringing
+    );
 
-    // high shelf for no ring
-    for (int i = 0; i < fdnCount; ++i)
-    {
-        juce::dsp::IIR::Coefficients<float>::Ptr coeff =
-            juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-                sampleRate,
-                3000.0f,   // frequency where ringing builds
-                0.707f,     // Q
-                0.5f        // gain factor < 1.0 removes ringing
-            );
-
-        highShelfFilters[i].prepare(spec);
-
-        *highShelfFilters[i].coefficients = *coeff;
-        
-        highShelfFilters[i].reset();
-    }
+    loopFilters.setBiquad(*shelf);
 
 
     // -------------------------
@@ -158,10 +166,11 @@ void HybridPlate::reset()
     for (int i = 0; i < fdnCount; ++i)
     {
         fdnLines[i].reset();
-        dampingFilters[i].reset();
         currentDelaySamples[i] = baseDelaySamples[i];
     }
 
+    loopFilters.reset();
+
     std::fill(channelInput.begin(),  channelInput.end(),  0.0f);
     std::fill(channelOutput.begin(), channelOutput.end(), 0.0f);
 
@@ -181,10 +190,8 @@ void HybridPlate::updateInternalParamsFromUserParams()
     preDelaySamples = pdMs * 0.001f * (float) sampleRate;
 
     // Damping filter cutoff
-    for (int i = 0; i < fdnCount; ++i)
-        dampingFilters[i].setCutoffFrequency(parameters.damping);
-    for (int i = 0; i < fdnCount; ++i)
-        extraDampL[i].setDamping(parameters.damping);
+    loopFilters.setLowpassCutoff(parameters.damping);
+    loopFilters.setPsychoDamping(parameters.damping);
 
 
     // LFO parameters
@@ -239,6 +246,8 @@ void HybridPlate::processBlock(juce::AudioBuffer<float>& buffer,
 
     const float slew = 0.001f; // modulation slew
 
+    alignas(LoopFilters::Register::SIMDRegisterSize) float lineInput[LoopFilters::paddedLines] = {};
+
     for (int n = 0; n < numSamples; ++n)
     {
         const float dryL = left[n];
@@ -323,23 +332,17 @@ void HybridPlate::processBlock(juce::AudioBuffer<float>& buffer,
         //===========================
         // Push new input into FDN
         //===========================
+        // new input to each FDN line: early-diffused monoIn + feedback
         for (int i = 0; i < fdnCount; ++i)
-        {
-            // new input to this FDN line: early-diffused monoIn + feedback
-            float newSample = monoIn + fb[i];
+            lineInput[i] = monoIn + fb[i];
 
-            // first-order lowpass damping
-            float damped = dampingFilters[i].processSample(0, newSample);
+        // first-order lowpass damping -> psycho damping -> high-shelf to
+        // tame metallic ringing, all lines in one pass
+        loopFilters.process(lineInput);
 
-            float psycho = extraDampL[i].process(damped);
-
-            // high-shelf to tame metallic ringing
-            float softened = highShelfFilters[i].processSample(psycho);
-
-
-            // write into delay line
-            fdnLines[i].pushSample(0, softened);
-        }
+        // write into delay lines
+        for (int i = 0; i < fdnCount; ++i)
+            fdnLines[i].pushSample(0, lineInput[i]);
 
 
         //===========================
@@ -23,6 +23,7 @@
 #include "ProcessorBase.h"
 #include "../../Utilities.h"
 #include "PsychoDamping.h"
+#include "FDNFilterBank.h"
 
 class HybridPlate : public ReverbProcessorBase
 {
@@ -38,16 +39,21 @@ public:
     ReverbProcessorParameters& getParameters() override;
     void setParameters(const ReverbProcessorParameters& params) override;
 
+    DelayArena::Report getMemoryReport() const override { return arena.getReport(); }
+
+    void setDelayStorage(DelayStorage newStorage) override { delayStorage = newStorage; }
+
 private:
     //======================================================================
     // Parameters
     //======================================================================
     ReverbProcessorParameters parameters;
 
-    // New psycho damping filters for each tank line
-     PsychoOnePole extraDampL[4];
-     PsychoOnePole extraDampR[4];
+    // Holds every delay line and allpass below (all mono)
+    DelayArena arena;
 
+    // Pre-delay and FDN lines; the short allpasses stay float
+    DelayStorage delayStorage = DelayStorage::Float32;
 
     //======================================================================
     // Pre-delay (stereo, using your custom delay line)
@@ -66,7 +72,6 @@ private:
     // FDN core: 4 delay lines (mono FDN, stereo decode)
     //======================================================================
     static constexpr int fdnCount = 4;
-    juce::dsp::IIR::Filter<float> highShelfFilters[fdnCount];
 
     DelayLineWithSampleAccess<float> fdnLines[fdnCount] = {
         DelayLineWithSampleAccess<float>(44100),
@@ -79,7 +84,10 @@ private:
     float maxDelaySamples[fdnCount]     { 0.f, 0.f, 0.f, 0.f };
     float currentDelaySamples[fdnCount] { 0.f, 0.f, 0.f, 0.f };
 
-    juce::dsp::FirstOrderTPTFilter<float> dampingFilters[fdnCount];
+    // Damping lowpass, psycho damping and the anti-ring high shelf of every
+    // line, run for all four lines at once
+    using LoopFilters = FDNFilterBank<fdnCount>;
+    LoopFilters loopFilters;
 
     float estimatedLoopTimeSeconds = 0.2f;
 
@@ -117,7 +125,11 @@ private:
     void prepareAllpass(Allpass<float>& ap,
                         const juce::dsp::ProcessSpec& spec,
                         float delayMs,
-                        float gain);
+                        float gain,
+                        const char* name);
+
+    // Run once per arena pass
+    void prepareDelayLines(const juce::dsp::ProcessSpec& monoSpec);
 
     void updateInternalParamsFromUserParams();
 
@@ -1,7 +1,7 @@
 // Sine/tri/saw LFO with quadrature output
 
 #include "LFO.h"
-LFO::LFO() { srand(static_cast<uint32_t>(time(NULL))); }
+LFO::LFO() = default;
 
 LFO::~LFO() = default;
 
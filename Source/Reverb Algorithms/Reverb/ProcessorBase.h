@@ -19,6 +19,7 @@
   #include <juce_gui_extra/juce_gui_extra.h>
 #endif
 #include "../../Utilities.h"
+#include "../CustomDelays.h"   // DelayStorage, DelayArena
 
 class ReverbProcessorBase
 {
@@ -36,6 +37,12 @@ public:
     virtual ReverbProcessorParameters& getParameters() = 0;
     
     virtual void setParameters(const ReverbProcessorParameters& params) = 0;
+
+    // Memory held by the delay lines and filter states, after prepare()
+    virtual DelayArena::Report getMemoryReport() const { return {}; }
+
+    // Sample format of the long lines (pre-delay, tank), from the next prepare()
+    virtual void setDelayStorage(DelayStorage) {}
 };
 
 //class ProcessorBase : public juce::AudioProcessor
@@ -85,13 +85,15 @@ struct SlotInfo
     juce::String slotID;
     juce::String moduleType;
     std::vector<juce::String> usedParameters;
+    int moduleSerial = 0;   // changes whenever the slot gets a new module
 };
 
 enum class ModuleType : int
 {
     Delay = 1,
     Reverb = 2,
-    Convolution = 3
+    Convolution = 3,
+    MultiTap = 4
 };
 
 //template <typename SampleType>
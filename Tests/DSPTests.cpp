@@ -1,7 +1,18 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
 #include <juce_dsp/juce_dsp.h>
+#include "../Source/Reverb Algorithms/DecayAnalysis.h"
+#include "../Source/Modular Classes/DecayAnalyser.h"
+#include "../Source/Reverb Algorithms/Reverb/FDNFilterBank.h"
+#include "../Source/Reverb Algorithms/Reverb/DatorroHall.h"
+#include "../Source/Reverb Algorithms/CustomDelays.h"
+#include "../Source/Reverb Algorithms/Delay/BasicDelay.h"
+#include "../Source/Reverb Algorithms/Delay/MultiTapDelay.h"
+#include "../Source/Reverb Algorithms/Convolution/Convolution.h"
+#include "../Source/DSPKernels.h"
+#include "../Source/HalfFloat.h"
 
 using Catch::Approx;
 
@@ -31,6 +42,949 @@ TEST_CASE("DSP Algorithm Tests", "[dsp]")
     }
 }
 
+TEST_CASE("Decay Analysis", "[dsp][decay]")
+{
+    constexpr double sampleRate = 48000.0;
+
+    // White noise under an exponential envelope: the EDC is a straight line
+    // falling 60 dB per rt60 seconds, in every band
+    auto decayingNoise = [](double rt60, double seconds)
+    {
+        juce::Random random(1234);
+        std::vector<float> h((size_t) (seconds * sampleRate));
+
+        for (size_t i = 0; i < h.size(); ++i)
+        {
+            const double t = (double) i / sampleRate;
+            h[i] = (random.nextFloat() * 2.0f - 1.0f) * (float) std::pow(10.0, -3.0 * t / rt60);
+        }
+
+        return h;
+    };
+
+    SECTION("RT60 of a synthetic exponential decay")
+    {
+        const auto result = DecayAnalysis::analyse(decayingNoise(1.0, 1.6), sampleRate);
+
+        REQUIRE(result.broadband.rt60 == Approx(1.0f).epsilon(0.03));
+        REQUIRE(result.tailSeconds == Approx(1.0).epsilon(0.05));
+        REQUIRE(result.broadband.edcDb.front() == Approx(0.0f).margin(0.01f));
+
+        for (const auto& band : result.bands)
+            REQUIRE(band.rt60 == Approx(1.0f).epsilon(0.1));
+    }
+
+    SECTION("Too short to fit")
+    {
+        const auto result = DecayAnalysis::analyse(decayingNoise(10.0, 0.1), sampleRate);
+
+        REQUIRE(result.broadband.rt60 == 0.0f);
+        REQUIRE(result.tailSeconds == Approx(0.1).margin(1.0e-3));
+    }
+
+    SECTION("Analyser redoes keys dropped from its cache")
+    {
+        // Straight through at some gain: the impulse itself, or nothing
+        struct Gain : DecayAnalysis::Source
+        {
+            explicit Gain(float g) : gain(g) {}
+
+            void prepare(const juce::dsp::ProcessSpec&) override {}
+            void process(juce::AudioBuffer<float>& buffer) override { buffer.applyGain(gain); }
+
+            float gain;
+        };
+
+        DecayAnalyser analyser;
+
+        auto analyse = [&](juce::uint64 key, float gain)
+        {
+            analyser.request(0, key, std::make_unique<Gain>(gain), sampleRate);
+            REQUIRE(analyser.waitUntilIdle(10000));
+        };
+
+        analyse(1, 1.0f);
+        REQUIRE(analyser.find(1) != nullptr);
+
+        // Far more keys than the cache keeps
+        for (juce::uint64 key = 2; key <= 200; ++key)
+            analyse(key, 1.0f);
+
+        REQUIRE(!analyser.isKnown(1));
+        REQUIRE(analyser.find(1) == nullptr);
+
+        analyse(1, 1.0f);
+        REQUIRE(analyser.find(1) != nullptr);
+
+        // Silent: no result, but not queued again either
+        analyse(1000, 0.0f);
+        REQUIRE(analyser.isKnown(1000));
+        REQUIRE(analyser.find(1000) == nullptr);
+    }
+}
+
+TEST_CASE("Partitioned Convolution", "[dsp][convolution]")
+{
+    constexpr int numInputSamples = 3000;
+
+    juce::Random random(0xc0de);
+
+    // Decaying noise, independent per channel
+    auto makeIR = [&random](int numChannels, int length)
+    {
+        juce::AudioBuffer<float> ir(numChannels, length);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < length; ++i)
+                ir.setSample(ch, i, (2.0f * random.nextFloat() - 1.0f) * std::exp(-(float) i / (0.2f * (float) length)));
+
+        return ir;
+    };
+
+    juce::AudioBuffer<float> input(2, numInputSamples);
+
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < numInputSamples; ++i)
+            input.setSample(ch, i, 2.0f * random.nextFloat() - 1.0f);
+
+    // Time-domain reference: output ch = sum over inputs of input * ir[path]
+    auto convolveDirect = [&input](const juce::AudioBuffer<float>& ir, int output, bool crossPaths)
+    {
+        std::vector<double> result((size_t) numInputSamples, 0.0);
+
+        for (int in = 0; in < 2; ++in)
+        {
+            int irChannel = -1;
+
+            if (ir.getNumChannels() == 4)
+                irChannel = (in == output || crossPaths) ? in * 2 + output : -1;
+            else if (in == output)
+                irChannel = ir.getNumChannels() == 1 ? 0 : output;
+
+            if (irChannel < 0)
+                continue;
+
+            for (int t = 0; t < numInputSamples; ++t)
+                for (int k = 0; k < ir.getNumSamples() && k <= t; ++k)
+                    result[(size_t) t] += (double) ir.getSample(irChannel, k) * input.getSample(in, t - k);
+        }
+
+        return result;
+    };
+
+    // Prepares the convolver for maxBlockSize and installs the IR; returns the head length
+    auto install = [](PartitionedConvolver& convolver, const juce::AudioBuffer<float>& ir, int maxBlockSize)
+    {
+        convolver.prepare(maxBlockSize, 48000.0);
+
+        PartitionedConvolver::Update update;
+        update.ir = ImpulseResponseData::create(ir, convolver.getPartitionSize());
+        update.history = std::make_unique<ConvolutionInputHistory>(convolver.getPartitionSize(), update.ir->numPartitions);
+        const int headLength = update.ir->headLength;
+        convolver.install(update);
+
+        return headLength;
+    };
+
+    // Feeds buffers through in place, in callbacks of varying length up to
+    // maxBlockSize, calling beforeCallback() at the start of each one
+    auto processInCallbacks = [](std::vector<PartitionedConvolver*> convolvers,
+                                 std::vector<juce::AudioBuffer<float>*> buffers,
+                                 int maxBlockSize,
+                                 std::function<void()> beforeCallback)
+    {
+        const int callSizes[] = { maxBlockSize, 7, maxBlockSize / 2 + 3, maxBlockSize };
+
+        for (int pos = 0, call = 0; pos < numInputSamples; ++call)
+        {
+            const int n = juce::jmin(callSizes[call % 4], numInputSamples - pos);
+            beforeCallback();
+
+            for (size_t c = 0; c < convolvers.size(); ++c)
+            {
+                float* channels[2] = { buffers[c]->getWritePointer(0, pos), buffers[c]->getWritePointer(1, pos) };
+                convolvers[c]->process(channels, channels, 2, n);
+            }
+
+            pos += n;
+        }
+    };
+
+    auto render = [&](const juce::AudioBuffer<float>& ir, int maxBlockSize, bool crossPaths, int& headLength)
+    {
+        PartitionedConvolver convolver;
+        headLength = install(convolver, ir, maxBlockSize);
+        convolver.setCrossPathsEnabled(crossPaths);
+
+        juce::AudioBuffer<float> output(input);
+        processInCallbacks({ &convolver }, { &output }, maxBlockSize, [] {});
+
+        return output;
+    };
+
+    auto requireMatches = [&](const juce::AudioBuffer<float>& ir, const juce::AudioBuffer<float>& output, bool crossPaths)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const auto expected = convolveDirect(ir, ch, crossPaths);
+
+            for (int i = 0; i < numInputSamples; ++i)
+                REQUIRE(output.getSample(ch, i) == Approx(expected[(size_t) i]).margin(1.0e-4));
+        }
+    };
+
+    SECTION("Pure FIR, hybrid head and all-FFT each match direct convolution")
+    {
+        const auto shortIR = makeIR(2, 200);
+        const auto longIR = makeIR(2, 1000);
+        int headLength = 0;
+
+        // Whole IR within kMaxDirectTaps: pure FIR, even at a large partition
+        requireMatches(shortIR, render(shortIR, 512, true, headLength), true);
+        REQUIRE(headLength == 200);
+
+        // Long IR, partition within kMaxHybridPartition: FIR head + FFT tail
+        const auto hybrid = render(longIR, 32, true, headLength);
+        requireMatches(longIR, hybrid, true);
+        REQUIRE(headLength == 32);
+
+        // Long IR, larger partition: FFT only
+        const auto fftOnly = render(longIR, 128, true, headLength);
+        requireMatches(longIR, fftOnly, true);
+        REQUIRE(headLength == 0);
+    }
+
+    SECTION("True stereo adds the cross paths, and drops them when disabled")
+    {
+        const auto ir = makeIR(4, 700);
+        int headLength = 0;
+
+        REQUIRE(ImpulseResponseData::create(ir, 128)->layout == ImpulseResponseData::Layout::TrueStereo);
+
+        requireMatches(ir, render(ir, 128, true, headLength), true);
+        requireMatches(ir, render(ir, 128, false, headLength), false);
+
+        // Cross paths through the hybrid head as well
+        requireMatches(ir, render(ir, 32, true, headLength), true);
+    }
+
+    SECTION("Convolvers sharing input spectra match their unshared output")
+    {
+        constexpr int maxBlockSize = 128;
+
+        const auto irA = makeIR(2, 1000);
+        const auto irB = makeIR(4, 600);
+
+        auto share = std::make_shared<ConvolutionInputShare>();
+        share->prepare(maxBlockSize);
+
+        PartitionedConvolver first, second, third;
+
+        install(first, irA, maxBlockSize);
+        install(second, irB, maxBlockSize);
+        install(third, irA, maxBlockSize);
+
+        for (auto* convolver : { &first, &second, &third })
+        {
+            convolver->setCrossPathsEnabled(true);
+            convolver->setInputShare(share);
+        }
+
+        // The third one is fed at half level, so it must not take the others' spectra
+        juce::AudioBuffer<float> outFirst(input), outSecond(input), outThird(input);
+        outThird.applyGain(0.5f);
+
+        processInCallbacks({ &first, &second, &third }, { &outFirst, &outSecond, &outThird },
+                           maxBlockSize, [&share] { share->beginBlock(); });
+
+        outThird.applyGain(2.0f);
+
+        requireMatches(irA, outFirst, true);
+        requireMatches(irB, outSecond, true);
+        requireMatches(irA, outThird, true);
+    }
+}
+
+TEST_CASE("Convolution Tone", "[dsp][convolution]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    const juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) blockSize, 2 };
+
+    // A unit impulse as a mono WAV, so the wet output is the baked tone alone
+    juce::MemoryBlock wavData;
+    {
+        juce::AudioBuffer<float> impulse(1, 2048);
+        impulse.clear();
+        impulse.setSample(0, 0, 1.0f);
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            wav.createWriterFor(new juce::MemoryOutputStream(wavData, false), sampleRate, 1, 32, {}, 0));
+
+        REQUIRE(writer != nullptr);
+        writer->writeFromAudioSampleBuffer(impulse, 0, impulse.getNumSamples());
+    }
+
+    Convolution convolution;
+    juce::MidiBuffer midi;
+
+    convolution.prepare(spec);
+    convolution.loadIRFromMemory(wavData.getData(), wavData.getSize(), sampleRate, 1);
+
+    // Applies the tone, waits for the loader to bake it in, then returns the
+    // RMS of a sine at frequency after the filters have settled
+    auto measure = [&](float lowCutHz, float highCutHz, float frequency)
+    {
+        ConvolutionParameters params;
+        params.mix       = 1.0f;
+        params.lowCutHz  = lowCutHz;
+        params.highCutHz = highCutHz;
+        params.tiltDb    = 0.0f;
+        convolution.setParameters(params);
+
+        juce::AudioBuffer<float> block(2, blockSize);
+
+        for (int i = 0; i < 5000 && convolution.isLoadPending(); ++i)
+        {
+            block.clear();
+            convolution.processBlock(block, midi);
+            juce::Thread::sleep(1);
+        }
+
+        REQUIRE_FALSE(convolution.isLoadPending());
+
+        // Rebuilt with the same tone, and no crossfade or history left over
+        convolution.prepare(spec);
+
+        double sumSquares = 0.0;
+        int count = 0;
+
+        for (int b = 0, n = 0; b < 100; ++b)
+        {
+            for (int i = 0; i < blockSize; ++i, ++n)
+            {
+                const float x = 0.5f * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * n / sampleRate);
+                block.setSample(0, i, x);
+                block.setSample(1, i, x);
+            }
+
+            convolution.processBlock(block, midi);
+
+            // Skip the first half while the filters ring in
+            if (b >= 50)
+            {
+                for (int i = 0; i < blockSize; ++i, ++count)
+                    sumSquares += (double) block.getSample(0, i) * block.getSample(0, i);
+            }
+        }
+
+        return std::sqrt(sumSquares / count);
+    };
+
+    SECTION("Low and high cut are baked into the IR")
+    {
+        const double lowOpen   = measure(20.0f, 20000.0f, 100.0f);
+        const double highOpen  = measure(20.0f, 20000.0f, 8000.0f);
+        const double lowShut   = measure(1000.0f, 2000.0f, 100.0f);
+        const double highShut  = measure(1000.0f, 2000.0f, 8000.0f);
+
+        REQUIRE(lowOpen > 0.01);
+        REQUIRE(highOpen > 0.01);
+
+        // Second-order slopes, two octaves or more past the cutoffs
+        REQUIRE(lowShut < 0.1 * lowOpen);
+        REQUIRE(highShut < 0.1 * highOpen);
+    }
+}
+
+TEST_CASE("FDN Filter Bank", "[dsp][reverb]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numLines = 4;
+    constexpr float damping = 6000.0f;
+
+    using Bank = FDNFilterBank<numLines>;
+    Bank bank;
+    bank.prepare(sampleRate);
+    bank.setLowpassCutoff(damping);
+    bank.setPsychoDamping(damping);
+
+    auto shelf = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 3000.0f, 0.707f, 0.5f);
+    bank.setBiquad(*shelf);
+
+    // The per-line scalar filters the bank replaces in HybridPlate
+    juce::dsp::FirstOrderTPTFilter<float> lowpass[numLines];
+    PsychoOnePole psycho[numLines];
+    juce::dsp::IIR::Filter<float> shelves[numLines];
+
+    for (int i = 0; i < numLines; ++i)
+    {
+        lowpass[i].prepare({ sampleRate, 256, 1 });
+        lowpass[i].setType(juce::dsp::FirstOrderTPTFilterType::lowpass);
+        lowpass[i].setCutoffFrequency(damping);
+        psycho[i].prepare((float) sampleRate, damping);
+        shelves[i].coefficients = shelf;
+        shelves[i].reset();
+    }
+
+    SECTION("Every line matches the scalar chain")
+    {
+        juce::Random random(42);
+        alignas(Bank::Register::SIMDRegisterSize) float lines[Bank::paddedLines] = {};
+        float maxError = 0.0f;
+
+        for (int n = 0; n < 4800; ++n)
+        {
+            float expected[numLines];
+
+            for (int i = 0; i < numLines; ++i)
+            {
+                // Different signals per line, so a lane mix-up shows
+                lines[i] = random.nextFloat() * 2.0f - 1.0f;
+                expected[i] = shelves[i].processSample(psycho[i].process(lowpass[i].processSample(0, lines[i])));
+            }
+
+            bank.process(lines);
+
+            for (int i = 0; i < numLines; ++i)
+                maxError = juce::jmax(maxError, std::abs(lines[i] - expected[i]));
+        }
+
+        REQUIRE(maxError < 1.0e-5f);
+    }
+
+    SECTION("Reset clears every line")
+    {
+        alignas(Bank::Register::SIMDRegisterSize) float lines[Bank::paddedLines] = {};
+        std::fill(lines, lines + numLines, 1.0f);
+        bank.process(lines);
+
+        bank.reset();
+        std::fill(lines, lines + Bank::paddedLines, 0.0f);
+        bank.process(lines);
+
+        for (int i = 0; i < numLines; ++i)
+            REQUIRE(lines[i] == 0.0f);
+    }
+}
+
+TEST_CASE("DSP Kernels", "[dsp][kernels]")
+{
+    SECTION("Every kernel table matches the baseline")
+    {
+        // Odd lengths so the vector builds run their tails too. FMA and the
+        // wider reductions reorder the arithmetic, hence the tolerances.
+        constexpr int num = 1027;
+
+        juce::Random random(0x15a);
+        auto fill = [&random](std::vector<float>& v) { for (auto& x : v) x = 2.0f * random.nextFloat() - 1.0f; };
+
+        std::vector<float> a(2 * num), b(2 * num), acc(2 * num), src(num), dest(num);
+        fill(a); fill(b); fill(acc); fill(src); fill(dest);
+
+        struct Results
+        {
+            std::vector<float> mac, added, mixed, lerped;
+            float peak = 0.0f, sumOfSquares = 0.0f;
+        };
+
+        auto run = [&]
+        {
+            const auto& kernels = DSPKernels::get();
+            Results r { acc, dest, dest, std::vector<float>(num) };
+
+            kernels.complexMultiplyAccumulate(r.mac.data(), a.data(), b.data(), num);
+            kernels.addWithMultiply(r.added.data(), src.data(), 0.37f, num);
+            kernels.mix(r.mixed.data(), 0.3f, src.data(), 0.7f, num);
+            kernels.lerp(r.lerped.data(), a.data(), b.data(), 0.61f, num);
+            kernels.measure(src.data(), num, r.peak, r.sumOfSquares);
+
+            return r;
+        };
+
+        REQUIRE(DSPKernels::setIsa(DSPKernels::Isa::Baseline));
+        const auto reference = run();
+
+        auto requireClose = [](const std::vector<float>& x, const std::vector<float>& y)
+        {
+            REQUIRE(x.size() == y.size());
+
+            for (size_t i = 0; i < x.size(); ++i)
+                REQUIRE(x[i] == Approx(y[i]).margin(1.0e-6));
+        };
+
+        for (auto isa : { DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512 })
+        {
+            if (!DSPKernels::setIsa(isa))
+                continue;
+
+            INFO(DSPKernels::getIsaName(isa).toStdString());
+            const auto result = run();
+
+            requireClose(result.mac, reference.mac);
+            requireClose(result.added, reference.added);
+            requireClose(result.mixed, reference.mixed);
+            requireClose(result.lerped, reference.lerped);
+            REQUIRE(result.peak == reference.peak);
+            REQUIRE(result.sumOfSquares == Approx(reference.sumOfSquares).epsilon(1.0e-5));
+        }
+
+        DSPKernels::setIsa(DSPKernels::getBestSupportedIsa());
+    }
+}
+
+TEST_CASE("Basic Delay", "[dsp][delay]")
+{
+    SECTION("The whole-block path matches the per-sample path")
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int length = 48000;
+        constexpr float delayMs = 5.0f;   // 240 samples
+
+        // A noise burst, different per channel, then the feedback ringing out
+        juce::AudioBuffer<float> input(2, length);
+        input.clear();
+        juce::Random random(31);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < 2000; ++i)
+                input.setSample(ch, i, 2.0f * random.nextFloat() - 1.0f);
+
+        // Settings go in before prepare, so nothing glides
+        auto render = [&input](BasicDelay::DelayMode mode, int blockSize)
+        {
+            BasicDelay delay;
+            delay.setMode(mode);
+            delay.setDelayTime(delayMs);
+            delay.setFeedback(0.7f);
+            delay.setMix(0.5f);
+            delay.setPan(0.3f);
+            delay.setLowpassFreq(6000.0f);
+            delay.setHighpassFreq(150.0f);
+            delay.prepare({ sampleRate, 512, 2 });
+
+            juce::AudioBuffer<float> output(input);
+
+            for (int start = 0; start < length; start += blockSize)
+            {
+                const int num = juce::jmin(blockSize, length - start);
+                juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, num);
+                delay.processBlock(block);
+            }
+
+            return output;
+        };
+
+        for (auto mode : { BasicDelay::DelayMode::Normal, BasicDelay::DelayMode::PingPong, BasicDelay::DelayMode::Inverted })
+        {
+            // 128-sample blocks are shorter than the delay (block path),
+            // 512-sample ones longer (per-sample path)
+            const auto blockPath  = render(mode, 128);
+            const auto samplePath = render(mode, 512);
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < length; ++i)
+                    REQUIRE(blockPath.getSample(ch, i) == Approx(samplePath.getSample(ch, i)).margin(1.0e-5));
+        }
+    }
+}
+
+TEST_CASE("Multi-Tap Delay", "[dsp][delay]")
+{
+    SECTION("Each tap lands at its delay with its gain and pan")
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int length = 2400;
+        constexpr int numTaps = MultiTapDelay::kMaxTaps;
+        const float pans[] = { 0.0f, 0.5f, -1.0f, 1.0f, -0.25f };
+
+        // 2.5 ms apart = 120 samples, all filters open, no feedback, fully wet
+        auto tapDelay = [](int t) { return 120 * (t + 1); };
+        auto tapGain  = [](int t) { return 1.0f - 0.05f * (float) t; };
+        auto tapPan   = [&pans](int t) { return pans[t % 5]; };
+
+        MultiTapDelay delay;
+        delay.setNumTaps(numTaps);
+        delay.setFeedback(0.0f);
+        delay.setMix(1.0f);
+
+        for (int t = 0; t < numTaps; ++t)
+            delay.setTap(t, 2.5f * (float) (t + 1), tapGain(t), tapPan(t), 20000.0f);
+
+        delay.prepare({ sampleRate, 512, 2 });
+
+        juce::AudioBuffer<float> buffer(2, length);
+        buffer.clear();
+        buffer.setSample(0, 0, 1.0f);
+        buffer.setSample(1, 0, 1.0f);
+
+        for (int start = 0; start < length; start += 512)
+        {
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, start, juce::jmin(512, length - start));
+            delay.processBlock(block);
+        }
+
+        std::vector<float> expectedL((size_t) length, 0.0f), expectedR((size_t) length, 0.0f);
+
+        for (int t = 0; t < numTaps; ++t)
+        {
+            const float pan = tapPan(t);
+            expectedL[(size_t) tapDelay(t)] = tapGain(t) * (1.0f - juce::jmax(0.0f, pan));
+            expectedR[(size_t) tapDelay(t)] = tapGain(t) * (1.0f + juce::jmin(0.0f, pan));
+        }
+
+        for (int i = 0; i < length; ++i)
+        {
+            REQUIRE(buffer.getSample(0, i) == Approx(expectedL[(size_t) i]).margin(1.0e-6));
+            REQUIRE(buffer.getSample(1, i) == Approx(expectedR[(size_t) i]).margin(1.0e-6));
+        }
+    }
+}
+
+TEST_CASE("Tape Delay", "[dsp][delay]")
+{
+    SECTION("Each interpolator reproduces a ramp at fractional delays")
+    {
+        // All three are exact on a straight line: cubic and Lagrange
+        // outright, the allpass once its state has settled
+        constexpr float slope = 0.001f;
+        constexpr int numWritten = 1000;
+        constexpr int numToRead = 64;
+        constexpr int settle = 16;
+
+        DelayLineWithSampleAccess<float> line(1000);
+        line.prepare({ 48000.0, 256, 1 });
+
+        for (int i = 0; i < numWritten; ++i)
+            line.pushSample(0, slope * (float) i);
+
+        for (auto interpolation : { DelayInterpolation::Cubic, DelayInterpolation::Lagrange, DelayInterpolation::Allpass })
+        {
+            for (float delay : { 100.25f, 100.5f, 100.75f, 313.3f })
+            {
+                std::vector<float> delays(numToRead, delay), out(numToRead);
+                float allpassState = 0.0f;
+
+                line.readFractionalBlock(0, delays.data(), out.data(), numToRead, interpolation, allpassState);
+
+                const int first = interpolation == DelayInterpolation::Allpass ? settle : 0;
+
+                for (int i = first; i < numToRead; ++i)
+                    REQUIRE(out[(size_t) i] == Approx(slope * ((float) (numWritten + i) - delay)).margin(1.0e-5));
+            }
+        }
+    }
+
+    SECTION("Each interpolator follows a sine at fractional delays")
+    {
+        // 500 Hz at 48 kHz: well inside the band where all three are flat
+        const float omega = juce::MathConstants<float>::twoPi * 500.0f / 48000.0f;
+        constexpr int numWritten = 2000;
+        constexpr int numToRead = 256;
+        constexpr int settle = 16;
+
+        DelayLineWithSampleAccess<float> line(2000);
+        line.prepare({ 48000.0, 256, 1 });
+
+        for (int i = 0; i < numWritten; ++i)
+            line.pushSample(0, std::sin(omega * (float) i));
+
+        for (auto interpolation : { DelayInterpolation::Cubic, DelayInterpolation::Lagrange, DelayInterpolation::Allpass })
+        {
+            for (float delay : { 400.25f, 400.5f, 400.75f, 1013.3f })
+            {
+                std::vector<float> delays(numToRead, delay), out(numToRead);
+                float allpassState = 0.0f;
+
+                line.readFractionalBlock(0, delays.data(), out.data(), numToRead, interpolation, allpassState);
+
+                const int first = interpolation == DelayInterpolation::Allpass ? settle : 0;
+
+                for (int i = first; i < numToRead; ++i)
+                    REQUIRE(out[(size_t) i] == Approx(std::sin(omega * ((float) (numWritten + i) - delay))).margin(2.0e-4));
+            }
+        }
+    }
+
+    SECTION("Tape without wow or flutter matches Normal")
+    {
+        // Whole-sample delays hit every interpolator's exact case
+        const juce::dsp::ProcessSpec spec { 48000.0, 256, 2 };
+
+        for (auto interpolation : { DelayInterpolation::Cubic, DelayInterpolation::Lagrange, DelayInterpolation::Allpass })
+        {
+            BasicDelay normal, tape;
+
+            for (auto* delay : { &normal, &tape })
+            {
+                delay->setDelayTime(10.0f);
+                delay->setFeedback(0.6f);
+                delay->setMix(0.5f);
+                delay->setLowpassFreq(8000.0f);
+                delay->setWow(0.0f);
+                delay->setFlutter(0.0f);
+                delay->setInterpolation(interpolation);
+                delay->prepare(spec);
+            }
+
+            normal.setMode(BasicDelay::DelayMode::Normal);
+            tape.setMode(BasicDelay::DelayMode::Tape);
+
+            juce::Random random(0x7a9e);
+            juce::AudioBuffer<float> a(2, 256), b(2, 256);
+
+            for (int block = 0; block < 20; ++block)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < 256; ++i)
+                        a.setSample(ch, i, block < 2 ? random.nextFloat() - 0.5f : 0.0f);
+
+                b.makeCopyOf(a);
+                normal.processBlock(a);
+                tape.processBlock(b);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < 256; ++i)
+                        REQUIRE(b.getSample(ch, i) == a.getSample(ch, i));
+            }
+        }
+    }
+}
+
+TEST_CASE("Delay Arena", "[dsp][memory]")
+{
+    SECTION("Lines are carved from one aligned block and keep working")
+    {
+        DelayArena arena;
+        DelayLineWithSampleAccess<float> a(1000), b(333);
+        const juce::dsp::ProcessSpec spec { 48000.0, 256, 2 };
+
+        arena.beginLayout();
+        a.prepare(spec, arena, "a");
+        b.prepare(spec, arena, "b");
+        arena.allocate(false);
+        a.prepare(spec, arena, "a");
+        b.prepare(spec, arena, "b");
+
+        const auto report = arena.getReport();
+        REQUIRE(report.numBlocks == 1);
+        REQUIRE(report.entries.size() == 2);
+        REQUIRE(report.totalBytes % DelayArena::alignment == 0);
+        REQUIRE(report.totalBytes >= (1001 + 334) * 2 * sizeof(float));
+
+        b.setDelay(10);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            a.pushSample(1, (float) i);
+            b.pushSample(0, (float) i);
+        }
+
+        REQUIRE(a.getSampleAtDelay(1, 5) == 15.0f);
+        REQUIRE(b.popSample(0) == 10.0f);
+        REQUIRE(a.getSampleAtDelay(0, 5) == 0.0f);
+    }
+
+    SECTION("DatorroHall holds mono lines in a single block")
+    {
+        DatorroHall hall;
+        hall.prepare({ 48000.0, 256, 2 });
+
+        const auto report = hall.getMemoryReport();
+
+        // Twelve 44101-sample lines plus the allpasses: one channel's worth
+        const size_t linesBytes = 12 * 44101 * sizeof(float);
+        REQUIRE(report.numBlocks == 1);
+        REQUIRE(report.totalBytes >= linesBytes);
+        REQUIRE(report.totalBytes < linesBytes + linesBytes / 4);
+    }
+}
+
+TEST_CASE("Half-Precision Delay Storage", "[dsp][memory]")
+{
+    SECTION("Conversions round to nearest even")
+    {
+        REQUIRE(HalfFloat::floatToHalf(1.0f) == 0x3c00);
+        REQUIRE(HalfFloat::floatToHalf(-2.0f) == 0xc000);
+        REQUIRE(HalfFloat::floatToHalf(65504.0f) == 0x7bff);
+        REQUIRE(HalfFloat::floatToHalf(65520.0f) == 0x7c00);                        // ties up to infinity
+        REQUIRE(HalfFloat::floatToHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3c00);    // tie to even
+        REQUIRE(HalfFloat::floatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3c02);
+        REQUIRE(HalfFloat::floatToHalf(std::ldexp(1.0f, -24)) == 0x0001);           // smallest subnormal
+        REQUIRE(HalfFloat::floatToHalf(std::ldexp(1.0f, -26)) == 0x0000);
+
+        REQUIRE(HalfFloat::floatToBFloat16(1.0f) == 0x3f80);
+        REQUIRE(HalfFloat::floatToBFloat16(1.0f + std::ldexp(1.0f, -8)) == 0x3f80);
+        REQUIRE(HalfFloat::floatToBFloat16(1.0f + 3.0f * std::ldexp(1.0f, -8)) == 0x3f82);
+    }
+
+    SECTION("Every kernel table converts every finite half both ways")
+    {
+        std::vector<juce::uint16> halves;
+
+        for (int h = 0; h < 0x10000; ++h)
+            if ((h & 0x7c00) != 0x7c00)
+                halves.push_back((juce::uint16) h);
+
+        const int num = (int) halves.size();
+        std::vector<float> floats((size_t) num);
+        std::vector<juce::uint16> back((size_t) num);
+
+        for (auto isa : { DSPKernels::Isa::Baseline, DSPKernels::Isa::AVX2, DSPKernels::Isa::AVX512 })
+        {
+            if (!DSPKernels::setIsa(isa))
+                continue;
+
+            DSPKernels::get().halfToFloat(halves.data(), floats.data(), num);
+            DSPKernels::get().floatToHalf(floats.data(), back.data(), num);
+
+            for (int i = 0; i < num; ++i)
+                REQUIRE(floats[(size_t) i] == HalfFloat::halfToFloat(halves[(size_t) i]));
+
+            REQUIRE(back == halves);
+        }
+
+        DSPKernels::setIsa(DSPKernels::getBestSupportedIsa());
+    }
+
+    SECTION("Lines read back what was written, to the format's precision")
+    {
+        for (auto storage : { DelayStorage::Float16, DelayStorage::BFloat16 })
+        {
+            const float tolerance = storage == DelayStorage::Float16 ? std::ldexp(1.0f, -11) : std::ldexp(1.0f, -8);
+
+            DelayLineWithSampleAccess<float> perSample(1000), perBlock(1000);
+            perSample.setStorage(storage);
+            perBlock.setStorage(storage);
+            perSample.prepare({ 48000.0, 256, 1 });
+            perBlock.prepare({ 48000.0, 256, 1 });
+
+            std::vector<float> input(3000), block(100);
+
+            for (size_t i = 0; i < input.size(); ++i)
+                input[i] = 0.5f * std::sin(0.01f * (float) i) + 0.001f * std::cos(0.37f * (float) i);
+
+            for (size_t start = 0; start < input.size(); start += 100)
+            {
+                for (size_t i = 0; i < 100; ++i)
+                    perSample.pushSample(0, input[start + i]);
+
+                perBlock.writeBlock(0, input.data() + start, 100);
+            }
+
+            // Block reads see exactly what the per-sample path stores
+            perBlock.readBlock(0, 500, block.data(), 100);
+
+            for (int i = 0; i < 100; ++i)
+            {
+                const float expected = input[input.size() - 500 + (size_t) i];
+                REQUIRE(block[(size_t) i] == perSample.getSampleAtDelay(0, 500 - i));
+                REQUIRE(std::abs(block[(size_t) i] - expected) <= tolerance * std::abs(expected) + 1.0e-7f);
+            }
+        }
+    }
+
+    SECTION("Rounding noise recirculating in a feedback network")
+    {
+        // Four lines with Householder feedback and a 4 s RT60, fed a 100 ms
+        // noise burst. Against the float run over the first two seconds the
+        // difference is about -68 dB for half and -50 dB for bfloat16; it
+        // grows relative to the tail as the tail decays (about -60 / -42 dB
+        // two seconds in).
+        constexpr double sampleRate = 48000.0;
+        const int lengths[4] = { 1531, 1877, 2213, 2711 };
+
+        auto render = [&](DelayStorage storage)
+        {
+            DelayLineWithSampleAccess<float> lines[4] = { DelayLineWithSampleAccess<float>(3000), DelayLineWithSampleAccess<float>(3000),
+                                                          DelayLineWithSampleAccess<float>(3000), DelayLineWithSampleAccess<float>(3000) };
+            float gains[4];
+
+            for (int i = 0; i < 4; ++i)
+            {
+                lines[i].setStorage(storage);
+                lines[i].prepare({ sampleRate, 256, 1 });
+                lines[i].setDelay(lengths[i]);
+                gains[i] = (float) std::pow(10.0, -3.0 * lengths[i] / (4.0 * sampleRate));
+            }
+
+            juce::Random random(5);
+            std::vector<float> out((size_t) (2.0 * sampleRate));
+
+            for (size_t n = 0; n < out.size(); ++n)
+            {
+                const float in = n < (size_t) (0.1 * sampleRate) ? 0.5f * random.nextFloat() - 0.25f : 0.0f;
+                float x[4], sum = 0.0f;
+
+                for (int i = 0; i < 4; ++i)
+                {
+                    x[i] = lines[i].popSample(0) * gains[i];
+                    sum += x[i];
+                }
+
+                for (int i = 0; i < 4; ++i)
+                    lines[i].pushSample(0, in + x[i] - 0.5f * sum);
+
+                out[n] = x[0] + x[1] + x[2] + x[3];
+            }
+
+            return out;
+        };
+
+        auto errorDb = [](const std::vector<float>& reference, const std::vector<float>& test)
+        {
+            double error = 0.0, signal = 0.0;
+
+            for (size_t n = 0; n < reference.size(); ++n)
+            {
+                error += ((double) test[n] - reference[n]) * ((double) test[n] - reference[n]);
+                signal += (double) reference[n] * reference[n];
+            }
+
+            return 10.0 * std::log10(error / signal);
+        };
+
+        const auto reference = render(DelayStorage::Float32);
+
+        REQUIRE(errorDb(reference, render(DelayStorage::Float16)) < -58.0);
+        REQUIRE(errorDb(reference, render(DelayStorage::BFloat16)) < -40.0);
+    }
+
+    SECTION("DatorroHall's long lines take half the memory")
+    {
+        DatorroHall full, half;
+        half.setDelayStorage(DelayStorage::Float16);
+
+        full.prepare({ 48000.0, 256, 2 });
+        half.prepare({ 48000.0, 256, 2 });
+
+        const auto fullBytes = full.getMemoryReport().totalBytes;
+        const auto halfBytes = half.getMemoryReport().totalBytes;
+
+        REQUIRE(halfBytes < fullBytes * 6 / 10);
+        REQUIRE(halfBytes > fullBytes * 4 / 10);
+
+        // Still produces a tail
+        juce::AudioBuffer<float> buffer(2, 256);
+        juce::MidiBuffer midi;
+        buffer.clear();
+        buffer.setSample(0, 0, 1.0f);
+        buffer.setSample(1, 0, 1.0f);
+
+        float energy = 0.0f;
+
+        for (int block = 0; block < 40; ++block)
+        {
+            half.processBlock(buffer, midi);
+            energy += buffer.getRMSLevel(0, 0, 256);
+            buffer.clear();
+        }
+
+        REQUIRE(energy > 0.0f);
+    }
+}
+
 TEST_CASE("Audio Signal Tests", "[dsp][audio]")
 {
     SECTION("Null test - bypass should not alter signal")
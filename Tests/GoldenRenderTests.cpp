@@ -0,0 +1,323 @@
+#include <catch2/catch_test_macros.hpp>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_dsp/juce_dsp.h>
+#include "RenderSubjects.h"
+
+// Golden renders: fixed stimuli through each algorithm and a full rack, with
+// fixed parameter trajectories, compared against the references in
+// Tests/Golden. A missing reference fails; ADSRECHO_UPDATE_GOLDEN=1 records
+// all of them, for a new case or after an intended change (commit the WAVs).
+// The case is hidden ([.]) until the references are committed, so the
+// default run stays green; name it ("[golden]") to run or record it.
+// ADSRECHO_GOLDEN_BIT_EXACT=1 demands identical samples, for refactors that
+// must not change a single bit on the machine that recorded the references.
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int numChannels = 2;
+    constexpr int renderLength = 96000;    // 2 s: stimulus plus most of the tail
+
+    juce::File getIRFile() { return juce::File(ADSRECHO_IR_DIR).getChildFile("Block Inside.wav"); }
+
+    //==============================================================================
+    // Stimuli
+
+    juce::AudioBuffer<float> makeImpulse()
+    {
+        juce::AudioBuffer<float> buffer(numChannels, renderLength);
+        buffer.clear();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.setSample(ch, 0, 1.0f);
+
+        return buffer;
+    }
+
+    // 1 s exponential sweep, 20 Hz to 20 kHz, with a 5 ms fade-out
+    juce::AudioBuffer<float> makeSweep()
+    {
+        juce::AudioBuffer<float> buffer(numChannels, renderLength);
+        buffer.clear();
+
+        const int length = (int) sampleRate;
+        const double f0 = 20.0, f1 = 20000.0;
+        const double k = std::log(f1 / f0);
+        const int fade = (int) (0.005 * sampleRate);
+
+        for (int i = 0; i < length; ++i)
+        {
+            const double t = i / sampleRate;
+            const double phase = juce::MathConstants<double>::twoPi * f0 * (std::exp(t * k) - 1.0) / k;
+            const float gain = 0.5f * juce::jmin(1.0f, (float) (length - i) / (float) fade);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.setSample(ch, i, gain * (float) std::sin(phase));
+        }
+
+        return buffer;
+    }
+
+    // 100 ms of white noise, independent per channel, from a fixed seed
+    juce::AudioBuffer<float> makeNoiseBurst()
+    {
+        juce::AudioBuffer<float> buffer(numChannels, renderLength);
+        buffer.clear();
+
+        juce::Random random(0x5eed);
+        const int length = (int) (0.1 * sampleRate);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < length; ++i)
+                buffer.setSample(ch, i, random.nextFloat() - 0.5f);
+
+        return buffer;
+    }
+
+    //==============================================================================
+    // Comparison
+
+    struct Tolerance
+    {
+        float maxErrorDb;            // peak error relative to the reference peak
+        float maxSpectralDistanceDb; // RMS log-spectral difference
+
+        static Tolerance bitExact() { return { -std::numeric_limits<float>::infinity(), 0.0f }; }
+    };
+
+    struct Case
+    {
+        juce::String name;
+        std::function<std::unique_ptr<Subject>()> create;
+        Tolerance tolerance;
+    };
+
+    // Renders one stimulus through a freshly prepared subject. IR loads are
+    // allowed to finish first, then the subject is prepared again: prepare()
+    // installs a loaded IR synchronously and resets every delay line and LFO,
+    // so the result does not depend on how long the load took.
+    juce::AudioBuffer<float> render(Subject& subject, const juce::AudioBuffer<float>& stimulus)
+    {
+        const juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) blockSize, (juce::uint32) numChannels };
+
+        subject.prepare(spec);
+        subject.startLoads();
+
+        juce::AudioBuffer<float> block(numChannels, blockSize);
+
+        for (int i = 0; i < 5000; ++i)
+        {
+            block.clear();
+            subject.process(block);
+
+            if (!subject.isBusy())
+                break;
+
+            juce::Thread::sleep(1);
+        }
+
+        REQUIRE_FALSE(subject.isBusy());
+
+        subject.prepare(spec);
+
+        juce::AudioBuffer<float> output(stimulus);
+        const int numBlocks = renderLength / blockSize;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            subject.setAt((double) b / numBlocks);
+            block.setDataToReferTo(output.getArrayOfWritePointers(), numChannels, b * blockSize, blockSize);
+            subject.process(block);
+        }
+
+        return output;
+    }
+
+    float peakErrorDb(const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference)
+    {
+        float peakError = 0.0f;
+        float peakReference = 0.0f;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < renderLength; ++i)
+            {
+                const float ref = reference.getSample(ch, i);
+                peakError = juce::jmax(peakError, std::abs(output.getSample(ch, i) - ref));
+                peakReference = juce::jmax(peakReference, std::abs(ref));
+            }
+        }
+
+        if (peakError == 0.0f)
+            return -std::numeric_limits<float>::infinity();
+
+        return juce::Decibels::gainToDecibels(peakError / juce::jmax(peakReference, 1.0e-9f), -400.0f);
+    }
+
+    // RMS dB difference of Hann-windowed magnitude spectra, over bins within
+    // 100 dB of the reference's loudest bin
+    float spectralDistanceDb(const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference)
+    {
+        constexpr int order = 11;
+        constexpr int size = 1 << order;
+
+        juce::dsp::FFT fft(order);
+        juce::dsp::WindowingFunction<float> window(size, juce::dsp::WindowingFunction<float>::hann, false);
+
+        std::vector<std::vector<float>> outSpectra, refSpectra;
+        std::vector<float> scratch((size_t) size * 2);
+
+        auto spectrum = [&](const juce::AudioBuffer<float>& buffer, int ch, int start)
+        {
+            std::fill(scratch.begin(), scratch.end(), 0.0f);
+            std::copy_n(buffer.getReadPointer(ch, start), size, scratch.begin());
+            window.multiplyWithWindowingTable(scratch.data(), size);
+            fft.performFrequencyOnlyForwardTransform(scratch.data(), true);
+            return std::vector<float>(scratch.begin(), scratch.begin() + size / 2 + 1);
+        };
+
+        float loudest = 0.0f;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int start = 0; start + size <= renderLength; start += size)
+            {
+                refSpectra.push_back(spectrum(reference, ch, start));
+                outSpectra.push_back(spectrum(output, ch, start));
+
+                for (auto m : refSpectra.back())
+                    loudest = juce::jmax(loudest, m);
+            }
+        }
+
+        const float floor = loudest * 1.0e-5f;
+        double sumSquares = 0.0;
+        int count = 0;
+
+        for (size_t f = 0; f < refSpectra.size(); ++f)
+        {
+            for (size_t k = 0; k < refSpectra[f].size(); ++k)
+            {
+                const float ref = refSpectra[f][k];
+
+                if (ref <= floor)
+                    continue;
+
+                const double diff = 20.0 * std::log10((outSpectra[f][k] + floor) / (ref + floor));
+                sumSquares += diff * diff;
+                ++count;
+            }
+        }
+
+        return count > 0 ? (float) std::sqrt(sumSquares / count) : 0.0f;
+    }
+
+    //==============================================================================
+    // References: 32-bit float WAV in Tests/Golden
+
+    juce::File getReferenceFile(const juce::String& name)
+    {
+        return juce::File(ADSRECHO_GOLDEN_DIR).getChildFile(name.replaceCharacter('/', '_') + ".wav");
+    }
+
+    bool readReference(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+
+        if (reader == nullptr || (int) reader->numChannels != numChannels || reader->lengthInSamples != renderLength)
+            return false;
+
+        buffer.setSize(numChannels, renderLength);
+        return reader->read(&buffer, 0, renderLength, 0, true, true);
+    }
+
+    bool writeReference(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+
+        juce::WavAudioFormat wav;
+        auto stream = file.createOutputStream();
+
+        if (stream == nullptr)
+            return false;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            wav.createWriterFor(stream.get(), sampleRate, (unsigned int) numChannels, 32, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        stream.release();   // owned by the writer now
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    std::vector<Case> createCases()
+    {
+        using Mode = BasicDelay::DelayMode;
+
+        return {
+            { "BasicDelay",   [] { return std::make_unique<BasicDelaySubject>(Mode::Normal); },    { -120.0f, 0.01f } },
+            { "BasicDelay/Tape", [] { return std::make_unique<BasicDelaySubject>(Mode::Tape); },   { -100.0f, 0.05f } },
+            { "DatorroHall",  [] { return std::make_unique<ReverbSubject<DatorroHall>>(); },       { -100.0f, 0.05f } },
+            { "HybridPlate",  [] { return std::make_unique<ReverbSubject<HybridPlate>>(); },       { -100.0f, 0.05f } },
+
+            // FFT rounding and the per-CPU kernels (DSPKernels) move the low bits
+            { "Convolution",  [] { return std::make_unique<ConvolutionSubject>(getIRFile()); },    { -90.0f, 0.1f } },
+            { "Rack",         [] { return std::make_unique<RackSubject>(getIRFile()); },           { -90.0f, 0.1f } },
+        };
+    }
+}
+
+TEST_CASE("Golden renders", "[.][dsp][golden]")
+{
+    const bool update = juce::SystemStats::getEnvironmentVariable("ADSRECHO_UPDATE_GOLDEN", {}) == "1";
+    const bool bitExact = juce::SystemStats::getEnvironmentVariable("ADSRECHO_GOLDEN_BIT_EXACT", {}) == "1";
+
+    const std::pair<const char*, juce::AudioBuffer<float> (*)()> stimuli[] = {
+        { "Impulse", makeImpulse },
+        { "Sweep", makeSweep },
+        { "NoiseBurst", makeNoiseBurst },
+    };
+
+    for (const auto& c : createCases())
+    {
+        for (const auto& [stimulusName, makeStimulus] : stimuli)
+        {
+            const auto name = c.name + "/" + stimulusName;
+
+            DYNAMIC_SECTION(name)
+            {
+                auto subject = c.create();
+                const auto output = render(*subject, makeStimulus());
+
+                const auto file = getReferenceFile(name);
+                juce::AudioBuffer<float> reference;
+
+                if (update)
+                {
+                    REQUIRE(writeReference(file, output));
+                    WARN("Recorded " << file.getFullPathName().toStdString());
+                }
+                else
+                {
+                    INFO("No reference at " << file.getFullPathName().toStdString()
+                                            << " - record it with ADSRECHO_UPDATE_GOLDEN=1");
+                    REQUIRE(file.existsAsFile());
+                    REQUIRE(readReference(file, reference));
+
+                    const auto tolerance = bitExact ? Tolerance::bitExact() : c.tolerance;
+                    const auto errorDb = peakErrorDb(output, reference);
+                    const auto distanceDb = spectralDistanceDb(output, reference);
+
+                    INFO(name.toStdString() << ": peak error " << errorDb << " dB, spectral distance "
+                                            << distanceDb << " dB");
+                    CHECK(errorDb <= tolerance.maxErrorDb);
+                    CHECK(distanceDb <= tolerance.maxSpectralDistanceDb);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    LegacyState.h
+    The state as getStateInformation wrote it before the binary format, for
+    the persistence tests and the state benchmarks.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../Source/PluginProcessor.h"
+
+//==============================================================================
+// Every parameter in the APVTS tree, plus the Modules child listing each
+// occupied slot's type, as XML wrapped by copyXmlToBinary
+inline juce::MemoryBlock createLegacyState(ADSREchoAudioProcessor& processor)
+{
+    auto state = processor.apvts.copyState();
+    juce::ValueTree modules("Modules");
+
+    for (int j = 0; j < processor.getNumChains(); ++j)
+    {
+        juce::ValueTree chain("Chain");
+        chain.setProperty("index", j, nullptr);
+
+        for (int i = 0; i < processor.getNumSlots(); ++i)
+        {
+            if (processor.slotIsEmpty(j, i))
+                continue;
+
+            juce::ValueTree slot("Slot");
+            slot.setProperty("index", i, nullptr);
+            slot.setProperty("type", processor.getSlotInfo(j, i).moduleType, nullptr);
+            chain.addChild(slot, -1, nullptr);
+        }
+
+        modules.addChild(chain, -1, nullptr);
+    }
+
+    state.addChild(modules, -1, nullptr);
+
+    juce::MemoryBlock data;
+    juce::AudioProcessor::copyXmlToBinary(*state.createXml(), data);
+    return data;
+}
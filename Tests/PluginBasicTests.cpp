@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "../Source/PluginProcessor.h"
+#include "LegacyState.h"
 
 TEST_CASE("Plugin Basic Tests", "[plugin]")
 {
@@ -29,15 +31,457 @@ TEST_CASE("Plugin Basic Tests", "[plugin]")
 
 TEST_CASE("State Management", "[plugin][state]")
 {
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the APVTS needs a message manager
+
+    ADSREchoAudioProcessor source;
+    source.addModule(0, ModuleType::Delay);
+    source.addModule(0, ModuleType::Reverb);
+    source.addModule(1, ModuleType::MultiTap);
+
+    source.apvts.getParameter("parallelEnabled")->setValueNotifyingHost(1.0f);
+    source.apvts.getParameter("chain_0.slot_1.decayTime")->setValueNotifyingHost(0.75f);
+    source.apvts.getParameter("chain_1.slot_0.tapCount")->setValueNotifyingHost(0.5f);
+
+    auto valueOf = [](ADSREchoAudioProcessor& p, const juce::String& id)
+    {
+        return p.apvts.getParameter(id)->getValue();
+    };
+
+    auto requireSameRack = [&](ADSREchoAudioProcessor& restored)
+    {
+        for (int j = 0; j < source.getNumChains(); ++j)
+        {
+            for (int i = 0; i < source.getNumSlots(); ++i)
+            {
+                REQUIRE(restored.slotIsEmpty(j, i) == source.slotIsEmpty(j, i));
+
+                if (!source.slotIsEmpty(j, i))
+                    REQUIRE(restored.getSlotInfo(j, i).moduleType == source.getSlotInfo(j, i).moduleType);
+            }
+        }
+
+        for (const auto* id : { "parallelEnabled", "chain_0.slot_1.decayTime", "chain_1.slot_0.tapCount" })
+            REQUIRE(valueOf(restored, id) == Catch::Approx(valueOf(source, id)));
+    };
+
     SECTION("Save and load state")
     {
-        // Test preset save/load functionality
-        REQUIRE(true); // Placeholder
+        juce::MemoryBlock data;
+        source.getStateInformation(data);
+
+        REQUIRE(RackState::isBinary(data.getData(), (int) data.getSize()));
+
+        ADSREchoAudioProcessor restored;
+        restored.setStateInformation(data.getData(), (int) data.getSize());
+        requireSameRack(restored);
     }
 
     SECTION("Parameter persistence")
     {
-        // Test that parameter values are preserved
-        REQUIRE(true); // Placeholder
+        // Sessions saved as APVTS XML before the binary format still load
+        const auto data = createLegacyState(source);
+
+        ADSREchoAudioProcessor restored;
+        restored.setStateInformation(data.getData(), (int) data.getSize());
+        requireSameRack(restored);
+    }
+
+    SECTION("Truncated state is rejected")
+    {
+        juce::MemoryBlock data;
+        source.getStateInformation(data);
+
+        ADSREchoAudioProcessor restored;
+        restored.addModule(0, ModuleType::Convolution);
+        restored.setStateInformation(data.getData(), (int) data.getSize() - 3);
+
+        REQUIRE(restored.getSlotInfo(0, 0).moduleType == "Convolution");
+    }
+}
+
+TEST_CASE("Snapshot Morph", "[plugin][morph]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the APVTS needs a message manager
+
+    ADSREchoAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, 48000.0, 256);
+    processor.prepareToPlay(48000.0, 256);
+    processor.addModule(0, ModuleType::Delay);
+
+    auto* mix = processor.apvts.getParameter("chain_0.slot_0.mix");
+    auto* rawMix = processor.apvts.getRawParameterValue("chain_0.slot_0.mix");
+
+    juce::AudioBuffer<float> buffer(2, 256);
+    juce::MidiBuffer midi;
+
+    auto processBlock = [&]
+    {
+        buffer.clear();
+        processor.processBlock(buffer, midi);
+    };
+
+    mix->setValueNotifyingHost(0.2f);
+    processor.captureSnapshot(0);
+
+    mix->setValueNotifyingHost(0.8f);
+    processor.captureSnapshot(1);
+
+    REQUIRE(processor.hasSnapshot(0));
+    REQUIRE(processor.hasSnapshot(1));
+
+    SECTION("Values are interpolated without touching the parameters")
+    {
+        processor.apvts.getParameter("morph")->setValueNotifyingHost(0.5f);
+        processBlock();
+
+        REQUIRE(rawMix->load() == Catch::Approx(0.5f).margin(1.0e-4));
+        REQUIRE(mix->getValue() == Catch::Approx(0.8f));
+
+        processor.apvts.getParameter("morph")->setValueNotifyingHost(0.0f);
+        processBlock();
+
+        REQUIRE(rawMix->load() == Catch::Approx(0.2f).margin(1.0e-4));
+    }
+
+    SECTION("Clearing hands the values back to the parameters")
+    {
+        processor.apvts.getParameter("morph")->setValueNotifyingHost(0.25f);
+        processBlock();
+
+        processor.clearSnapshots();
+        processBlock();
+
+        REQUIRE_FALSE(processor.hasSnapshot(0));
+        REQUIRE(rawMix->load() == Catch::Approx(0.8f).margin(1.0e-4));
+    }
+
+    SECTION("Snapshots are saved with the state")
+    {
+        juce::MemoryBlock data;
+        processor.getStateInformation(data);
+
+        ADSREchoAudioProcessor restored;
+        restored.setStateInformation(data.getData(), (int) data.getSize());
+
+        REQUIRE(restored.hasSnapshot(0));
+        REQUIRE(restored.hasSnapshot(1));
+    }
+}
+
+TEST_CASE("Slot Module Serials", "[plugin][editor]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the APVTS needs a message manager
+
+    ADSREchoAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, 48000.0, 256);
+    processor.prepareToPlay(48000.0, 256);
+    processor.addModule(0, ModuleType::Delay);
+    processor.addModule(0, ModuleType::Reverb);
+
+    const int first = processor.getSlotInfo(0, 0).moduleSerial;
+    const int second = processor.getSlotInfo(0, 1).moduleSerial;
+
+    REQUIRE(first != second);
+
+    SECTION("A moved module keeps its serial")
+    {
+        processor.removeModule(0, 0);
+
+        juce::AudioBuffer<float> buffer(2, 256);
+        juce::MidiBuffer midi;
+        processor.processBlock(buffer, midi);
+
+        REQUIRE(processor.getSlotInfo(0, 0).moduleType == "Reverb");
+        REQUIRE(processor.getSlotInfo(0, 0).moduleSerial == second);
+    }
+
+    SECTION("A new module type gets a new serial")
+    {
+        processor.changeModuleType(0, 0, ModuleType::MultiTap);
+
+        REQUIRE(processor.getSlotInfo(0, 0).moduleSerial != first);
+        REQUIRE(processor.getSlotInfo(0, 1).moduleSerial == second);
+    }
+}
+
+TEST_CASE("Level Meters", "[plugin][meters]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the APVTS needs a message manager
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+
+    ADSREchoAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto& meters = processor.getLevelMeters();
+
+    // 1 kHz at -6 dBFS through an empty chain, which passes it unchanged
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    int phase = 0;
+
+    auto processBlocks = [&](int numBlocks)
+    {
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int i = 0; i < blockSize; ++i, ++phase)
+            {
+                const float x = 0.5f * (float) std::sin(juce::MathConstants<double>::twoPi * 1000.0 * phase / sampleRate);
+                buffer.setSample(0, i, x);
+                buffer.setSample(1, i, x);
+            }
+
+            processor.processBlock(buffer, midi);
+        }
+    };
+
+    SECTION("Nothing is measured without a viewer")
+    {
+        processBlocks(8);
+        meters.update();
+
+        REQUIRE(meters.getChainLevels(0).peak[0] == 0.0f);
+    }
+
+    SECTION("Chain peak, RMS and spectrum")
+    {
+        meters.addViewer();
+        meters.addSpectrumViewer();
+
+        processBlocks(16);
+        meters.update();
+
+        const auto& levels = meters.getChainLevels(0);
+        REQUIRE(levels.peak[0] == Catch::Approx(0.5f).margin(1.0e-3));
+        REQUIRE(levels.rms[1] == Catch::Approx(0.5f / std::sqrt(2.0f)).margin(1.0e-3));
+
+        // The loudest band is the one holding 1 kHz, at about -6 dB
+        const auto& spectrum = meters.getChainSpectrum(0);
+        const auto loudest = std::max_element(std::begin(spectrum.bandDb), std::end(spectrum.bandDb));
+
+        REQUIRE(*loudest == Catch::Approx(-6.0f).margin(1.5f));
+
+        meters.removeSpectrumViewer();
+        meters.removeViewer();
+    }
+}
+
+TEST_CASE("Decay Analysis Of Slots", "[plugin][decay]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the APVTS needs a message manager
+
+    ADSREchoAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, 48000.0, 256);
+    processor.prepareToPlay(48000.0, 256);
+
+    auto analyse = [&processor]
+    {
+        processor.updateDecayAnalysis();
+        REQUIRE(processor.waitForDecayAnalysis(30000));
+        processor.updateDecayAnalysis();
+
+        return processor.getDecayAnalysis(0, 0);
+    };
+
+    SECTION("Empty slots have no analysis and no tail")
+    {
+        REQUIRE(analyse() == nullptr);
+        REQUIRE(processor.getTailLengthSeconds() == 0.0);
+    }
+
+    SECTION("A longer decay time gives a longer RT60 and tail")
+    {
+        processor.addModule(0, ModuleType::Reverb);
+        auto* decayTime = processor.apvts.getParameter("chain_0.slot_0.decayTime");
+
+        decayTime->setValueNotifyingHost(decayTime->convertTo0to1(0.5f));
+        const auto shorter = analyse();
+
+        REQUIRE(shorter != nullptr);
+        REQUIRE(shorter->broadband.rt60 > 0.0f);
+        REQUIRE(processor.getTailLengthSeconds() == Catch::Approx(shorter->tailSeconds));
+
+        decayTime->setValueNotifyingHost(decayTime->convertTo0to1(2.0f));
+        const auto longer = analyse();
+
+        REQUIRE(longer != nullptr);
+        REQUIRE(longer->broadband.rt60 > shorter->broadband.rt60);
+        REQUIRE(processor.getTailLengthSeconds() > shorter->tailSeconds);
+    }
+
+    SECTION("Slots in a chain add their tails")
+    {
+        processor.addModule(0, ModuleType::Reverb);
+        processor.addModule(0, ModuleType::Delay);
+        analyse();
+
+        const auto reverb = processor.getDecayAnalysis(0, 0);
+        const auto delay = processor.getDecayAnalysis(0, 1);
+
+        REQUIRE(reverb != nullptr);
+        REQUIRE(delay != nullptr);
+        REQUIRE(processor.getTailLengthSeconds()
+                == Catch::Approx(reverb->tailSeconds + delay->tailSeconds));
+    }
+}
+
+TEST_CASE("Delay Storage", "[plugin][memory]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the APVTS needs a message manager
+
+    ADSREchoAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, 48000.0, 256);
+    processor.prepareToPlay(48000.0, 256);
+    processor.setDelayStorage(DelayStorage::Float32);
+
+    processor.addModule(0, ModuleType::Reverb);
+    processor.addModule(0, ModuleType::Delay);
+
+    auto* decayTime = processor.apvts.getParameter("chain_0.slot_0.decayTime");
+    decayTime->setValueNotifyingHost(decayTime->convertTo0to1(3.0f));
+
+    auto bytesIn = [&processor](int slotIndex)
+    {
+        return processor.getRack().slots[0][slotIndex]->get()->getMemoryReport().totalBytes;
+    };
+
+    const auto reverbBytes = bytesIn(0);
+    const auto delayBytes = bytesIn(1);
+
+    SECTION("Switching rebuilds the rack with the same modules and settings")
+    {
+        processor.setDelayStorage(DelayStorage::Float16);
+
+        REQUIRE(processor.getDelayStorage() == DelayStorage::Float16);
+        REQUIRE(processor.getRack().slots[0][0]->get()->getType() == "Reverb");
+        REQUIRE(processor.getRack().slots[0][1]->get()->getType() == "Delay");
+        REQUIRE(decayTime->convertFrom0to1(decayTime->getValue()) == Catch::Approx(3.0f));
+
+        // The long lines take half the bytes; allpasses and states stay float
+        REQUIRE(bytesIn(0) < reverbBytes * 6 / 10);
+        REQUIRE(bytesIn(1) < delayBytes * 6 / 10);
+    }
+
+    SECTION("Modules added later use the current storage")
+    {
+        processor.setDelayStorage(DelayStorage::BFloat16);
+        processor.addModule(0, ModuleType::Delay);
+
+        REQUIRE(bytesIn(2) == bytesIn(1));
+        REQUIRE(bytesIn(2) < delayBytes * 6 / 10);
+    }
+}
+
+TEST_CASE("Tempo-Synced Delay", "[plugin][delay]")
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the APVTS needs a message manager
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+
+    ADSREchoAudioProcessor processor;
+
+    auto set = [&processor](const juce::String& suffix, float value)
+    {
+        auto* param = processor.apvts.getParameter("chain_0.slot_0." + suffix);
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+    };
+
+    // Fully wet single echoes
+    set("mix", 1.0f);
+    set("feedback", 0.0f);
+    set("delaySyncEnabled", 1.0f);
+
+    TransportState transport;
+    DelayModule module("chain_0.slot_0", processor.apvts);
+    module.setTransport(transport);
+    module.prepare({ sampleRate, (juce::uint32) blockSize, 2 });
+
+    // Sends an impulse and returns how many samples later it comes back;
+    // change() runs before block changeBlock, while the echo is on its way
+    auto echoDelay = [&module](int changeBlock = -1, std::function<void()> change = {})
+    {
+        juce::AudioBuffer<float> block(2, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int b = 0; b < 400; ++b)
+        {
+            block.clear();
+
+            if (b == 0)
+            {
+                block.setSample(0, 0, 1.0f);
+                block.setSample(1, 0, 1.0f);
+            }
+
+            if (b == changeBlock)
+                change();
+
+            module.process(block, midi);
+
+            for (int i = 0; i < blockSize; ++i)
+                if (std::abs(block.getSample(0, i)) > 0.5f)
+                    return b * blockSize + i;
+        }
+
+        return -1;
+    };
+
+    // Flushes the previous echo and lets any glide finish
+    auto settle = [&module]
+    {
+        juce::AudioBuffer<float> block(2, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int b = 0; b < 400; ++b)
+        {
+            block.clear();
+            module.process(block, midi);
+        }
+    };
+
+    SECTION("Synced times follow the host tempo and the note division")
+    {
+        transport.hasHostTempo = true;
+        transport.bpm = 120.0;
+        set("delayNoteDiv", 2.0f);   // 1/4: 500 ms
+        REQUIRE(echoDelay() == 24000);
+
+        settle();
+        transport.bpm = 150.0;
+        set("delayNoteDiv", 8.0f);   // 1/8 dotted: 300 ms
+        settle();
+        REQUIRE(echoDelay() == 14400);
+
+        // Without a host tempo the BPM parameter is used
+        settle();
+        transport.hasHostTempo = false;
+        set("delayBpm", 100.0f);
+        set("delayNoteDiv", 12.0f);  // 1/8 triplet: 200 ms
+        settle();
+        REQUIRE(echoDelay() == 9600);
+    }
+
+    SECTION("A tempo change glides, a manual time change jumps")
+    {
+        transport.hasHostTempo = true;
+        transport.bpm = 120.0;
+        set("delayNoteDiv", 2.0f);
+        REQUIRE(echoDelay() == 24000);
+
+        // 500 to 600 ms, starting 20000 samples in: caught halfway
+        settle();
+        const int gliding = echoDelay(78, [&transport] { transport.bpm = 100.0; });
+        REQUIRE(gliding > 24000);
+        REQUIRE(gliding < 28800);
+
+        // 200 to 300 ms, 5120 samples in: lands on the new time exactly
+        settle();
+        set("delaySyncEnabled", 0.0f);
+        set("delayTime", 200.0f);
+        settle();
+        REQUIRE(echoDelay(20, [&set] { set("delayTime", 300.0f); }) == 14400);
     }
 }
@@ -0,0 +1,257 @@
+#include "RealtimeSafety.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#if defined(__linux__) && defined(__GLIBC__)
+  #define ADSRECHO_INTERPOSE_LIBC 1
+  #include <dlfcn.h>
+  #include <errno.h>
+  #include <pthread.h>
+#else
+  #define ADSRECHO_INTERPOSE_LIBC 0
+ #if JUCE_WINDOWS
+  #include <malloc.h>
+ #endif
+#endif
+
+namespace RealtimeSafety
+{
+namespace
+{
+    thread_local int sectionDepth = 0;
+
+    // Set while a violation is being recorded: the backtrace and the
+    // bookkeeping below allocate and lock themselves
+    thread_local bool recording = false;
+
+    std::mutex& getViolationLock()
+    {
+        static std::mutex lock;
+        return lock;
+    }
+
+    std::vector<Violation>& getViolationList()
+    {
+        static std::vector<Violation> list;
+        return list;
+    }
+
+    void report(ViolationType type, const char* function)
+    {
+        if (sectionDepth == 0 || recording)
+            return;
+
+        recording = true;
+
+        {
+            Violation violation { type, function, juce::SystemStats::getStackBacktrace() };
+
+            const std::lock_guard<std::mutex> lock(getViolationLock());
+            getViolationList().push_back(std::move(violation));
+        }
+
+        recording = false;
+    }
+}
+
+ScopedRealtimeSection::ScopedRealtimeSection()  { ++sectionDepth; }
+ScopedRealtimeSection::~ScopedRealtimeSection() { --sectionDepth; }
+
+bool canDetectAllocations()
+{
+    return true;
+}
+
+bool canDetectMalloc()
+{
+    return ADSRECHO_INTERPOSE_LIBC != 0;
+}
+
+bool canDetectLocks()
+{
+    return ADSRECHO_INTERPOSE_LIBC != 0;
+}
+
+std::vector<Violation> getViolations()
+{
+    const juce::ScopedValueSetter<bool> svs(recording, true);
+    const std::lock_guard<std::mutex> lock(getViolationLock());
+    return getViolationList();
+}
+
+void clearViolations()
+{
+    const juce::ScopedValueSetter<bool> svs(recording, true);
+    const std::lock_guard<std::mutex> lock(getViolationLock());
+    getViolationList().clear();
+}
+
+juce::String describe(const std::vector<Violation>& violations)
+{
+    juce::String text;
+
+    for (const auto& v : violations)
+    {
+        const char* kind = v.type == ViolationType::Allocation   ? "allocation"
+                         : v.type == ViolationType::Deallocation ? "deallocation"
+                                                                 : "lock";
+
+        text << kind << " on the audio thread (" << v.function << ")\n" << v.stackTrace << "\n";
+    }
+
+    return text;
+}
+}
+
+using RealtimeSafety::ViolationType;
+
+#if ADSRECHO_INTERPOSE_LIBC
+//==============================================================================
+// glibc: the executable's definitions win over libc's, and the real
+// implementations stay reachable under their __libc_ names. operator new and
+// delete end up here too, so they need no replacement of their own.
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void  __libc_free(void*);
+
+    void* malloc(size_t size)
+    {
+        RealtimeSafety::report(ViolationType::Allocation, "malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        RealtimeSafety::report(ViolationType::Allocation, "calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        RealtimeSafety::report(ViolationType::Allocation, "realloc");
+        return __libc_realloc(ptr, size);
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        RealtimeSafety::report(ViolationType::Allocation, "memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        RealtimeSafety::report(ViolationType::Allocation, "aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size)
+    {
+        RealtimeSafety::report(ViolationType::Allocation, "posix_memalign");
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+
+    void free(void* ptr)
+    {
+        if (ptr != nullptr)
+            RealtimeSafety::report(ViolationType::Deallocation, "free");
+
+        __libc_free(ptr);
+    }
+
+    // Resolved on first use without a function-local static, whose guard
+    // would itself lock
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        using LockFn = int (*)(pthread_mutex_t*);
+        static std::atomic<LockFn> realLock { nullptr };
+
+        auto fn = realLock.load(std::memory_order_acquire);
+
+        if (fn == nullptr)
+        {
+            fn = reinterpret_cast<LockFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            realLock.store(fn, std::memory_order_release);
+        }
+
+        RealtimeSafety::report(ViolationType::Lock, "pthread_mutex_lock");
+        return fn(mutex);
+    }
+}
+
+#else
+//==============================================================================
+// Elsewhere only the C++ allocator is replaced (no lock detection)
+
+void* operator new(std::size_t size)
+{
+    RealtimeSafety::report(ViolationType::Allocation, "operator new");
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    RealtimeSafety::report(ViolationType::Allocation, "operator new");
+
+   #if JUCE_WINDOWS
+    auto* ptr = _aligned_malloc(size == 0 ? 1 : size, (std::size_t) alignment);
+   #else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, juce::jmax((std::size_t) alignment, sizeof(void*)), size == 0 ? 1 : size) != 0)
+        ptr = nullptr;
+   #endif
+
+    if (ptr != nullptr)
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+        RealtimeSafety::report(ViolationType::Deallocation, "operator delete");
+
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept                      { operator delete(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept           { operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept         { operator delete(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    if (ptr != nullptr)
+        RealtimeSafety::report(ViolationType::Deallocation, "operator delete");
+
+   #if JUCE_WINDOWS
+    _aligned_free(ptr);
+   #else
+    std::free(ptr);
+   #endif
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept              { operator delete(ptr, alignment); }
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept   { operator delete(ptr, alignment); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept { operator delete(ptr, alignment); }
+#endif
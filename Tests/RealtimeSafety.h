@@ -0,0 +1,50 @@
+// RealtimeSafety.h - Allocation and lock detection for audio-thread code
+//
+// Test builds only. Linking RealtimeSafety.cpp replaces the allocator entry
+// points (malloc/free and friends on glibc, operator new/delete elsewhere)
+// and, on Linux, pthread_mutex_lock. Calls made on a thread while it is
+// inside a ScopedRealtimeSection are recorded with their call stack; calls
+// anywhere else go straight through.
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace RealtimeSafety
+{
+    enum class ViolationType
+    {
+        Allocation,
+        Deallocation,
+        Lock
+    };
+
+    struct Violation
+    {
+        ViolationType type;
+        juce::String function;     // e.g. "malloc", "pthread_mutex_lock"
+        juce::String stackTrace;
+    };
+
+    // Marks the calling thread as an audio thread for the scope's lifetime
+    class ScopedRealtimeSection
+    {
+    public:
+        ScopedRealtimeSection();
+        ~ScopedRealtimeSection();
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+    };
+
+    // What this platform's interposition can see: operator new/delete
+    // everywhere, malloc/free and locks only where libc is interposed
+    bool canDetectAllocations();
+    bool canDetectMalloc();
+    bool canDetectLocks();
+
+    std::vector<Violation> getViolations();
+    void clearViolations();
+
+    // One paragraph per violation, for test failure messages
+    juce::String describe(const std::vector<Violation>& violations);
+}
@@ -0,0 +1,251 @@
+#include <catch2/catch_test_macros.hpp>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include "RealtimeSafety.h"
+
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+
+    // Keeps an allocation made inside a section alive past it, so the
+    // compiler cannot elide the pair
+    void* volatile allocationSink = nullptr;
+
+    struct Harness
+    {
+        Harness()
+        {
+            processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+        }
+
+        // One block of noise through processBlock inside a real-time section;
+        // fails with the offending call stacks
+        void processChecked()
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+            RealtimeSafety::clearViolations();
+
+            {
+                RealtimeSafety::ScopedRealtimeSection section;
+                processor.processBlock(buffer, midi);
+            }
+
+            const auto violations = RealtimeSafety::getViolations();
+            INFO(RealtimeSafety::describe(violations).toStdString());
+            REQUIRE(violations.empty());
+        }
+
+        // Keeps processing while the loader thread installs IRs, so the
+        // hand-over and crossfade run under the checker too
+        void processUntilLoaded()
+        {
+            for (int i = 0; i < 2000 && processor.isLoadingIRs(); ++i)
+            {
+                processChecked();
+                juce::Thread::sleep(1);
+            }
+
+            REQUIRE_FALSE(processor.isLoadingIRs());
+            processChecked();
+        }
+
+        // Host-style automation: every parameter moves between blocks
+        void automateAll()
+        {
+            for (auto* param : processor.getParameters())
+                if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param))
+                    ranged->setValueNotifyingHost(random.nextFloat());
+        }
+
+        juce::ScopedJuceInitialiser_GUI juceInit;   // the APVTS needs a message manager
+        ADSREchoAudioProcessor processor;
+        juce::AudioBuffer<float> buffer { 2, blockSize };
+        juce::MidiBuffer midi;
+        juce::Random random { 1234 };
+    };
+}
+
+TEST_CASE("Real-time checker sees violations", "[realtime]")
+{
+    RealtimeSafety::clearViolations();
+
+    // operator new is replaced on every platform
+    {
+        RealtimeSafety::ScopedRealtimeSection section;
+        allocationSink = new char[64];
+    }
+
+    delete[] static_cast<char*>(allocationSink);
+
+    auto violations = RealtimeSafety::getViolations();
+    REQUIRE_FALSE(violations.empty());
+    REQUIRE(violations.front().type == RealtimeSafety::ViolationType::Allocation);
+    REQUIRE(violations.front().stackTrace.isNotEmpty());
+
+    if (RealtimeSafety::canDetectMalloc())
+    {
+        RealtimeSafety::clearViolations();
+
+        {
+            RealtimeSafety::ScopedRealtimeSection section;
+            allocationSink = std::malloc(64);
+        }
+
+        std::free(allocationSink);
+
+        violations = RealtimeSafety::getViolations();
+        REQUIRE(violations.size() == 1);
+        REQUIRE(violations.front().type == RealtimeSafety::ViolationType::Allocation);
+        REQUIRE(violations.front().function == "malloc");
+    }
+
+    if (RealtimeSafety::canDetectLocks())
+    {
+        std::mutex mutex;
+        RealtimeSafety::clearViolations();
+
+        {
+            RealtimeSafety::ScopedRealtimeSection section;
+            const std::lock_guard<std::mutex> lock(mutex);
+        }
+
+        violations = RealtimeSafety::getViolations();
+        REQUIRE(violations.size() == 1);
+        REQUIRE(violations.front().type == RealtimeSafety::ViolationType::Lock);
+    }
+
+    RealtimeSafety::clearViolations();
+}
+
+TEST_CASE("Audio thread stays allocation and lock free", "[realtime][plugin]")
+{
+    Harness rack;
+    auto& processor = rack.processor;
+
+    processor.addModule(0, ModuleType::Delay);
+    processor.addModule(0, ModuleType::Reverb);
+    processor.addModule(1, ModuleType::MultiTap);
+    processor.addModule(1, ModuleType::Convolution);
+    rack.processUntilLoaded();
+
+    SECTION("Parameter automation")
+    {
+        for (int block = 0; block < 64; ++block)
+        {
+            rack.automateAll();
+            rack.processChecked();
+        }
+
+        // IR index changes from automation land on the loader thread
+        rack.processUntilLoaded();
+    }
+
+    SECTION("Module swaps")
+    {
+        processor.changeModuleType(0, 0, ModuleType::Convolution);
+        rack.processChecked();
+
+        processor.changeModuleType(0, 1, ModuleType::MultiTap);
+        rack.processChecked();
+
+        processor.requestSlotMove(1, 0, 1);
+        rack.processChecked();
+
+        processor.removeModule(0, 1);
+        rack.processChecked();
+
+        processor.addModule(0, ModuleType::Delay);
+        rack.processChecked();
+
+        rack.processUntilLoaded();
+    }
+
+    SECTION("Level meters and spectrum")
+    {
+        auto& meters = processor.getLevelMeters();
+        meters.addViewer();
+        meters.addSpectrumViewer();
+
+        for (int block = 0; block < 16; ++block)
+            rack.processChecked();
+
+        meters.removeSpectrumViewer();
+        meters.removeViewer();
+    }
+
+    SECTION("IR changes")
+    {
+        const juce::File irDir(ADSRECHO_IR_DIR);
+        const auto irFiles = irDir.findChildFiles(juce::File::findFiles, false, "*.wav");
+        REQUIRE(irFiles.size() >= 2);
+
+        processor.loadCustomIR(1, 1, irFiles[0]);
+        rack.processUntilLoaded();
+
+        processor.loadCustomIR(1, 1, irFiles[1]);
+        rack.processUntilLoaded();
+
+        // Back to a bundled IR, mid-stream
+        if (auto* irIndex = processor.apvts.getParameter("chain_1.slot_1.convIrIndex"))
+            irIndex->setValueNotifyingHost(0.5f);
+
+        rack.processUntilLoaded();
+    }
+
+    SECTION("State restore during playback")
+    {
+        juce::MemoryBlock before;
+        processor.getStateInformation(before);
+
+        processor.changeModuleType(0, 0, ModuleType::MultiTap);
+        processor.removeModule(1, 1);
+        rack.processChecked();
+
+        juce::MemoryBlock after;
+        processor.getStateInformation(after);
+
+        // The host's audio thread keeps calling processBlock while the
+        // message thread swaps whole racks under it
+        std::atomic<bool> stop { false };
+        RealtimeSafety::clearViolations();
+
+        std::thread audioThread([&]
+        {
+            juce::AudioBuffer<float> block(2, blockSize);
+            juce::MidiBuffer midi;
+
+            while (!stop.load())
+            {
+                block.clear();
+
+                RealtimeSafety::ScopedRealtimeSection section;
+                processor.processBlock(block, midi);
+            }
+        });
+
+        for (int i = 0; i < 20; ++i)
+        {
+            const auto& state = (i % 2 == 0) ? before : after;
+            processor.setStateInformation(state.getData(), (int) state.getSize());
+            juce::Thread::sleep(2);
+        }
+
+        stop.store(true);
+        audioThread.join();
+
+        const auto violations = RealtimeSafety::getViolations();
+        INFO(RealtimeSafety::describe(violations).toStdString());
+        REQUIRE(violations.empty());
+
+        REQUIRE(processor.getSlotInfo(0, 0).moduleType == "Multi-Tap");
+        REQUIRE(processor.slotIsEmpty(1, 1));
+    }
+}
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    RenderSubjects.h
+    The algorithms and the full processor behind one interface, with fixed
+    settings and a parameter trajectory, for code that renders or times them
+    offline: the golden render tests and ADSREchoBenchmarks.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../Source/PluginProcessor.h"
+#include "../Source/Reverb Algorithms/Reverb/DatorroHall.h"
+#include "../Source/Reverb Algorithms/Reverb/HybridPlate.h"
+#include "../Source/Reverb Algorithms/Delay/BasicDelay.h"
+#include "../Source/Reverb Algorithms/Convolution/Convolution.h"
+
+//==============================================================================
+// Anything that can be prepared and fed blocks. setAt() applies the
+// subject's parameter trajectory at position t (0 to 1) through a render;
+// prepare() starts it at 0.
+struct Subject
+{
+    virtual ~Subject() = default;
+
+    virtual void prepare(const juce::dsp::ProcessSpec& spec) = 0;
+    virtual void process(juce::AudioBuffer<float>& buffer) = 0;
+    virtual void setAt(double /*t*/) {}
+
+    // IR loads, requested once after the first prepare
+    virtual void startLoads() {}
+
+    // Background set-up still running (IR loads); fed silence until it is done
+    virtual bool isBusy() const { return false; }
+};
+
+//==============================================================================
+template <typename ReverbType>
+struct ReverbSubject : Subject
+{
+    explicit ReverbSubject(DelayStorage s = DelayStorage::Float32) : storage(s) {}
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        reverb.setDelayStorage(storage);
+        reverb.prepare(spec);
+        setAt(0.0);
+    }
+
+    // Room grows and the damping closes over the render
+    void setAt(double t) override
+    {
+        ReverbProcessorParameters params;
+        params.mix = 1.0f;
+        params.roomSize = (float) juce::jmap(t, 0.3, 0.8);
+        params.decayTime = 0.6f;
+        params.damping = (float) juce::jmap(t, 16000.0, 4000.0);
+        params.modRate = 0.8f;
+        params.modDepth = 0.5f;
+        params.preDelay = 10.0f;
+
+        reverb.setParameters(params);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        reverb.processBlock(buffer, midi);
+    }
+
+    DelayStorage storage;
+    ReverbType reverb;
+    juce::MidiBuffer midi;
+};
+
+struct BasicDelaySubject : Subject
+{
+    explicit BasicDelaySubject(BasicDelay::DelayMode m, DelayStorage s = DelayStorage::Float32)
+        : mode(m), storage(s) {}
+
+    // Set before prepare so the first blocks do not glide
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        delay.setDelayStorage(storage);
+        delay.setMode(mode);
+        delay.setFeedback(0.5f);
+        delay.setMix(0.5f);
+        delay.setLowpassFreq(9000.0f);
+        delay.setWow(0.3f);
+        delay.setFlutter(0.2f);
+        setAt(0.0);
+        delay.prepare(spec);
+    }
+
+    // Delay time glides to a new value halfway through, as on a tempo change
+    void setAt(double t) override
+    {
+        delay.glideToDelayTime(t < 0.5 ? 250.0f : 180.0f);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        delay.processBlock(buffer);
+    }
+
+    BasicDelay::DelayMode mode;
+    DelayStorage storage;
+    BasicDelay delay;
+};
+
+struct ConvolutionSubject : Subject
+{
+    explicit ConvolutionSubject(const juce::File& file) : irFile(file) {}
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        convolution.prepare(spec);
+        setAt(0.0);
+    }
+
+    void startLoads() override
+    {
+        convolution.loadIR(irFile);
+    }
+
+    // Mix and IR gain move; the tone stays fixed, since tone changes are
+    // baked into the IR on the loader thread and would land at a
+    // timing-dependent block
+    void setAt(double t) override
+    {
+        ConvolutionParameters params;
+        params.mix = (float) juce::jmap(t, 0.9, 0.5);
+        params.preDelay = 5.0f;
+        params.irGainDb = (float) juce::jmap(t, 0.0, -6.0);
+        params.lowCutHz = 120.0f;
+        params.highCutHz = 10000.0f;
+        params.tiltDb = -2.0f;
+
+        convolution.setParameters(params);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        convolution.processBlock(buffer, midi);
+    }
+
+    bool isBusy() const override { return convolution.isLoadPending(); }
+
+    juce::File irFile;
+    Convolution convolution;
+    juce::MidiBuffer midi;
+};
+
+//==============================================================================
+// The whole processor with two parallel chains: Delay -> Reverb and
+// Multi-Tap -> Convolution, the convolution running a custom IR
+struct RackSubject : Subject
+{
+    explicit RackSubject(const juce::File& ir) : irFile(ir)
+    {
+        processor.addModule(0, ModuleType::Delay);
+        processor.addModule(0, ModuleType::Reverb);
+        processor.addModule(1, ModuleType::MultiTap);
+        processor.addModule(1, ModuleType::Convolution);
+
+        set("parallelEnabled", 1.0f);
+        set("chain_0.slot_0.delayTime", 300.0f);
+        set("chain_0.slot_0.feedback", 0.4f);
+        set("chain_0.slot_1.mix", 0.5f);
+        set("chain_1.slot_1.mix", 0.6f);
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec) override
+    {
+        processor.setPlayConfigDetails((int) spec.numChannels, (int) spec.numChannels,
+                                       spec.sampleRate, (int) spec.maximumBlockSize);
+        processor.prepareToPlay(spec.sampleRate, (int) spec.maximumBlockSize);
+    }
+
+    void startLoads() override
+    {
+        processor.loadCustomIR(1, 1, irFile);
+    }
+
+    // Convolution tone stays fixed for the same reason as above
+    void setAt(double t) override
+    {
+        set("chain_0.slot_1.roomSize", (float) juce::jmap(t, 0.4, 0.7));
+        set("chain_0.masterMix", (float) juce::jmap(t, 0.8, 0.5));
+        set("chain_1.slot_1.convIrGain", (float) juce::jmap(t, 0.0, -6.0));
+    }
+
+    void process(juce::AudioBuffer<float>& buffer) override
+    {
+        processor.processBlock(buffer, midi);
+    }
+
+    bool isBusy() const override { return processor.isLoadingIRs(); }
+
+    void set(const juce::String& id, float value)
+    {
+        if (auto* param = processor.apvts.getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the APVTS needs a message manager
+    juce::File irFile;
+    ADSREchoAudioProcessor processor;
+    juce::MidiBuffer midi;
+};
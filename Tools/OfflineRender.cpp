@@ -0,0 +1,433 @@
+/*
+  ==============================================================================
+
+    OfflineRender.cpp
+    Renders audio files through a saved rack preset without a host. Each
+    worker thread owns one ADSREchoAudioProcessor and pulls files from a
+    shared queue; the reverb/delay tail is rendered after the input ends.
+
+    ADSREchoRender --state=<preset> [--block-size=<n>] [--jobs=<n>]
+                   [--output-dir=<folder>] [--format=wav|flac]
+                   [--max-tail=<s>] [--storage=float32|fp16|bf16]
+                   <file or folder>...
+    ADSREchoRender --state=<preset> --memory [--sample-rate=<hz>]
+                   [--storage=float32|fp16|bf16]
+
+    The preset is a getStateInformation() blob, or the same state as XML.
+    <name>.wav renders to <name>_render.wav, next to the input or in
+    --output-dir; inputs with the same name from different folders get their
+    folder's name in front there. Folders are scanned for audio files other
+    than the _render files written by earlier runs.
+    --memory prints what each slot's delay lines and states take once
+    prepared, instead of rendering. --storage picks the sample format of the
+    long delay and reverb lines, so renders can be compared.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+
+#include <iostream>
+
+namespace
+{
+//==============================================================================
+struct Options
+{
+    juce::MemoryBlock state;
+    int blockSize = 512;
+    int numJobs = 1;
+    juce::File outputDir;        // empty: next to each input
+    juce::String format;         // empty: same as the input
+    double maxTailSeconds = 30.0;
+    DelayStorage storage = DelayStorage::Float32;
+};
+
+// The tail ends once the output has stayed below this for holdSeconds
+constexpr float tailThreshold = 3.0e-5f;    // about -90 dBFS
+constexpr double tailHoldSeconds = 0.5;
+
+juce::CriticalSection outputLock;
+
+void report(const juce::String& line)
+{
+    const juce::ScopedLock sl(outputLock);
+    std::cout << line << std::endl;
+}
+
+void reportError(const juce::String& line)
+{
+    const juce::ScopedLock sl(outputLock);
+    std::cerr << line << std::endl;
+}
+
+//==============================================================================
+// Reads a preset as saved by getStateInformation, or as plain XML
+bool loadState(const juce::File& file, juce::MemoryBlock& state)
+{
+    if (!file.loadFileAsData(state) || state.isEmpty())
+        return false;
+
+    if (static_cast<const char*>(state.getData())[0] == '<')
+    {
+        auto xml = juce::parseXML(file);
+
+        if (xml == nullptr)
+            return false;
+
+        state.reset();
+        juce::AudioProcessor::copyXmlToBinary(*xml, state);
+    }
+
+    return true;
+}
+
+// An input file and the file its render is written to
+struct Job
+{
+    juce::File input;
+    juce::File output;
+};
+
+const juce::String renderSuffix = "_render";
+
+// Files named on the command line are always rendered; folders leave out
+// the renders this tool wrote there before
+juce::Array<juce::File> collectInputs(const juce::ArgumentList& args)
+{
+    juce::Array<juce::File> inputs;
+
+    for (const auto& arg : args.arguments)
+    {
+        if (arg.isOption())
+            continue;
+
+        const auto file = arg.resolveAsFile();
+
+        if (file.isDirectory())
+        {
+            for (const auto& child : file.findChildFiles(juce::File::findFiles, false, "*.wav;*.flac;*.aif;*.aiff"))
+                if (!child.getFileNameWithoutExtension().endsWith(renderSuffix))
+                    inputs.add(child);
+        }
+        else
+        {
+            inputs.add(file);
+        }
+    }
+
+    return inputs;
+}
+
+// Output names are settled here, before any worker starts, so no two jobs
+// write the same file: a name already taken gets the input's folder name in
+// front, then a number
+juce::Array<Job> planJobs(const juce::Array<juce::File>& inputs, const Options& options)
+{
+    juce::Array<Job> jobs;
+    juce::Array<juce::File> taken;
+
+    for (const auto& input : inputs)
+    {
+        const auto dir = options.outputDir == juce::File() ? input.getParentDirectory() : options.outputDir;
+        const auto extension = options.format.isNotEmpty() ? "." + options.format
+                                                           : input.getFileExtension().toLowerCase();
+        const auto name = input.getFileNameWithoutExtension() + renderSuffix;
+        const auto folderName = input.getParentDirectory().getFileName() + "_" + name;
+
+        auto output = dir.getChildFile(name + extension);
+
+        if (taken.contains(output))
+            output = dir.getChildFile(folderName + extension);
+
+        for (int n = 2; taken.contains(output); ++n)
+            output = dir.getChildFile(folderName + "_" + juce::String(n) + extension);
+
+        taken.add(output);
+        jobs.add({ input, output });
+    }
+
+    return jobs;
+}
+
+//==============================================================================
+// One processor, reused for every file this worker picks up
+class RenderWorker : public juce::Thread
+{
+public:
+    RenderWorker(int index, const Options& opts, const juce::Array<Job>& allJobs,
+                 std::atomic<int>& next, std::atomic<int>& failures, std::atomic<int>& running)
+        : juce::Thread("Render worker " + juce::String(index)),
+          options(opts), jobs(allJobs), nextJob(next), numFailures(failures), numRunning(running)
+    {
+        formats.registerBasicFormats();
+
+        // The APVTS is built and restored here, on the message thread
+        processor.setDelayStorage(options.storage);
+        processor.setStateInformation(options.state.getData(), (int) options.state.getSize());
+        processor.setNonRealtime(true);
+    }
+
+    void run() override
+    {
+        for (int i = nextJob++; i < jobs.size() && !threadShouldExit(); i = nextJob++)
+        {
+            if (!render(jobs.getReference(i)))
+                ++numFailures;
+        }
+
+        // The last worker out ends the message loop main() runs meanwhile
+        if (--numRunning == 0)
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+    }
+
+private:
+    bool render(const Job& job)
+    {
+        const auto& input = job.input;
+        const auto& outputFile = job.output;
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+
+        if (reader == nullptr)
+        {
+            reportError("Cannot read " + input.getFullPathName());
+            return false;
+        }
+
+        const int numChannels = (int) reader->numChannels;
+        const double sampleRate = reader->sampleRate;
+        const int blockSize = options.blockSize;
+
+        if (numChannels < 1 || numChannels > 2)
+        {
+            reportError(input.getFileName() + ": only mono and stereo files are supported");
+            return false;
+        }
+
+        // Writer: requested format, or the input's own
+        const auto extension = outputFile.getFileExtension();
+        auto* format = formats.findFormatForFileExtension(extension);
+
+        if (format == nullptr)
+        {
+            reportError(input.getFileName() + ": no writer for " + extension);
+            return false;
+        }
+
+        outputFile.deleteFile();
+
+        auto stream = outputFile.createOutputStream();
+        const auto depths = format->getPossibleBitDepths();
+        const int bitDepth = depths.contains((int) reader->bitsPerSample) ? (int) reader->bitsPerSample
+                                                                          : depths.getLast();
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            stream != nullptr ? format->createWriterFor(stream.get(), sampleRate, (unsigned int) numChannels,
+                                                        bitDepth, {}, 0)
+                              : nullptr);
+
+        if (writer == nullptr)
+        {
+            reportError("Cannot write " + outputFile.getFullPathName());
+            return false;
+        }
+
+        stream.release();   // owned by the writer now
+
+        // Fresh state for every file
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        // Modules request their IRs on their first block and the loads run
+        // in the background; feed silence until they are in
+        do
+        {
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+            juce::Thread::sleep(1);
+        }
+        while (processor.isLoadingIRs() && !threadShouldExit());
+
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        // Input
+        const auto length = reader->lengthInSamples;
+
+        for (juce::int64 pos = 0; pos < length; pos += blockSize)
+        {
+            const int n = (int) juce::jmin((juce::int64) blockSize, length - pos);
+
+            buffer.setSize(numChannels, n, false, false, true);
+            reader->read(&buffer, 0, n, pos, true, numChannels > 1);
+            processor.processBlock(buffer, midi);
+            writer->writeFromAudioSampleBuffer(buffer, 0, n);
+        }
+
+        // Tail: at least what the processor reports, then until it has
+        // stayed quiet for tailHoldSeconds
+        const auto minTail = (juce::int64) (processor.getTailLengthSeconds() * sampleRate);
+        const auto maxTail = juce::jmax(minTail, (juce::int64) (options.maxTailSeconds * sampleRate));
+        const auto hold = (juce::int64) (tailHoldSeconds * sampleRate);
+
+        juce::int64 tail = 0;
+        juce::int64 quiet = 0;
+
+        buffer.setSize(numChannels, blockSize, false, false, true);
+
+        while (tail < maxTail && (tail < minTail || quiet < hold))
+        {
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+            writer->writeFromAudioSampleBuffer(buffer, 0, blockSize);
+
+            tail += blockSize;
+            quiet = buffer.getMagnitude(0, blockSize) < tailThreshold ? quiet + blockSize : 0;
+        }
+
+        writer.reset();
+
+        const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        const double rendered = (double) (length + tail) / sampleRate;
+
+        report(input.getFileName() + " -> " + outputFile.getFullPathName()
+               + "  (" + juce::String(rendered, 2) + " s incl. " + juce::String((double) tail / sampleRate, 2)
+               + " s tail, " + juce::String(rendered / juce::jmax(elapsed, 1.0e-9), 1) + "x realtime)");
+
+        return true;
+    }
+
+    const Options& options;
+    const juce::Array<Job>& jobs;
+    std::atomic<int>& nextJob;
+    std::atomic<int>& numFailures;
+    std::atomic<int>& numRunning;
+
+    juce::AudioFormatManager formats;
+    ADSREchoAudioProcessor processor;
+};
+
+void printUsage()
+{
+    std::cerr << "Usage: ADSREchoRender --state=<preset> [--block-size=<n>] [--jobs=<n>]\n"
+                 "                      [--output-dir=<folder>] [--format=wav|flac]\n"
+                 "                      [--max-tail=<s>] [--storage=float32|fp16|bf16]\n"
+                 "                      <file or folder>...\n"
+                 "       ADSREchoRender --state=<preset> --memory [--sample-rate=<hz>]\n"
+                 "                      [--storage=float32|fp16|bf16]" << std::endl;
+}
+
+int printMemoryReport(const Options& options, double sampleRate)
+{
+    ADSREchoAudioProcessor processor;
+    processor.setDelayStorage(options.storage);
+    processor.setStateInformation(options.state.getData(), (int) options.state.getSize());
+    processor.setPlayConfigDetails(2, 2, sampleRate, options.blockSize);
+    processor.prepareToPlay(sampleRate, options.blockSize);
+
+    std::cout << processor.getMemoryReport() << std::endl;
+
+    processor.releaseResources();
+    return 0;
+}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;   // the processor's APVTS needs a message manager
+    juce::ArgumentList args(argc, argv);
+
+    Options options;
+
+    if (!args.containsOption("--state") || !loadState(args.getFileForOption("--state"), options.state))
+    {
+        std::cerr << "A readable --state preset is required" << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    if (args.containsOption("--block-size"))
+        options.blockSize = juce::jlimit(16, 8192, args.getValueForOption("--block-size").getIntValue());
+
+    options.numJobs = juce::SystemStats::getNumCpus();
+
+    if (args.containsOption("--jobs"))
+        options.numJobs = juce::jmax(1, args.getValueForOption("--jobs").getIntValue());
+
+    if (args.containsOption("--output-dir"))
+    {
+        options.outputDir = args.getFileForOption("--output-dir");
+
+        if (!options.outputDir.createDirectory())
+        {
+            std::cerr << "Cannot create " << options.outputDir.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    if (args.containsOption("--format"))
+        options.format = args.getValueForOption("--format").toLowerCase();
+
+    if (args.containsOption("--max-tail"))
+        options.maxTailSeconds = juce::jmax(0.0, args.getValueForOption("--max-tail").getDoubleValue());
+
+    if (args.containsOption("--storage") && !parseDelayStorage(args.getValueForOption("--storage"), options.storage))
+    {
+        std::cerr << "Unknown --storage " << args.getValueForOption("--storage") << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    if (args.containsOption("--memory"))
+    {
+        const double sampleRate = args.containsOption("--sample-rate")
+                                      ? juce::jlimit(8000.0, 384000.0, args.getValueForOption("--sample-rate").getDoubleValue())
+                                      : 48000.0;
+
+        return printMemoryReport(options, sampleRate);
+    }
+
+    const auto jobs = planJobs(collectInputs(args), options);
+
+    if (jobs.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    const int numWorkers = juce::jmin(options.numJobs, jobs.size());
+
+    std::atomic<int> nextJob { 0 };
+    std::atomic<int> numFailures { 0 };
+    std::atomic<int> numRunning { numWorkers };
+
+    juce::OwnedArray<RenderWorker> workers;
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add(new RenderWorker(i, options, jobs, nextJob, numFailures, numRunning));
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    for (auto* worker : workers)
+        worker->startThread();
+
+    // The processors' timers run here, on the message thread: they swap in
+    // morphed racks and free the ones replaced, so the loop has to run until
+    // the last worker stops it
+    juce::MessageManager::getInstance()->runDispatchLoop();
+
+    for (auto* worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    report(juce::String(jobs.size() - numFailures.load()) + "/" + juce::String(jobs.size())
+           + " files rendered in " + juce::String(elapsed, 2) + " s on " + juce::String(workers.size())
+           + " workers");
+
+    return numFailures.load() == 0 ? 0 : 1;
+}